@@ -1,6 +1,13 @@
 import serial
 import struct
 
+# Native MSP codec registered by DroneApp (C++). Missing when the script
+# runs under a plain Python interpreter, so keep the pure-Python path as fallback.
+try:
+    import msp_native
+except ImportError:
+    msp_native = None
+
 # --- CONFIGURATION ---
 SERIAL_PORT = 'COM5'      # The active COM port for your Flight Controller
 BAUD_RATE = 115200        # Standard baud rate for Betaflight/iNav USB connections
@@ -10,6 +17,12 @@ MSP_ATTITUDE = 108        # MSP command ID requesting roll, pitch, and yaw
 # from constantly opening and closing the COM port every frame.
 _ser = None
 
+# Bytes received but not yet parsed (native path only)
+_rx = bytearray()
+
+# Prebuilt request frame: $M< + size 0 + MSP_ATTITUDE + checksum
+_ATTITUDE_REQUEST = msp_native.encode(MSP_ATTITUDE) if msp_native else b'$M<\x00l\x6c'
+
 def init_serial():
     """
     Initializes the serial port connection. 
@@ -29,10 +42,15 @@ def get_drone_attitude():
     """
     Constructs an MSP packet, sends it to the flight controller, 
     reads the response, and formats it into a dictionary for C++.
+    Returns None when no attitude arrived, so C++ skips the poll instead of
+    drawing the drone level.
     """
     # Auto-reconnect logic
     if _ser is None or not _ser.is_open:
         init_serial()
+
+    if msp_native is not None:
+        return _get_drone_attitude_native()
     
     # --- 1. SEND MSP REQUEST ---
     # Packet Structure: Header ($M<) + Payload Size (0) + Command ID (108) + Checksum (108)
@@ -64,5 +82,27 @@ def get_drone_attitude():
                 "yaw": float(yaw)
             }
             
-    # If the packet was invalid, incomplete, or the port disconnected, return safe zero values
-    return {"roll": 0.0, "pitch": 0.0, "yaw": 0.0}
\ No newline at end of file
+    # If the packet was invalid, incomplete, or the port disconnected, there is no sample
+    return None
+
+
+def _get_drone_attitude_native():
+    """
+    Same request/response as get_drone_attitude(), but reads whole buffers and
+    lets the C++ msp_native module find and decode every frame in one call.
+    """
+    _ser.write(_ATTITUDE_REQUEST)
+
+    # One attitude reply is 12 bytes; grab it plus anything else already waiting
+    _rx.extend(_ser.read(12))
+    _rx.extend(_ser.read_all() or b'')
+
+    values, consumed = msp_native.attitude_array(_rx)
+    del _rx[:consumed]
+
+    if len(values) >= 3:
+        # Newest reply wins: [roll, pitch, yaw] already scaled to degrees
+        return {"roll": values[-3], "pitch": values[-2], "yaw": values[-1]}
+
+    # No complete reply yet (the rest stays in _rx): no sample this poll
+    return None
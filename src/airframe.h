@@ -0,0 +1,247 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include "math3d.h"
+#include "mesh.h"
+
+/**
+ * @brief The built-in airframes: frame layouts, and their geometry generated by the compiler.
+ *
+ * A frame type is a descriptor (airframe_spec): where the arms point and
+ * whether each carries one motor or a coaxial pair. Airframe<type> turns it
+ * into fixed-size vertex, edge and face tables (StaticMesh) while compiling,
+ * so the program starts with the geometry already in its read-only data and
+ * drawing a frame is only the per-frame transform. A descriptor that does
+ * not make a frame, or tables that do not add up, fail the build instead of
+ * drawing garbage.
+ *
+ * Motor rings are not in the tables: they are drawn with
+ * RenderEngine::draw_circle, whose unit-circle tables are compile-time too,
+ * so their segment count can follow their size on screen.
+ *
+ * Model space: x right, y up, z towards the nose.
+ */
+enum class FrameType {
+    QuadX,    // The original: four arms in a stretched X
+    QuadPlus, // Four arms, one pointing at the nose
+    Hex,      // Six arms, X orientation (no arm on the nose)
+    Octo,     // Eight arms, X orientation
+    X8,       // Quad X with a coaxial motor pair on each arm
+};
+
+constexpr FrameType FRAME_TYPES[] = {FrameType::QuadX, FrameType::QuadPlus, FrameType::Hex, FrameType::Octo, FrameType::X8};
+
+// Layout of a frame type
+struct AirframeSpec {
+    static constexpr int MAX_ARMS = 8;
+
+    const char* name = nullptr; // --frame argument
+    int arms = 0;
+    double arm_degrees[MAX_ARMS] = {}; // Arm directions, clockwise from the nose seen from above
+    bool coaxial = false;              // One motor above and one below each arm end
+};
+
+constexpr AirframeSpec airframe_spec(FrameType type) {
+    auto even = [](const char* name, int arms, double first_degrees, bool coaxial) {
+        AirframeSpec spec{name, arms, {}, coaxial};
+        for (int i = 0; i < arms; i++) spec.arm_degrees[i] = first_degrees + 360.0 * i / arms;
+        return spec;
+    };
+
+    switch (type) {
+    case FrameType::QuadX: return AirframeSpec{"quad-x", 4, {55.0, 125.0, 235.0, 305.0}, false};
+    case FrameType::QuadPlus: return even("quad-plus", 4, 0.0, false);
+    case FrameType::Hex: return even("hex", 6, 30.0, false);
+    case FrameType::Octo: return even("octo", 8, 22.5, false);
+    case FrameType::X8: return AirframeSpec{"x8", 4, {55.0, 125.0, 235.0, 305.0}, true};
+    }
+    return {}; // No arms: Airframe<> rejects it
+}
+
+// --frame name to type; false if there is no such frame
+inline bool frame_type_from_name(std::string_view name, FrameType& type) {
+    for (FrameType t : FRAME_TYPES) {
+        if (name == airframe_spec(t).name) {
+            type = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Vertex, edge and face tables of a size fixed at compile time, filled by constexpr code.
+ *
+ * Used like Mesh while it is being built (add_vertex and friends; writing
+ * past a table is a compile error in a constant expression), then read
+ * through a MeshView.
+ */
+template <size_t V, size_t E, size_t F>
+struct StaticMesh {
+    std::array<RenderEngine::Point_3D, V> vertices{};
+    std::array<RenderEngine::Edge, E> edges{};
+    std::array<Mesh::Face, F> faces{};
+    size_t vertex_count = 0;
+    size_t edge_count = 0;
+    size_t face_count = 0;
+
+    constexpr int add_vertex(const RenderEngine::Point_3D& p) {
+        vertices[vertex_count] = p;
+        return static_cast<int>(vertex_count++);
+    }
+
+    constexpr void add_edge(int start, int end) { edges[edge_count++] = {start, end}; }
+
+    constexpr void add_face(int a, int b, int c) { faces[face_count++] = {a, b, c}; }
+
+    // Two triangles; a b c d in order around the quad, wound like a face
+    constexpr void add_quad(int a, int b, int c, int d) {
+        add_face(a, b, c);
+        add_face(a, c, d);
+    }
+
+    // Every table filled exactly and every index inside the vertex table
+    constexpr bool complete() const {
+        if (vertex_count != V || edge_count != E || face_count != F) return false;
+        auto valid = [](int i) { return i >= 0 && i < static_cast<int>(V); };
+        for (const auto& e : edges) {
+            if (!valid(e.start) || !valid(e.end)) return false;
+        }
+        for (const auto& f : faces) {
+            if (!valid(f.a) || !valid(f.b) || !valid(f.c)) return false;
+        }
+        return true;
+    }
+
+    constexpr operator MeshView() const { return {vertices, faces, edges}; }
+};
+
+namespace airframe {
+    constexpr float BASE = 0.15f;
+    constexpr float BODY_HALF_WIDTH = BASE * 0.5f, BODY_HALF_HEIGHT = BASE * 0.3f, BODY_HALF_LENGTH = BASE * 1.2f;
+    constexpr float ARM_LENGTH = BASE * 6.1033f; // Quad X motors at (+-5, +-3.5) BASE
+    constexpr float MOTOR_RADIUS = BASE * 0.5f, MOTOR_HALF_HEIGHT = BASE * 0.2f;
+    constexpr float COAXIAL_OFFSET = BASE * 0.25f; // Motor centers above / below the arm on coaxial frames
+    constexpr int RING_SEGMENTS = 16; // Cylinder faces and uprights
+
+    // Box: edges, and faces that hide what is behind it
+    constexpr StaticMesh<8, 12, 12> make_body() {
+        StaticMesh<8, 12, 12> body;
+        const float w = BODY_HALF_WIDTH, h = BODY_HALF_HEIGHT, l = BODY_HALF_LENGTH;
+        const RenderEngine::Point_3D corners[8] = {
+            {w,h,l}, {w,-h,l}, {-w,h,l}, {-w,-h,l},
+            {w,h,-l}, {w,-h,-l}, {-w,h,-l}, {-w,-h,-l}
+        };
+        for (const auto& p : corners) body.add_vertex(p);
+
+        const int box_edges[12][2] = {{0,1},{2,3},{4,5},{6,7},{0,2},{2,6},{6,4},{4,0},{1,3},{3,7},{7,5},{5,1}};
+        for (const auto& e : box_edges) body.add_edge(e[0], e[1]);
+
+        body.add_quad(0, 2, 3, 1); // Front
+        body.add_quad(4, 5, 7, 6); // Back
+        body.add_quad(0, 4, 6, 2); // Top
+        body.add_quad(1, 3, 7, 5); // Bottom
+        body.add_quad(0, 1, 5, 4); // Right
+        body.add_quad(2, 6, 7, 3); // Left
+        return body;
+    }
+
+    // Front arrow from the center of the body's front face, lines only
+    constexpr StaticMesh<4, 3, 0> make_arrow() {
+        StaticMesh<4, 3, 0> arrow;
+        const float l = BODY_HALF_LENGTH;
+        int base = arrow.add_vertex({0.0f, 0.0f, l});
+        int tip = arrow.add_vertex({0.0f, 0.0f, l + BASE * 1.5f});
+        int left = arrow.add_vertex({-BASE * 0.4f, 0.0f, l + BASE * 0.8f});
+        int right = arrow.add_vertex({BASE * 0.4f, 0.0f, l + BASE * 0.8f});
+        arrow.add_edge(base, tip);
+        arrow.add_edge(tip, left);
+        arrow.add_edge(tip, right);
+        return arrow;
+    }
+
+    // Center to each arm end, lines only
+    template <int ARMS>
+    constexpr StaticMesh<ARMS + 1, ARMS, 0> make_arms(const AirframeSpec& spec) {
+        StaticMesh<ARMS + 1, ARMS, 0> arms;
+        int center = arms.add_vertex({0.0f, 0.0f, 0.0f});
+        for (int i = 0; i < ARMS; i++) {
+            double a = math3d::radians(spec.arm_degrees[i]);
+            RenderEngine::Point_3D end = {static_cast<float>(ARM_LENGTH * math3d::sin(a)), 0.0f,
+                                          static_cast<float>(ARM_LENGTH * math3d::cos(a))};
+            arms.add_edge(center, arms.add_vertex(end));
+        }
+        return arms;
+    }
+
+    // Motor centers: one per arm end, or above and below it on coaxial frames
+    template <int MOTORS>
+    constexpr std::array<RenderEngine::Point_3D, MOTORS> make_motor_centers(const AirframeSpec& spec) {
+        std::array<RenderEngine::Point_3D, MOTORS> centers{};
+        int per_arm = spec.coaxial ? 2 : 1;
+        for (int i = 0; i < MOTORS; i++) {
+            double a = math3d::radians(spec.arm_degrees[i / per_arm]);
+            float y = spec.coaxial ? (i % 2 == 0 ? COAXIAL_OFFSET : -COAXIAL_OFFSET) : 0.0f;
+            centers[i] = {static_cast<float>(ARM_LENGTH * math3d::sin(a)), y, static_cast<float>(ARM_LENGTH * math3d::cos(a))};
+        }
+        return centers;
+    }
+
+    // Cylinders: uprights, faces for the sides and caps
+    template <int MOTORS>
+    constexpr auto make_motors(const std::array<RenderEngine::Point_3D, MOTORS>& centers) {
+        StaticMesh<MOTORS * (2 * RING_SEGMENTS + 2), MOTORS * RING_SEGMENTS, MOTORS * 4 * RING_SEGMENTS> motors;
+        for (const auto& m : centers) {
+            // Ring vertices: top at even indices, bottom at odd ones
+            int first = static_cast<int>(motors.vertex_count);
+            for (int s = 0; s < RING_SEGMENTS; s++) {
+                double a = s * (2.0 * math3d::PI / RING_SEGMENTS);
+                float x = m.x + static_cast<float>(math3d::cos(a)) * MOTOR_RADIUS;
+                float z = m.z + static_cast<float>(math3d::sin(a)) * MOTOR_RADIUS;
+                motors.add_vertex({x, m.y + MOTOR_HALF_HEIGHT, z});
+                motors.add_vertex({x, m.y - MOTOR_HALF_HEIGHT, z});
+            }
+            int top_center = motors.add_vertex({m.x, m.y + MOTOR_HALF_HEIGHT, m.z});
+            int bottom_center = motors.add_vertex({m.x, m.y - MOTOR_HALF_HEIGHT, m.z});
+
+            for (int s = 0; s < RING_SEGMENTS; s++) {
+                int top = first + 2 * s, bottom = top + 1;
+                int next_top = first + 2 * ((s + 1) % RING_SEGMENTS), next_bottom = next_top + 1;
+
+                motors.add_edge(top, bottom);
+
+                motors.add_quad(top, next_top, next_bottom, bottom);
+                motors.add_face(top_center, next_top, top);
+                motors.add_face(bottom_center, bottom, next_bottom);
+            }
+        }
+        return motors;
+    }
+
+    // Shared by every frame type
+    inline constexpr auto BODY = make_body();
+    inline constexpr auto ARROW = make_arrow();
+    static_assert(BODY.complete() && ARROW.complete());
+}
+
+/**
+ * @brief One frame type's geometry, all of it constant data.
+ *
+ * Instantiating it with a frame type that has no valid descriptor stops the
+ * build at the static_assert.
+ */
+template <FrameType TYPE>
+struct Airframe {
+    static constexpr AirframeSpec SPEC = airframe_spec(TYPE);
+    static_assert(SPEC.arms >= 3 && SPEC.arms <= AirframeSpec::MAX_ARMS, "frame type without a valid arm layout");
+    static constexpr int MOTORS = SPEC.arms * (SPEC.coaxial ? 2 : 1);
+
+    static constexpr const auto& body = airframe::BODY;
+    static constexpr const auto& arrow = airframe::ARROW;
+    static constexpr auto arms = airframe::make_arms<SPEC.arms>(SPEC);
+    static constexpr auto motor_centers = airframe::make_motor_centers<MOTORS>(SPEC);
+    static constexpr auto motors = airframe::make_motors<MOTORS>(motor_centers);
+    static_assert(arms.complete() && motors.complete(), "generated airframe tables do not add up");
+};
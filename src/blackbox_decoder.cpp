@@ -0,0 +1,824 @@
+#include "blackbox_decoder.h"
+#include "logger.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+namespace {
+    // --- Field encodings (Betaflight blackbox.h) ---
+    enum Encoding {
+        ENC_SIGNED_VB = 0,
+        ENC_UNSIGNED_VB = 1,
+        ENC_NEG_14BIT = 3,
+        ENC_TAG8_8SVB = 6,
+        ENC_TAG2_3S32 = 7,
+        ENC_TAG8_4S16 = 8,
+        ENC_NULL = 9,
+        ENC_TAG2_3SVARIABLE = 10
+    };
+
+    // --- Field predictors ---
+    enum Predictor {
+        PRED_ZERO = 0,
+        PRED_PREVIOUS = 1,
+        PRED_STRAIGHT_LINE = 2,
+        PRED_AVERAGE_2 = 3,
+        PRED_MINTHROTTLE = 4,
+        PRED_MOTOR_0 = 5,
+        PRED_INC = 6,
+        PRED_HOME_COORD = 7,
+        PRED_1500 = 8,
+        PRED_VBATREF = 9,
+        PRED_LAST_MAIN_FRAME_TIME = 10,
+        PRED_MINMOTOR = 11
+    };
+
+    // --- Event types we know the layout of ---
+    enum EventType {
+        EVENT_SYNC_BEEP = 0,
+        EVENT_INFLIGHT_ADJUSTMENT = 13,
+        EVENT_LOGGING_RESUME = 14,
+        EVENT_DISARM = 15,
+        EVENT_FLIGHT_MODE = 30,
+        EVENT_LOG_END = 255
+    };
+
+    constexpr size_t MAX_FIELDS = 128;
+    constexpr size_t MIN_CHUNK_BYTES = 256 * 1024;
+    constexpr const char LOG_START_MARKER[] = "H Product:";
+
+    // The firmware closes a log with E 0xFF "End of log" NUL
+    constexpr const char LOG_END_MESSAGE[] = "End of log";
+    constexpr size_t LOG_END_BYTES = 2 + sizeof(LOG_END_MESSAGE);
+
+    // How far back from a possible log start to look for an I-frame to decode forward from
+    constexpr size_t BOUNDARY_SEARCH_BYTES = 64 * 1024;
+
+    bool is_frame_marker(uint8_t b) {
+        return b == 'I' || b == 'P' || b == 'E' || b == 'S' || b == 'G' || b == 'H';
+    }
+
+    int32_t sign_extend(uint32_t value, int bits) {
+        uint32_t shift = 32 - bits;
+        return static_cast<int32_t>(value << shift) >> shift;
+    }
+
+    struct FrameDef {
+        std::vector<std::string> names;
+        std::vector<int> is_signed;
+        std::vector<int> predictor;
+        std::vector<int> encoding;
+
+        size_t count() const { return names.size(); }
+        bool valid() const { return !names.empty() && encoding.size() == names.size() && predictor.size() == names.size(); }
+
+        int find(std::string_view name) const {
+            for (size_t i = 0; i < names.size(); i++) if (names[i] == name) return static_cast<int>(i);
+            return -1;
+        }
+    };
+
+    struct LogHeader {
+        FrameDef frame_i, frame_p, frame_s, frame_g, frame_h;
+        std::string firmware;
+
+        int i_interval = 32;
+        int p_num = 1;
+        int p_denom = 1;
+        int64_t minthrottle = 1150;
+        int64_t vbatref = 4095;
+        int64_t motor_output_min = 0;
+        float gyro_scale = 1.0f;
+
+        // Indices into the main frame of the fields we turn into telemetry
+        int idx_loop = -1;
+        int idx_time = -1;
+        int idx_motor0 = -1;
+        int idx_attitude[3] = {-1, -1, -1};
+        int idx_gyro[3] = {-1, -1, -1};
+
+        bool has_attitude() const { return idx_attitude[0] >= 0 && idx_attitude[1] >= 0 && idx_attitude[2] >= 0; }
+        bool has_gyro() const { return idx_gyro[0] >= 0 && idx_gyro[1] >= 0 && idx_gyro[2] >= 0; }
+
+        // Betaflight logs iteration i as a main frame if this holds
+        bool should_have_frame(int64_t iteration) const {
+            return (iteration % i_interval + p_num - 1) % p_denom < p_num;
+        }
+    };
+
+    // Bounds-checked byte reader over the mapped log. Reading past the end yields zeros and sets `overrun`.
+    struct Stream {
+        const uint8_t* pos;
+        const uint8_t* end;
+        bool overrun = false;
+
+        uint8_t byte() {
+            if (pos >= end) {
+                overrun = true;
+                return 0;
+            }
+            return *pos++;
+        }
+
+        uint32_t unsigned_vb() {
+            uint32_t result = 0;
+            for (int shift = 0; shift < 35; shift += 7) {
+                uint8_t b = byte();
+                result |= static_cast<uint32_t>(b & 0x7F) << shift;
+                if ((b & 0x80) == 0) return result;
+            }
+            overrun = true; // More than 5 bytes: not a valid varint, we lost sync
+            return 0;
+        }
+
+        int32_t signed_vb() {
+            uint32_t u = unsigned_vb();
+            return static_cast<int32_t>((u >> 1) ^ (~(u & 1) + 1)); // Zigzag
+        }
+    };
+
+    // --- Header parsing ---
+
+    std::vector<std::string> split_csv(std::string_view text) {
+        std::vector<std::string> out;
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t comma = text.find(',', start);
+            if (comma == std::string_view::npos) comma = text.size();
+            out.emplace_back(text.substr(start, comma - start));
+            start = comma + 1;
+        }
+        return out;
+    }
+
+    std::vector<int> split_ints(std::string_view text) {
+        std::vector<int> out;
+        for (const std::string& item : split_csv(text)) out.push_back(std::atoi(item.c_str()));
+        return out;
+    }
+
+    FrameDef* frame_def_for(LogHeader& header, char type) {
+        switch (type) {
+            case 'I': return &header.frame_i;
+            case 'P': return &header.frame_p;
+            case 'S': return &header.frame_s;
+            case 'G': return &header.frame_g;
+            case 'H': return &header.frame_h;
+            default: return nullptr;
+        }
+    }
+
+    // Parses the "H key:value" lines. Returns the offset of the first data byte.
+    size_t parse_header(const uint8_t* data, size_t size, LogHeader& header) {
+        size_t pos = 0;
+        while (pos + 2 < size && data[pos] == 'H' && data[pos + 1] == ' ') {
+            const uint8_t* nl = static_cast<const uint8_t*>(std::memchr(data + pos, '\n', size - pos));
+            if (nl == nullptr) break;
+
+            std::string_view line(reinterpret_cast<const char*>(data + pos + 2), nl - (data + pos + 2));
+            pos = static_cast<size_t>(nl - data) + 1;
+
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos) continue;
+            std::string_view key = line.substr(0, colon);
+            std::string_view value = line.substr(colon + 1);
+            std::string value_str(value);
+
+            // "Field X name" / "Field X signed" / "Field X predictor" / "Field X encoding"
+            if (key.size() > 8 && key.substr(0, 6) == "Field ") {
+                FrameDef* def = frame_def_for(header, key[6]);
+                std::string_view what = key.substr(8);
+                if (def == nullptr) continue;
+
+                if (what == "name") def->names = split_csv(value);
+                else if (what == "signed") def->is_signed = split_ints(value);
+                else if (what == "predictor") def->predictor = split_ints(value);
+                else if (what == "encoding") def->encoding = split_ints(value);
+            } else if (key == "I interval") {
+                header.i_interval = std::max(1, std::atoi(value_str.c_str()));
+            } else if (key == "P interval") {
+                // "num/denom" (older firmware) or a plain number
+                size_t slash = value.find('/');
+                if (slash != std::string_view::npos) {
+                    header.p_num = std::max(1, std::atoi(std::string(value.substr(0, slash)).c_str()));
+                    header.p_denom = std::max(1, std::atoi(std::string(value.substr(slash + 1)).c_str()));
+                } else {
+                    header.p_denom = std::max(1, std::atoi(value_str.c_str()));
+                }
+            } else if (key == "P ratio") {
+                header.p_num = 1;
+                header.p_denom = std::max(1, std::atoi(value_str.c_str()));
+            } else if (key == "minthrottle") {
+                header.minthrottle = std::atoi(value_str.c_str());
+            } else if (key == "vbatref") {
+                header.vbatref = std::atoi(value_str.c_str());
+            } else if (key == "motorOutput") {
+                header.motor_output_min = std::atoi(value_str.c_str()); // "min,max": atoi stops at the comma
+            } else if (key == "gyro_scale") {
+                uint32_t bits = static_cast<uint32_t>(std::strtoul(value_str.c_str(), nullptr, 16));
+                std::memcpy(&header.gyro_scale, &bits, sizeof(bits));
+            } else if (key == "Firmware revision") {
+                header.firmware = value_str;
+            }
+        }
+
+        // P frames share names and signedness with I frames
+        header.frame_p.names = header.frame_i.names;
+        header.frame_p.is_signed = header.frame_i.is_signed;
+
+        for (FrameDef* def : {&header.frame_i, &header.frame_p, &header.frame_s, &header.frame_g, &header.frame_h}) {
+            def->is_signed.resize(def->names.size(), 0);
+            if (def->names.size() > MAX_FIELDS) def->names.clear(); // Unusable, treated as missing
+        }
+
+        const FrameDef& main = header.frame_i;
+        header.idx_loop = main.find("loopIteration");
+        header.idx_time = main.find("time");
+        header.idx_motor0 = main.find("motor[0]");
+        for (int axis = 0; axis < 3; axis++) {
+            header.idx_attitude[axis] = main.find("attitude[" + std::to_string(axis) + "]");
+            header.idx_gyro[axis] = main.find("gyroADC[" + std::to_string(axis) + "]");
+        }
+        return pos;
+    }
+
+    // --- Frame decoding ---
+
+    // Reads the raw (un-predicted) values of one frame
+    bool read_fields(Stream& s, const FrameDef& def, int64_t* values) {
+        size_t n = def.count();
+        size_t i = 0;
+
+        while (i < n) {
+            switch (def.encoding[i]) {
+                case ENC_SIGNED_VB:
+                    values[i++] = s.signed_vb();
+                    break;
+
+                case ENC_UNSIGNED_VB:
+                    values[i++] = s.unsigned_vb();
+                    break;
+
+                case ENC_NEG_14BIT:
+                    values[i++] = -sign_extend(s.unsigned_vb(), 14);
+                    break;
+
+                case ENC_NULL:
+                    values[i++] = 0;
+                    break;
+
+                case ENC_TAG8_8SVB: {
+                    // Groups up to 8 consecutive fields that share this encoding
+                    size_t group = 1;
+                    while (group < 8 && i + group < n && def.encoding[i + group] == ENC_TAG8_8SVB) group++;
+
+                    if (group == 1) {
+                        values[i] = s.signed_vb();
+                    } else {
+                        uint8_t header = s.byte();
+                        for (size_t j = 0; j < group; j++, header >>= 1) {
+                            values[i + j] = (header & 1) ? s.signed_vb() : 0;
+                        }
+                    }
+                    i += group;
+                    break;
+                }
+
+                case ENC_TAG2_3S32: {
+                    int32_t v[3] = {0, 0, 0};
+                    uint8_t lead = s.byte();
+                    switch (lead >> 6) {
+                        case 0: // 2-bit fields
+                            v[0] = sign_extend((lead >> 4) & 0x03, 2);
+                            v[1] = sign_extend((lead >> 2) & 0x03, 2);
+                            v[2] = sign_extend(lead & 0x03, 2);
+                            break;
+                        case 1: { // 4-bit fields
+                            v[0] = sign_extend(lead & 0x0F, 4);
+                            uint8_t b = s.byte();
+                            v[1] = sign_extend(b >> 4, 4);
+                            v[2] = sign_extend(b & 0x0F, 4);
+                            break;
+                        }
+                        case 2: // 6-bit fields
+                            v[0] = sign_extend(lead & 0x3F, 6);
+                            v[1] = sign_extend(s.byte() & 0x3F, 6);
+                            v[2] = sign_extend(s.byte() & 0x3F, 6);
+                            break;
+                        case 3: // 8/16/24/32-bit little-endian fields, 2 selector bits each
+                            for (int j = 0; j < 3; j++, lead >>= 2) {
+                                switch (lead & 0x03) {
+                                    case 0: v[j] = sign_extend(s.byte(), 8); break;
+                                    case 1: { uint32_t b0 = s.byte(), b1 = s.byte();
+                                              v[j] = sign_extend(b0 | (b1 << 8), 16); break; }
+                                    case 2: { uint32_t b0 = s.byte(), b1 = s.byte(), b2 = s.byte();
+                                              v[j] = sign_extend(b0 | (b1 << 8) | (b2 << 16), 24); break; }
+                                    case 3: { uint32_t b0 = s.byte(), b1 = s.byte(), b2 = s.byte(), b3 = s.byte();
+                                              v[j] = static_cast<int32_t>(b0 | (b1 << 8) | (b2 << 16) | (b3 << 24)); break; }
+                                }
+                            }
+                            break;
+                    }
+                    for (int j = 0; j < 3 && i < n; j++) values[i++] = v[j];
+                    break;
+                }
+
+                case ENC_TAG2_3SVARIABLE: {
+                    int32_t v[3] = {0, 0, 0};
+                    uint8_t lead = s.byte();
+                    switch (lead >> 6) {
+                        case 0: // 2-2-2 bits
+                            v[0] = sign_extend((lead >> 4) & 0x03, 2);
+                            v[1] = sign_extend((lead >> 2) & 0x03, 2);
+                            v[2] = sign_extend(lead & 0x03, 2);
+                            break;
+                        case 1: { // 5-5-4 bits
+                            v[0] = sign_extend((lead & 0x3E) >> 1, 5);
+                            uint8_t b1 = s.byte();
+                            v[1] = sign_extend(((lead & 0x01) << 4) | ((b1 & 0xF0) >> 4), 5);
+                            v[2] = sign_extend(b1 & 0x0F, 4);
+                            break;
+                        }
+                        case 2: { // 8-7-7 bits
+                            uint8_t b1 = s.byte();
+                            v[0] = sign_extend(((lead & 0x3F) << 2) | ((b1 & 0xC0) >> 6), 8);
+                            uint8_t b2 = s.byte();
+                            v[1] = sign_extend(((b1 & 0x3F) << 1) | ((b2 & 0x80) >> 7), 7);
+                            v[2] = sign_extend(b2 & 0x7F, 7);
+                            break;
+                        }
+                        case 3: // Whole bytes, same as TAG2_3S32
+                            for (int j = 0; j < 3; j++, lead >>= 2) {
+                                switch (lead & 0x03) {
+                                    case 0: v[j] = sign_extend(s.byte(), 8); break;
+                                    case 1: { uint32_t b0 = s.byte(), b1 = s.byte();
+                                              v[j] = sign_extend(b0 | (b1 << 8), 16); break; }
+                                    case 2: { uint32_t b0 = s.byte(), b1 = s.byte(), b2 = s.byte();
+                                              v[j] = sign_extend(b0 | (b1 << 8) | (b2 << 16), 24); break; }
+                                    case 3: { uint32_t b0 = s.byte(), b1 = s.byte(), b2 = s.byte(), b3 = s.byte();
+                                              v[j] = static_cast<int32_t>(b0 | (b1 << 8) | (b2 << 16) | (b3 << 24)); break; }
+                                }
+                            }
+                            break;
+                    }
+                    for (int j = 0; j < 3 && i < n; j++) values[i++] = v[j];
+                    break;
+                }
+
+                case ENC_TAG8_4S16: {
+                    // Data version 2 layout: nibble-packed, 16-bit values big-endian
+                    int32_t v[4] = {0, 0, 0, 0};
+                    uint8_t selector = s.byte();
+                    uint8_t buffer = 0;
+                    bool half = false; // Low nibble of `buffer` still unread
+
+                    for (int j = 0; j < 4; j++, selector >>= 2) {
+                        switch (selector & 0x03) {
+                            case 0:
+                                v[j] = 0;
+                                break;
+                            case 1: // 4 bits
+                                if (!half) {
+                                    buffer = s.byte();
+                                    v[j] = sign_extend(buffer >> 4, 4);
+                                    half = true;
+                                } else {
+                                    v[j] = sign_extend(buffer & 0x0F, 4);
+                                    half = false;
+                                }
+                                break;
+                            case 2: // 8 bits
+                                if (!half) {
+                                    v[j] = sign_extend(s.byte(), 8);
+                                } else {
+                                    uint8_t c = static_cast<uint8_t>(buffer << 4);
+                                    buffer = s.byte();
+                                    c |= buffer >> 4;
+                                    v[j] = sign_extend(c, 8);
+                                }
+                                break;
+                            case 3: // 16 bits
+                                if (!half) {
+                                    uint32_t c1 = s.byte(), c2 = s.byte();
+                                    v[j] = sign_extend((c1 << 8) | c2, 16);
+                                } else {
+                                    uint32_t c1 = s.byte(), c2 = s.byte();
+                                    v[j] = sign_extend(((buffer << 12) | (c1 << 4) | (c2 >> 4)) & 0xFFFF, 16);
+                                    buffer = static_cast<uint8_t>(c2);
+                                }
+                                break;
+                        }
+                    }
+                    for (int j = 0; j < 4 && i < n; j++) values[i++] = v[j];
+                    break;
+                }
+
+                default:
+                    return false; // Unknown encoding: cannot know how many bytes to skip
+            }
+        }
+        return !s.overrun;
+    }
+
+    // Turns raw values into real ones. previous / previous2 are null for I-frames.
+    // last_main is the main frame decoded before this one, null if there is none yet.
+    void apply_predictors(const LogHeader& header, const FrameDef& def, int64_t* values,
+                          const int64_t* previous, const int64_t* previous2, const int64_t* last_main, int64_t skipped) {
+        int home_coord = 0;
+
+        for (size_t i = 0; i < def.count(); i++) {
+            int64_t value = values[i];
+
+            switch (def.predictor[i]) {
+                case PRED_ZERO:
+                    break;
+                case PRED_PREVIOUS:
+                    if (previous) value += previous[i];
+                    break;
+                case PRED_STRAIGHT_LINE:
+                    if (previous) value += 2 * previous[i] - previous2[i];
+                    break;
+                case PRED_AVERAGE_2:
+                    if (previous) {
+                        if (def.is_signed[i]) value += (previous[i] + previous2[i]) / 2;
+                        else value += (static_cast<uint64_t>(static_cast<uint32_t>(previous[i])) +
+                                       static_cast<uint32_t>(previous2[i])) / 2;
+                    }
+                    break;
+                case PRED_MINTHROTTLE:
+                    value += header.minthrottle;
+                    break;
+                case PRED_MOTOR_0:
+                    if (header.idx_motor0 >= 0 && static_cast<size_t>(header.idx_motor0) < i) value += values[header.idx_motor0];
+                    break;
+                case PRED_INC:
+                    value += skipped + 1;
+                    if (previous) value += previous[i];
+                    break;
+                case PRED_HOME_COORD:
+                    home_coord++; // GPS only, not needed for attitude: byte layout is unaffected
+                    break;
+                case PRED_1500:
+                    value += 1500;
+                    break;
+                case PRED_VBATREF:
+                    value += header.vbatref;
+                    break;
+                case PRED_LAST_MAIN_FRAME_TIME:
+                    if (last_main && header.idx_time >= 0) value += last_main[header.idx_time];
+                    break;
+                case PRED_MINMOTOR:
+                    value += header.motor_output_min;
+                    break;
+            }
+
+            // The firmware works in 32-bit arithmetic, wrap the same way
+            values[i] = def.is_signed[i] ? static_cast<int64_t>(static_cast<int32_t>(value))
+                                         : static_cast<int64_t>(static_cast<uint32_t>(value));
+        }
+        (void)home_coord;
+    }
+
+    // Decoder state for one contiguous run of frames
+    struct ChunkDecoder {
+        const LogHeader& header;
+        const uint8_t* data_end;
+
+        int64_t history[3][MAX_FIELDS];
+        int64_t* current = history[0];
+        int64_t* previous = history[1];
+        int64_t* previous2 = history[2];
+        bool have_main = false;
+        int64_t last_iteration = -1;
+
+        std::vector<TelemetrySample> samples;
+        uint64_t main_frames = 0;
+        uint64_t corrupt_frames = 0;
+        bool log_end = false; // The end-of-log event was in this chunk
+
+        ChunkDecoder(const LogHeader& h, const uint8_t* end) : header(h), data_end(end) {}
+
+        int64_t skipped_frames() const {
+            if (last_iteration < 0) return 0;
+            int64_t count = 0;
+            for (int64_t it = last_iteration + 1; !header.should_have_frame(it) && count < 1 << 20; it++) count++;
+            return count;
+        }
+
+        // A frame only counts if the byte after it starts another frame (or the log ends)
+        bool followed_by_frame(const Stream& s) const {
+            return s.pos >= data_end || is_frame_marker(*s.pos);
+        }
+
+        void emit() {
+            TelemetrySample sample = {};
+            sample.timestamp_us = header.idx_time >= 0 ? current[header.idx_time] : 0;
+
+            if (header.has_attitude()) {
+                // INAV: decidegrees
+                sample.attitude.roll  = current[header.idx_attitude[0]] / 10.0;
+                sample.attitude.pitch = current[header.idx_attitude[1]] / 10.0;
+                sample.attitude.yaw   = current[header.idx_attitude[2]] / 10.0;
+            } else if (header.has_gyro()) {
+                // Rates in deg/s for now, integrated after all chunks are joined
+                sample.attitude.roll  = current[header.idx_gyro[0]] * header.gyro_scale;
+                sample.attitude.pitch = current[header.idx_gyro[1]] * header.gyro_scale;
+                sample.attitude.yaw   = current[header.idx_gyro[2]] * header.gyro_scale;
+            }
+            samples.push_back(sample);
+        }
+
+        // Attempts one frame at pos. Returns the position after it, or nullptr if it is not a valid frame.
+        // Sets log_end when the end-of-log event is seen.
+        const uint8_t* step(const uint8_t* pos, bool& log_end) {
+            Stream s{pos + 1, data_end};
+            uint8_t marker = *pos;
+
+            if (marker == 'I' || marker == 'P') {
+                const FrameDef& def = (marker == 'I') ? header.frame_i : header.frame_p;
+                if (!def.valid() || (marker == 'P' && !have_main)) return nullptr;
+
+                int64_t skipped = (marker == 'P') ? skipped_frames() : 0;
+                if (!read_fields(s, def, current) || !followed_by_frame(s)) return nullptr;
+
+                const int64_t* last_main = have_main ? previous : nullptr;
+                if (marker == 'I') {
+                    apply_predictors(header, def, current, nullptr, nullptr, last_main, 0);
+                } else {
+                    apply_predictors(header, def, current, previous, previous2, last_main, skipped);
+                }
+
+                have_main = true;
+                if (header.idx_loop >= 0) last_iteration = current[header.idx_loop];
+                emit();
+
+                // Rotate history. After an I-frame both predecessors are the I-frame itself.
+                if (marker == 'I') {
+                    std::memcpy(previous, current, def.count() * sizeof(int64_t));
+                    std::memcpy(previous2, current, def.count() * sizeof(int64_t));
+                } else {
+                    int64_t* oldest = previous2;
+                    previous2 = previous;
+                    previous = current;
+                    current = oldest;
+                }
+
+                main_frames++;
+                return s.pos;
+            }
+
+            if (marker == 'S' || marker == 'G' || marker == 'H') {
+                const FrameDef* def = (marker == 'S') ? &header.frame_s : (marker == 'G') ? &header.frame_g : &header.frame_h;
+                int64_t scratch[MAX_FIELDS];
+                if (!def->valid() || !read_fields(s, *def, scratch) || !followed_by_frame(s)) return nullptr;
+                return s.pos;
+            }
+
+            if (marker == 'E') {
+                switch (s.byte()) {
+                    case EVENT_SYNC_BEEP:
+                        s.unsigned_vb();
+                        break;
+                    case EVENT_INFLIGHT_ADJUSTMENT: {
+                        uint8_t function = s.byte();
+                        if (function & 0x80) { s.byte(); s.byte(); s.byte(); s.byte(); } // float value
+                        else s.signed_vb();
+                        break;
+                    }
+                    case EVENT_LOGGING_RESUME:
+                        last_iteration = s.unsigned_vb();
+                        s.unsigned_vb(); // current time
+                        break;
+                    case EVENT_DISARM:
+                        s.unsigned_vb();
+                        break;
+                    case EVENT_FLIGHT_MODE:
+                        s.unsigned_vb();
+                        s.unsigned_vb();
+                        break;
+                    case EVENT_LOG_END:
+                        log_end = true;
+                        return data_end;
+                    default:
+                        return nullptr;
+                }
+                if (s.overrun || !followed_by_frame(s)) return nullptr;
+                return s.pos;
+            }
+
+            return nullptr;
+        }
+
+        // Decodes [begin, end). Frames never straddle `end`, it is an I-frame boundary.
+        void run(const uint8_t* begin, const uint8_t* end) {
+            const uint8_t* pos = begin;
+
+            while (pos < end && !log_end) {
+                const uint8_t* next = step(pos, log_end);
+                if (next != nullptr) {
+                    pos = next;
+                    continue;
+                }
+
+                // Corrupt or unknown frame: drop history and resync on the next I-frame
+                corrupt_frames++;
+                have_main = false;
+                const void* found = std::memchr(pos + 1, 'I', static_cast<size_t>(end - (pos + 1)));
+                pos = found ? static_cast<const uint8_t*>(found) : end;
+            }
+        }
+    };
+
+    // True if an I-frame that decodes cleanly starts at pos and is followed by another frame.
+    // loopIteration of an I-frame is always a multiple of the I interval, which rules out
+    // almost every false 'I' byte inside binary data.
+    bool is_sync_point(const LogHeader& header, const uint8_t* pos, const uint8_t* data_end) {
+        if (*pos != 'I' || !header.frame_i.valid()) return false;
+
+        int64_t values[MAX_FIELDS];
+        Stream s{pos + 1, data_end};
+        if (!read_fields(s, header.frame_i, values)) return false;
+        if (s.pos < data_end && !is_frame_marker(*s.pos)) return false;
+
+        apply_predictors(header, header.frame_i, values, nullptr, nullptr, nullptr, 0);
+        if (header.idx_loop >= 0 && values[header.idx_loop] % header.i_interval != 0) return false;
+        return true;
+    }
+
+    // True if the log starting at log_begin has frames that decode cleanly right up to pos, so
+    // a header at pos follows a frame boundary. Decodes forward from the last I-frame before pos.
+    bool frames_end_at(const uint8_t* log_begin, const uint8_t* pos) {
+        LogHeader header;
+        const uint8_t* data = log_begin + parse_header(log_begin, static_cast<size_t>(pos - log_begin), header);
+        if (data == pos) return true; // Header only, no frames were logged
+        if (!header.frame_i.valid() || !header.frame_p.valid()) return false;
+
+        size_t window = std::min(BOUNDARY_SEARCH_BYTES, static_cast<size_t>(pos - data));
+        for (size_t back = 1; back <= window; back++) {
+            const uint8_t* sync = pos - back;
+            if (!is_sync_point(header, sync, pos)) continue;
+
+            ChunkDecoder chunk(header, pos);
+            chunk.run(sync, pos);
+            return chunk.corrupt_frames == 0;
+        }
+        return false;
+    }
+
+    // True if the LOG_START_MARKER at pos starts a new log after the one at log_begin rather
+    // than being bytes inside its frames: it must follow the end-of-log event, or a frame boundary
+    // (a log cut short by power loss has no end event).
+    bool starts_log(const uint8_t* log_begin, const uint8_t* pos) {
+        if (static_cast<size_t>(pos - log_begin) >= LOG_END_BYTES) {
+            const uint8_t* event = pos - LOG_END_BYTES;
+            if (event[0] == 'E' && event[1] == EVENT_LOG_END &&
+                std::memcmp(event + 2, LOG_END_MESSAGE, sizeof(LOG_END_MESSAGE)) == 0) return true;
+        }
+        return frames_end_at(log_begin, pos);
+    }
+
+    // Replaces gyro rates (deg/s) with integrated angles
+    void integrate_gyro(std::vector<TelemetrySample>& samples) {
+        DroneTelemetry angle = {0.0, 0.0, 0.0};
+        int64_t last_time = samples.empty() ? 0 : samples.front().timestamp_us;
+
+        for (TelemetrySample& sample : samples) {
+            double dt = (sample.timestamp_us - last_time) * 1e-6;
+            if (dt < 0.0 || dt > 0.5) dt = 0.0; // Time jump (resume / corruption): don't integrate across it
+            last_time = sample.timestamp_us;
+
+            angle.roll  += sample.attitude.roll * dt;
+            angle.pitch += sample.attitude.pitch * dt;
+            angle.yaw   += sample.attitude.yaw * dt;
+            angle.yaw = std::fmod(angle.yaw + 540.0, 360.0) - 180.0;
+
+            sample.attitude = angle;
+        }
+    }
+
+    BlackboxDecoder::Log decode_log(const uint8_t* data, size_t size, ThreadPool& pool) {
+        BlackboxDecoder::Log log;
+        LogHeader header;
+        size_t data_start = parse_header(data, size, header);
+        log.firmware = header.firmware;
+        log.has_attitude = header.has_attitude();
+
+        if (!header.frame_i.valid() || !header.frame_p.valid()) {
+            LOG_WARN("[Blackbox] Log has no usable I/P field definitions, skipped");
+            return log;
+        }
+
+        const uint8_t* begin = data + data_start;
+        const uint8_t* end = data + size;
+        size_t data_size = size - data_start;
+
+        // 1. Pick roughly evenly spaced split offsets, then move each to the next real I-frame
+        size_t chunk_target = std::max<size_t>(pool.size() * 4, 1);
+        size_t chunk_bytes = std::max(MIN_CHUNK_BYTES, data_size / chunk_target + 1);
+        size_t split_count = data_size / chunk_bytes + 1;
+
+        std::vector<const uint8_t*> splits(split_count, end);
+        splits[0] = begin;
+        pool.parallel_for(split_count - 1, [&](size_t k) {
+            const uint8_t* pos = begin + (k + 1) * chunk_bytes;
+            while (pos < end) {
+                const void* found = std::memchr(pos, 'I', static_cast<size_t>(end - pos));
+                if (found == nullptr) break;
+                pos = static_cast<const uint8_t*>(found);
+                if (is_sync_point(header, pos, end)) {
+                    splits[k + 1] = pos;
+                    return;
+                }
+                pos++;
+            }
+        });
+        std::sort(splits.begin(), splits.end());
+        splits.erase(std::unique(splits.begin(), splits.end()), splits.end());
+        if (splits.back() != end) splits.push_back(end);
+
+        // 2. Decode every chunk independently
+        size_t chunk_count = splits.size() - 1;
+        std::vector<std::unique_ptr<ChunkDecoder>> chunks(chunk_count);
+        pool.parallel_for(chunk_count, [&](size_t k) {
+            chunks[k] = std::make_unique<ChunkDecoder>(header, end);
+            chunks[k]->run(splits[k], splits[k + 1]);
+        });
+
+        // 3. Join in order. A LOG_END event inside a chunk means later chunks are padding:
+        //    whatever they decoded is leftover data on the flash, not part of this flight.
+        size_t used = 0, total = 0;
+        while (used < chunk_count && (used == 0 || !chunks[used - 1]->log_end)) total += chunks[used++]->samples.size();
+        log.samples.reserve(total);
+        for (size_t k = 0; k < used; k++) {
+            log.samples.insert(log.samples.end(), chunks[k]->samples.begin(), chunks[k]->samples.end());
+            log.main_frames += chunks[k]->main_frames;
+            log.corrupt_frames += chunks[k]->corrupt_frames;
+        }
+
+        if (!log.has_attitude) integrate_gyro(log.samples);
+        return log;
+    }
+}
+
+bool BlackboxDecoder::is_blackbox_file(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+
+    char start[sizeof(LOG_START_MARKER) - 1] = {};
+    bool match = std::fread(start, 1, sizeof(start), f) == sizeof(start) &&
+                 std::memcmp(start, LOG_START_MARKER, sizeof(start)) == 0;
+    std::fclose(f);
+    return match;
+}
+
+bool BlackboxDecoder::decode_file(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path) || file.size() == 0) {
+        LOG_ERROR("[Blackbox] Cannot open %s", path);
+        return false;
+    }
+    return decode(file.data(), file.size());
+}
+
+bool BlackboxDecoder::decode(const uint8_t* data, size_t size) {
+    auto start = std::chrono::steady_clock::now();
+    m_logs.clear();
+
+    std::unique_ptr<ThreadPool> own_pool;
+    ThreadPool* pool = m_pool;
+    if (pool == nullptr) {
+        own_pool = std::make_unique<ThreadPool>();
+        pool = own_pool.get();
+    }
+
+    // One file can hold several logs (one per arming), each starting with its own header.
+    // The marker can also turn up inside binary frame data, so only real boundaries split.
+    std::string_view text(reinterpret_cast<const char*>(data), size);
+    std::vector<size_t> log_starts;
+    size_t first = text.find(LOG_START_MARKER);
+    if (first != std::string_view::npos) log_starts.push_back(first);
+    for (size_t pos = first; pos != std::string_view::npos;) {
+        pos = text.find(LOG_START_MARKER, pos + 1);
+        if (pos != std::string_view::npos && starts_log(data + log_starts.back(), data + pos)) log_starts.push_back(pos);
+    }
+    log_starts.push_back(size);
+
+    for (size_t i = 0; i + 1 < log_starts.size(); i++) {
+        Log log = decode_log(data + log_starts[i], log_starts[i + 1] - log_starts[i], *pool);
+        if (!log.samples.empty()) m_logs.push_back(std::move(log));
+    }
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    uint64_t frames = 0;
+    for (const Log& log : m_logs) frames += log.main_frames;
+    LOG_INFO("[Blackbox] Decoded %zu log(s), %llu frames in %.1f ms on %u threads",
+             m_logs.size(), frames, ms.count(), pool->size());
+
+    return !m_logs.empty();
+}
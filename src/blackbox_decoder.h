@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "telemetry.h"
+
+class ThreadPool;
+
+/**
+ * @brief Decoder for Betaflight / INAV blackbox logs (.bbl / .bfl / .txt).
+ *
+ * Produces the same TelemetrySample stream as the live path, so decoded logs
+ * can be recorded to .drec and replayed. Attitude comes from the attitude[]
+ * fields when the firmware logs them (INAV); otherwise it is integrated from
+ * gyroADC[], which drifts but is fine for visual review.
+ *
+ * I-frames do not depend on earlier frames, so the data section is split at
+ * I-frame boundaries and the chunks are decoded in parallel.
+ */
+class BlackboxDecoder {
+public:
+    struct Log {
+        std::string firmware;           // "H Firmware revision" of this log
+        bool has_attitude = false;      // attitude[] logged (true) or integrated from gyro (false)
+        std::vector<TelemetrySample> samples;
+        uint64_t main_frames = 0;       // I + P frames decoded
+        uint64_t corrupt_frames = 0;    // Frames dropped while resynchronising
+    };
+
+    // pool may be null: a temporary pool with one thread per core is used then
+    explicit BlackboxDecoder(ThreadPool* pool = nullptr) : m_pool(pool) {}
+
+    // Decodes every log contained in the file (one per arm / disarm cycle)
+    bool decode_file(const std::string& path);
+
+    // Same, for a buffer already in memory
+    bool decode(const uint8_t* data, size_t size);
+
+    const std::vector<Log>& logs() const { return m_logs; }
+
+    // Cheap check of the file signature
+    static bool is_blackbox_file(const std::string& path);
+
+private:
+    ThreadPool* m_pool;
+    std::vector<Log> m_logs;
+};
@@ -0,0 +1,72 @@
+#include "depth_buffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // How far (relative to its depth) a point must be behind the surface to count as hidden.
+    // Covers the slope of a face across one cell, so a face's own edges are not hidden by it.
+    constexpr float DEPTH_BIAS = 0.015f;
+}
+
+void DepthBuffer::resize(int width, int height, int cell) {
+    m_cell = std::max(cell, 1);
+    m_cols = std::max((width + m_cell - 1) / m_cell, 1);
+    m_rows = std::max((height + m_cell - 1) / m_cell, 1);
+    m_inv_z.assign(static_cast<size_t>(m_cols) * m_rows, 0.0f);
+}
+
+void DepthBuffer::clear() {
+    std::fill(m_inv_z.begin(), m_inv_z.end(), 0.0f);
+}
+
+void DepthBuffer::add_triangle(float x0, float y0, float inv_z0, float x1, float y1, float inv_z1,
+                               float x2, float y2, float inv_z2) {
+    // Half-space test at every cell center inside the bounding box, in cell units
+    const float scale = 1.0f / m_cell;
+    x0 *= scale; y0 *= scale;
+    x1 *= scale; y1 *= scale;
+    x2 *= scale; y2 *= scale;
+
+    float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+    if (!(std::fabs(area) > 1e-6f)) return; // Degenerate, or NaN from a bad vertex
+
+    // Cells whose center (i + 0.5) lies within the bounds
+    int min_x = std::max(static_cast<int>(std::ceil(std::min({x0, x1, x2}) - 0.5f)), 0);
+    int max_x = std::min(static_cast<int>(std::floor(std::max({x0, x1, x2}) - 0.5f)), m_cols - 1);
+    int min_y = std::max(static_cast<int>(std::ceil(std::min({y0, y1, y2}) - 0.5f)), 0);
+    int max_y = std::min(static_cast<int>(std::floor(std::max({y0, y1, y2}) - 0.5f)), m_rows - 1);
+    if (min_x > max_x || min_y > max_y) return;
+
+    // Barycentric weights as edge functions; normalized so all three are >= 0 inside whatever the winding
+    float inv_area = 1.0f / area;
+    float a0 = (y1 - y2) * inv_area, b0 = (x2 - x1) * inv_area, c0 = (x1 * y2 - x2 * y1) * inv_area;
+    float a1 = (y2 - y0) * inv_area, b1 = (x0 - x2) * inv_area, c1 = (x2 * y0 - x0 * y2) * inv_area;
+
+    // 1/z is linear in screen space: its own plane equation from the weights
+    float dz_x = a0 * inv_z0 + a1 * inv_z1 - (a0 + a1) * inv_z2;
+    float dz_y = b0 * inv_z0 + b1 * inv_z1 - (b0 + b1) * inv_z2;
+    float dz_c = c0 * inv_z0 + c1 * inv_z1 + (1.0f - c0 - c1) * inv_z2;
+
+    for (int y = min_y; y <= max_y; y++) {
+        float py = y + 0.5f;
+        float* row = &m_inv_z[static_cast<size_t>(y) * m_cols];
+        for (int x = min_x; x <= max_x; x++) {
+            float px = x + 0.5f;
+            float w0 = a0 * px + b0 * py + c0;
+            float w1 = a1 * px + b1 * py + c1;
+            if (w0 < 0.0f || w1 < 0.0f || w0 + w1 > 1.0f) continue;
+
+            float inv_z = dz_x * px + dz_y * py + dz_c;
+            if (inv_z > row[x]) row[x] = inv_z;
+        }
+    }
+}
+
+bool DepthBuffer::visible(float x, float y, float inv_z) const {
+    if (!(x >= 0.0f && y >= 0.0f)) return true;
+    int cx = static_cast<int>(x) / m_cell;
+    int cy = static_cast<int>(y) / m_cell;
+    if (cx >= m_cols || cy >= m_rows) return true;
+
+    return inv_z * (1.0f + DEPTH_BIAS) >= m_inv_z[static_cast<size_t>(cy) * m_cols + cx];
+}
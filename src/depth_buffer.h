@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @brief Low-resolution z-buffer for hidden-line tests, one depth per CELL x CELL pixels.
+ *
+ * Faces are rasterized at cell centers and each cell keeps the nearest
+ * surface as 1/z, which interpolates linearly in screen space, so a point on
+ * an edge can be tested without going back to view space. An edge is only
+ * hidden when it is clearly behind the surface: edges lying on a face stay
+ * visible although the cell was sampled a few pixels away.
+ */
+class DepthBuffer {
+public:
+    static constexpr int DEFAULT_CELL = 4;
+
+    // Sized for a screen of width x height pixels; clears
+    void resize(int width, int height, int cell = DEFAULT_CELL);
+
+    // Every cell back to "nothing here"
+    void clear();
+
+    // Screen positions in pixels with 1/z of each corner (z > 0, in front of the camera)
+    void add_triangle(float x0, float y0, float inv_z0, float x1, float y1, float inv_z1,
+                      float x2, float y2, float inv_z2);
+
+    // False if a surface lies in front of the point; points off the buffer are visible
+    bool visible(float x, float y, float inv_z) const;
+
+    int cell() const { return m_cell; }
+    bool empty() const { return m_inv_z.empty(); }
+
+private:
+    int m_cell = DEFAULT_CELL;
+    int m_cols = 0;
+    int m_rows = 0;
+    std::vector<float> m_inv_z; // Row-major, 0 = empty (infinitely far)
+};
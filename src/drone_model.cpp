@@ -0,0 +1,87 @@
+#include "drone_model.h"
+#include <vector>
+#include "airframe.h"
+#include "mesh.h"
+#include "mesh_lod.h"
+
+namespace {
+    const SDL_FColor SOLID_COLOR = { 0.1f, 0.65f, 0.1f, 1.0f };
+
+    // One frame type; every table it draws is constant data (Airframe)
+    template <FrameType TYPE>
+    void draw_airframe(RenderEngine& engine, const RenderEngine::Pose& pose) {
+        using Frame = Airframe<TYPE>;
+        float screen_scale = (float)engine.get_height() / 1000.0f;
+
+        // Hidden-line and solid mode: the solid parts go into the depth buffer before any line is drawn
+        if (engine.hidden_line_removal() || engine.solid_mode()) {
+            engine.clear_depth();
+            engine.add_occluder(Frame::body, pose);
+            engine.add_occluder(Frame::motors, pose);
+        }
+
+        // Solid mode: shaded body and motors replace their wireframe; arrow and arms stay lines
+        if (engine.solid_mode()) {
+            engine.add_solid(Frame::body, pose, SOLID_COLOR);
+            engine.add_solid(Frame::motors, pose, SOLID_COLOR);
+            engine.draw_solids();
+        } else {
+            engine.draw_mesh_edges(Frame::body, pose, 2.0f * screen_scale);
+        }
+
+        engine.draw_mesh_edges(Frame::arrow, pose, 6.0f * screen_scale);
+        engine.draw_mesh_edges(Frame::arms, pose, 15.0f * screen_scale);
+        if (!engine.solid_mode()) {
+            engine.draw_mesh_edges(Frame::motors, pose, 1.5f * screen_scale);
+
+            // Top and bottom rings, as many segments as their size on screen needs
+            const float r = airframe::MOTOR_RADIUS, h = airframe::MOTOR_HALF_HEIGHT;
+            const RenderEngine::Point_3D u = {r, 0.0f, 0.0f}, v = {0.0f, 0.0f, r};
+            for (const auto& m : Frame::motor_centers) {
+                engine.draw_circle(pose, {m.x, m.y + h, m.z}, u, v, 1.5f * screen_scale);
+                engine.draw_circle(pose, {m.x, m.y - h, m.z}, u, v, 1.5f * screen_scale);
+            }
+        }
+    }
+}
+
+math3d::Quatf attitude_orientation(const DroneTelemetry& attitude) {
+    // Roll tilts around the model's Z axis, pitch around X, yaw around Y; applied in that order
+    const float to_radians = static_cast<float>(math3d::PI / 180.0);
+    return math3d::quat_from_euler(static_cast<float>(attitude.roll) * to_radians, static_cast<float>(attitude.pitch) * to_radians,
+                                   static_cast<float>(attitude.yaw) * to_radians);
+}
+
+void draw_drone_with_engine(RenderEngine& engine, float delta_x, float delta_y, float delta_z, const math3d::Quatf& attitude, FrameType frame) {
+    RenderEngine::Pose pose({delta_x, delta_y, delta_z}, attitude);
+
+    switch (frame) {
+    case FrameType::QuadX: draw_airframe<FrameType::QuadX>(engine, pose); break;
+    case FrameType::QuadPlus: draw_airframe<FrameType::QuadPlus>(engine, pose); break;
+    case FrameType::Hex: draw_airframe<FrameType::Hex>(engine, pose); break;
+    case FrameType::Octo: draw_airframe<FrameType::Octo>(engine, pose); break;
+    case FrameType::X8: draw_airframe<FrameType::X8>(engine, pose); break;
+    }
+}
+
+void draw_model_with_engine(RenderEngine& engine, const MeshLod& lod, float delta_x, float delta_y, float delta_z, const math3d::Quatf& attitude) {
+    float screen_scale = (float)engine.get_height() / 1000.0f;
+    RenderEngine::Pose pose({delta_x, delta_y, delta_z}, attitude);
+    size_t level = engine.select_lod(lod, pose);
+    const Mesh& model = lod.mesh(level);
+
+    if (engine.hidden_line_removal() && !engine.solid_mode()) {
+        engine.clear_depth();
+        engine.add_occluder(model, pose);
+    }
+
+    if (engine.solid_mode()) {
+        engine.add_solid(model, pose, SOLID_COLOR);
+        engine.draw_solids();
+    } else {
+        // Per thread: offline workers draw the same model concurrently
+        thread_local std::vector<RenderEngine::Edge> edges;
+        lod.features(level).collect(engine.camera_in_model(pose), edges);
+        engine.draw_mesh_edges(model, edges.data(), edges.size(), pose, 1.5f * screen_scale);
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "airframe.h"
+#include "math3d.h"
+#include "render_engine.h"
+#include "telemetry.h"
+
+class MeshLod;
+
+// Largest side of the built-in quad X (motor to motor); loaded models are fitted to it
+constexpr float DRONE_MODEL_SIZE = 1.5f;
+
+// Flight controller attitude (degrees) as the model's orientation; once per sample, then only blended
+math3d::Quatf attitude_orientation(const DroneTelemetry& attitude);
+
+/**
+ * @brief Draws a built-in airframe (body, front arrow, arms and motors) at the given attitude.
+ *
+ * delta_x / delta_y / delta_z place the model in world space (z is the
+ * distance from the camera); attitude turns it (attitude_orientation).
+ * Everything is drawn through the engine, so it works on the window
+ * renderer and on the offline software renderers alike. With the engine's
+ * hidden-line mode on, the body and motor cylinders hide the lines behind
+ * them; in solid mode they are drawn as shaded surfaces. frame picks the
+ * layout (airframe.h), whose geometry was generated at compile time.
+ */
+void draw_drone_with_engine(RenderEngine& engine, float delta_x, float delta_y, float delta_z, const math3d::Quatf& attitude,
+                            FrameType frame = FrameType::QuadX);
+
+/**
+ * @brief Same, for a loaded airframe (ModelLoader) in place of the built-in one.
+ *
+ * The model should already be fitted to the built-in drone's size
+ * (ModelLoader::fit with DRONE_MODEL_SIZE). The level of detail is chosen per
+ * call from its size on screen (RenderEngine::select_lod). Solid mode draws
+ * its faces, otherwise its feature and silhouette edges.
+ */
+void draw_model_with_engine(RenderEngine& engine, const MeshLod& model, float delta_x, float delta_y, float delta_z, const math3d::Quatf& attitude);
@@ -0,0 +1,136 @@
+#include "feature_edges.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+#include "logger.h"
+#include "mesh.h"
+
+namespace {
+    constexpr uint32_t NO_FACE = UINT32_MAX;
+}
+
+void FeatureEdges::build(const Mesh& mesh, float crease_degrees) {
+    auto start = std::chrono::steady_clock::now();
+    m_features.clear();
+    m_candidates.clear();
+    m_candidate_faces.clear();
+
+    // 1. Face planes
+    compute_planes(mesh);
+
+    // 2. Edge lookup: edges bucketed by their lower vertex (counting sort)
+    const size_t vertex_count = mesh.vertices.size();
+    const size_t edge_count = mesh.edges.size();
+    std::vector<uint32_t> bucket(vertex_count + 1, 0);
+    for (const RenderEngine::Edge& e : mesh.edges) bucket[std::min(e.start, e.end) + 1]++;
+    for (size_t v = 0; v < vertex_count; v++) bucket[v + 1] += bucket[v];
+
+    std::vector<uint32_t> fill(bucket.begin(), bucket.end() - 1);
+    std::vector<uint32_t> bucket_edges(edge_count);
+    for (size_t i = 0; i < edge_count; i++) {
+        const RenderEngine::Edge& e = mesh.edges[i];
+        bucket_edges[fill[std::min(e.start, e.end)]++] = static_cast<uint32_t>(i);
+    }
+    std::vector<uint32_t>().swap(fill);
+
+    auto find_edge = [&](int a, int b) {
+        int lo = std::min(a, b), hi = std::max(a, b);
+        for (uint32_t k = bucket[lo]; k < bucket[lo + 1]; k++) {
+            const RenderEngine::Edge& e = mesh.edges[bucket_edges[k]];
+            if (std::max(e.start, e.end) == hi) return bucket_edges[k];
+        }
+        return NO_FACE; // A triangulation diagonal, not an edge of the model
+    };
+
+    // 3. The faces on either side of each edge; a third one makes it non-manifold
+    std::vector<uint32_t> first(edge_count, NO_FACE), second(edge_count, NO_FACE);
+    std::vector<uint8_t> face_count(edge_count, 0);
+    for (size_t f = 0; f < mesh.faces.size(); f++) {
+        const Mesh::Face& face = mesh.faces[f];
+        const int sides[3][2] = {{face.a, face.b}, {face.b, face.c}, {face.c, face.a}};
+        for (const auto& side : sides) {
+            uint32_t e = find_edge(side[0], side[1]);
+            if (e == NO_FACE) continue;
+            if (face_count[e] == 0) first[e] = static_cast<uint32_t>(f);
+            if (face_count[e] == 1) second[e] = static_cast<uint32_t>(f);
+            if (face_count[e] < 3) face_count[e]++;
+        }
+    }
+
+    // 4. Classify
+    const float crease_cos = std::cos(crease_degrees * 3.14159265f / 180.0f);
+    size_t creases = 0, boundaries = 0;
+    for (size_t i = 0; i < edge_count; i++) {
+        const RenderEngine::Edge& e = mesh.edges[i];
+        if (face_count[i] != 2) {
+            boundaries += face_count[i] == 1;
+            m_features.push_back(e);
+            continue;
+        }
+
+        const Plane& p0 = m_planes[first[i]];
+        const Plane& p1 = m_planes[second[i]];
+        if (p0.nx * p1.nx + p0.ny * p1.ny + p0.nz * p1.nz < crease_cos) {
+            creases++;
+            m_features.push_back(e);
+        } else {
+            m_candidates.push_back(e);
+            m_candidate_faces.push_back(first[i]);
+            m_candidate_faces.push_back(second[i]);
+        }
+    }
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("[Model] Feature edges: %zu of %zu (%zu creases over %.0f deg, %zu boundary), "
+             "%zu silhouette candidates, in %.1f ms",
+             m_features.size(), edge_count, creases, crease_degrees, boundaries, m_candidates.size(), ms.count());
+}
+
+void FeatureEdges::assign(const Mesh& mesh, std::vector<RenderEngine::Edge> features,
+                          std::vector<RenderEngine::Edge> candidates, std::vector<uint32_t> candidate_faces) {
+    m_features = std::move(features);
+    m_candidates = std::move(candidates);
+    m_candidate_faces = std::move(candidate_faces);
+    compute_planes(mesh);
+}
+
+void FeatureEdges::compute_planes(const Mesh& mesh) {
+    m_planes.clear();
+    m_planes.reserve(mesh.faces.size());
+    for (size_t f = 0; f < mesh.faces.size(); f++) {
+        const RenderEngine::Point_3D& a = mesh.vertices[mesh.faces[f].a];
+        const RenderEngine::Point_3D& b = mesh.vertices[mesh.faces[f].b];
+        const RenderEngine::Point_3D& c = mesh.vertices[mesh.faces[f].c];
+        float ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+        float vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+        float nx = uy * vz - uz * vy;
+        float ny = uz * vx - ux * vz;
+        float nz = ux * vy - uy * vx;
+        float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+        float inv = length > 0.0f ? 1.0f / length : 0.0f;
+        nx *= inv;
+        ny *= inv;
+        nz *= inv;
+        m_planes.push_back({nx, ny, nz, nx * a.x + ny * a.y + nz * a.z});
+    }
+}
+
+void FeatureEdges::collect(const RenderEngine::Point_3D& camera, std::vector<RenderEngine::Edge>& out) const {
+    out.assign(m_features.begin(), m_features.end());
+
+    // Which side of each face the camera is on, in one pass over the planes. Per thread: the
+    // offline workers share this object.
+    thread_local std::vector<uint8_t> front;
+    front.resize(m_planes.size());
+    for (size_t f = 0; f < m_planes.size(); f++) {
+        const Plane& p = m_planes[f];
+        front[f] = p.nx * camera.x + p.ny * camera.y + p.nz * camera.z > p.d;
+    }
+
+    // Silhouette: the camera is in front of one face and behind the other
+    const uint32_t* faces = m_candidate_faces.data();
+    for (size_t i = 0; i < m_candidates.size(); i++) {
+        if (front[faces[2 * i]] != front[faces[2 * i + 1]]) out.push_back(m_candidates[i]);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "render_engine.h"
+
+struct Mesh;
+
+/**
+ * @brief The few edges of a dense mesh worth drawing as a wireframe: features plus the current silhouette.
+ *
+ * build() runs once per mesh. It finds the faces on either side of every
+ * edge and keeps as features the boundary edges (one face), creases (the
+ * faces meet at more than the crease angle), non-manifold edges (three or
+ * more faces) and lines without faces. The remaining smooth edges only matter
+ * where the surface turns away from the camera: collect() adds those whose two
+ * faces point to different sides of it, one plane test per face per frame.
+ *
+ * A CAD export with hundreds of thousands of triangles comes down to its
+ * outline and sharp edges, like the hand-built drone.
+ */
+class FeatureEdges {
+public:
+    static constexpr float DEFAULT_CREASE_DEGREES = 30.0f;
+
+    void build(const Mesh& mesh, float crease_degrees = DEFAULT_CREASE_DEGREES);
+
+    // Features and this view's silhouette edges into out (replaced); camera in the mesh's coordinates
+    // (RenderEngine::camera_in_model). Const, so threads can share one FeatureEdges.
+    void collect(const RenderEngine::Point_3D& camera, std::vector<RenderEngine::Edge>& out) const;
+
+    size_t feature_count() const { return m_features.size(); }
+    size_t candidate_count() const { return m_candidates.size(); } // Smooth edges tested for silhouettes
+
+    // The classification as stored in a mesh cache (MeshLod::save), and restoring it for the same mesh
+    // without building the adjacency again: two faces per candidate in candidate_faces
+    const std::vector<RenderEngine::Edge>& features() const { return m_features; }
+    const std::vector<RenderEngine::Edge>& candidates() const { return m_candidates; }
+    const std::vector<uint32_t>& candidate_faces() const { return m_candidate_faces; }
+    void assign(const Mesh& mesh, std::vector<RenderEngine::Edge> features, std::vector<RenderEngine::Edge> candidates,
+                std::vector<uint32_t> candidate_faces);
+
+private:
+    // Face plane, unit normal: n . p - d > 0 means p sees the face's front
+    struct Plane {
+        float nx, ny, nz, d;
+    };
+
+    void compute_planes(const Mesh& mesh);
+
+    std::vector<RenderEngine::Edge> m_features;
+    std::vector<RenderEngine::Edge> m_candidates;
+    // The two faces of each candidate, apart from the edges: the per-frame scan reads only these,
+    // the edges just for the few silhouettes found
+    std::vector<uint32_t> m_candidate_faces;
+    std::vector<Plane> m_planes; // Per face
+};
@@ -0,0 +1,170 @@
+#include "frame_capture.h"
+#include <algorithm>
+#include <cstring>
+#include "logger.h"
+#include "telemetry.h"
+
+namespace {
+    // Leave the other half of the cores to the render and telemetry threads
+    unsigned convert_threads() {
+        return std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+}
+
+FrameCapture::FrameCapture(const std::string& path, Options options)
+    : m_path(path),
+      m_options(options),
+      m_interval_us(1000000 / std::max(options.fps, 1)),
+      m_convert_pool(convert_threads()) {
+    size_t depth = std::max<size_t>(m_options.queue_depth, 1);
+    for (size_t i = 0; i < depth; i++) {
+        m_pool.push_back(std::make_unique<Frame>());
+        m_free.push_back(m_pool.back().get());
+    }
+    m_writer = std::thread(&FrameCapture::writer_loop, this);
+    LOG_INFO("[Capture] Recording to %s at %d FPS", m_path, std::max(m_options.fps, 1));
+}
+
+FrameCapture::~FrameCapture() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_writer.joinable()) m_writer.join();
+
+    if (m_failed) {
+        LOG_ERROR("[Capture] %s is incomplete: writing failed after %llu frames", m_path,
+                  static_cast<unsigned long long>(m_video.frames_written()));
+    } else {
+        LOG_INFO("[Capture] %llu frames written to %s, %llu dropped",
+                 static_cast<unsigned long long>(m_video.frames_written()), m_path,
+                 static_cast<unsigned long long>(dropped()));
+    }
+}
+
+void FrameCapture::capture(SDL_Renderer* renderer) {
+    // Only at the capture rate; after a long stall resume from now instead of catching up
+    int64_t now = telemetry_now_us();
+    if (now < m_next_capture_us) return;
+    m_next_capture_us = std::max(m_next_capture_us, now - m_interval_us / 2) + m_interval_us;
+
+    // Take a buffer before reading back, so a dropped frame costs nothing
+    Frame* frame = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_failed) return;
+        if (m_free.empty() && m_options.policy == Policy::Block) {
+            m_cv.wait(lock, [this] { return !m_free.empty() || m_failed; });
+            if (m_failed) return;
+        }
+        if (m_free.empty()) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            LOG_WARN_EVERY(1, "[Capture] Writer behind, frame dropped");
+            return;
+        }
+        frame = m_free.back();
+        m_free.pop_back();
+    }
+
+    SDL_Surface* surface = SDL_RenderReadPixels(renderer, nullptr);
+    bool ok = surface != nullptr;
+    if (ok) {
+        // Straight row copy; the pixel format conversion happens on the writer thread
+        size_t row_bytes = static_cast<size_t>(surface->w) * SDL_BYTESPERPIXEL(surface->format);
+        frame->width = surface->w;
+        frame->height = surface->h;
+        frame->pitch = row_bytes;
+        frame->format = surface->format;
+        frame->pixels.resize(row_bytes * surface->h); // Only allocates when the window grew
+
+        const uint8_t* src = static_cast<const uint8_t*>(surface->pixels);
+        if (static_cast<size_t>(surface->pitch) == row_bytes) {
+            std::memcpy(frame->pixels.data(), src, row_bytes * surface->h);
+        } else {
+            for (int y = 0; y < surface->h; y++) {
+                std::memcpy(frame->pixels.data() + y * row_bytes, src + static_cast<size_t>(y) * surface->pitch, row_bytes);
+            }
+        }
+        SDL_DestroySurface(surface);
+    } else {
+        LOG_WARN_EVERY(1, "[Capture] SDL_RenderReadPixels failed: %s", SDL_GetError());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ok) {
+            m_pending.push_back(frame);
+        } else {
+            m_free.push_back(frame);
+        }
+    }
+    if (ok) {
+        m_captured.fetch_add(1, std::memory_order_relaxed);
+        m_cv.notify_all();
+    }
+}
+
+void FrameCapture::writer_loop() {
+    while (true) {
+        Frame* frame = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+            if (m_pending.empty()) break; // Stopped and drained
+            frame = m_pending.front();
+            m_pending.pop_front();
+        }
+
+        write_frame(*frame);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(frame);
+            if (!m_video.is_open()) {
+                // Nothing more will be written: make capture() a no-op instead of filling the queue
+                m_failed = true;
+            }
+        }
+        m_cv.notify_all();
+    }
+
+    if (!m_video.close()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failed = true;
+    }
+}
+
+void FrameCapture::write_frame(const Frame& frame) {
+    if (!m_video.is_open()) {
+        if (m_video.frames_written() > 0 || !m_video.open(m_path, frame.width, frame.height, m_options.fps)) return;
+    }
+
+    // Whatever the renderer reads back in, the encoders take RGBA32
+    size_t rgba_pitch = static_cast<size_t>(frame.width) * 4;
+    m_rgba.resize(rgba_pitch * frame.height);
+    if (!SDL_ConvertPixels(frame.width, frame.height, frame.format, frame.pixels.data(), static_cast<int>(frame.pitch),
+                           SDL_PIXELFORMAT_RGBA32, m_rgba.data(), static_cast<int>(rgba_pitch))) {
+        LOG_WARN_EVERY(1, "[Capture] Pixel conversion failed: %s", SDL_GetError());
+        return;
+    }
+
+    int out_w = m_video.width();
+    int out_h = m_video.height();
+    if (frame.width == out_w && frame.height == out_h) {
+        m_video.write_frame(m_rgba.data(), rgba_pitch, &m_convert_pool);
+        return;
+    }
+
+    // Window was resized: keep the top-left corner, pad with opaque black
+    size_t out_pitch = static_cast<size_t>(out_w) * 4;
+    m_fitted.assign(out_pitch * out_h, 0);
+    for (size_t i = 3; i < m_fitted.size(); i += 4) m_fitted[i] = 255;
+
+    size_t copy_bytes = static_cast<size_t>(std::min(frame.width, out_w)) * 4;
+    int copy_rows = std::min(frame.height, out_h);
+    for (int y = 0; y < copy_rows; y++) {
+        std::memcpy(m_fitted.data() + y * out_pitch, m_rgba.data() + y * rgba_pitch, copy_bytes);
+    }
+    m_video.write_frame(m_fitted.data(), out_pitch, &m_convert_pool);
+}
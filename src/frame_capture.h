@@ -0,0 +1,96 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "thread_pool.h"
+#include "video_writer.h"
+
+/**
+ * @brief Records the rendered view to a video file without slowing the render loop down.
+ *
+ * capture() runs on the render thread between drawing and SDL_RenderPresent:
+ * it reads the frame back with SDL_RenderReadPixels and copies it into a
+ * buffer from a fixed pool. A writer thread converts and encodes the queued
+ * frames (VideoWriter: Y4M or QOI sequence) and returns the buffers.
+ *
+ * Frames are taken at the capture rate (default 60 FPS), not at the render
+ * rate. Queue depth is bounded by the pool size; when the writer falls behind
+ * the Drop policy skips frames (counted) so the live view keeps its frame
+ * rate, the Block policy waits for a buffer so the file has every frame.
+ *
+ * The output size is fixed by the first frame; later frames of a different
+ * size (window resized) are cropped or padded with black.
+ */
+class FrameCapture {
+public:
+    enum class Policy {
+        Drop,  // Never stall the render loop, skip frames instead
+        Block  // Never skip frames, stall the render loop instead
+    };
+
+    struct Options {
+        int fps = 60;
+        size_t queue_depth = 6; // Frames buffered between the render and the writer thread
+        Policy policy = Policy::Drop;
+    };
+
+    FrameCapture(const std::string& path, Options options);
+    explicit FrameCapture(const std::string& path) : FrameCapture(path, Options{}) {}
+
+    // Writes every queued frame and closes the file
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Render thread: call after drawing, before SDL_RenderPresent
+    void capture(SDL_Renderer* renderer);
+
+    uint64_t captured() const { return m_captured.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Frame {
+        std::vector<uint8_t> pixels; // Rows exactly as read back, in the renderer's pixel format
+        int width = 0;
+        int height = 0;
+        size_t pitch = 0;
+        SDL_PixelFormat format = SDL_PIXELFORMAT_UNKNOWN;
+    };
+
+    void writer_loop();
+    void write_frame(const Frame& frame);
+
+    std::string m_path;
+    Options m_options;
+    int64_t m_interval_us;
+    int64_t m_next_capture_us = 0; // Render thread only
+
+    std::vector<std::unique_ptr<Frame>> m_pool;
+
+    // Shared with the writer thread
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Frame*> m_pending;
+    std::vector<Frame*> m_free;
+    bool m_stop = false;
+    bool m_failed = false;
+
+    // Writer thread only
+    std::thread m_writer;
+    VideoWriter m_video;
+    ThreadPool m_convert_pool;         // Splits the Y4M color conversion
+    std::vector<uint8_t> m_rgba;       // Frame converted to RGBA32
+    std::vector<uint8_t> m_fitted;     // Cropped / padded to the output size
+
+    std::atomic<uint64_t> m_captured{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
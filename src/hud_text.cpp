@@ -0,0 +1,133 @@
+#include "hud_text.h"
+#include "logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+    // ASCII 0..127 as a 16 x 8 grid of glyphs
+    constexpr int ATLAS_COLUMNS = 16;
+    constexpr int ATLAS_ROWS = 8;
+    constexpr float ATLAS_WIDTH = ATLAS_COLUMNS * HudText::GLYPH_SIZE;
+    constexpr float ATLAS_HEIGHT = ATLAS_ROWS * HudText::GLYPH_SIZE;
+}
+
+HudText::HudText(SDL_Renderer* renderer) : m_renderer(renderer) {}
+
+HudText::~HudText() {
+    if (m_atlas != nullptr) SDL_DestroyTexture(m_atlas);
+}
+
+bool HudText::build_atlas() {
+    m_atlas = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                static_cast<int>(ATLAS_WIDTH), static_cast<int>(ATLAS_HEIGHT));
+    if (m_atlas == nullptr) {
+        LOG_WARN("[HUD] No render target support, falling back to debug text: %s", SDL_GetError());
+        m_atlas_failed = true;
+        return false;
+    }
+    SDL_SetTextureBlendMode(m_atlas, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(m_atlas, SDL_SCALEMODE_NEAREST); // Keep the pixel font crisp when scaled
+
+    // Render every printable glyph once, white on transparent; vertex colors tint it later
+    SDL_Texture* previous_target = SDL_GetRenderTarget(m_renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(m_renderer, &r, &g, &b, &a);
+
+    SDL_SetRenderTarget(m_renderer, m_atlas);
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
+    SDL_RenderClear(m_renderer);
+    SDL_SetRenderDrawColor(m_renderer, 255, 255, 255, 255);
+    for (int c = ' ' + 1; c < 127; c++) {
+        char glyph[2] = {static_cast<char>(c), '\0'};
+        SDL_RenderDebugText(m_renderer, static_cast<float>((c % ATLAS_COLUMNS) * GLYPH_SIZE),
+                            static_cast<float>((c / ATLAS_COLUMNS) * GLYPH_SIZE), glyph);
+    }
+
+    SDL_SetRenderTarget(m_renderer, previous_target);
+    SDL_SetRenderDrawColor(m_renderer, r, g, b, a);
+    return true;
+}
+
+void HudText::invalidate() {
+    if (m_atlas != nullptr) SDL_DestroyTexture(m_atlas);
+    m_atlas = nullptr;
+    m_atlas_failed = false;
+}
+
+void HudText::text(float x, float y, std::string_view str, SDL_FColor color, float scale) {
+    if (m_atlas == nullptr && !m_atlas_failed) build_atlas();
+
+    if (m_atlas_failed) {
+        SDL_SetRenderDrawColorFloat(m_renderer, color.r, color.g, color.b, color.a);
+        std::string line(str);
+        SDL_RenderDebugText(m_renderer, x, y, line.c_str());
+        return;
+    }
+
+    float size = GLYPH_SIZE * scale;
+    float pen_x = x;
+    for (char ch : str) {
+        if (ch == '\n') {
+            pen_x = x;
+            y += size;
+            continue;
+        }
+
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (c > ' ' && c < 127) {
+            if ((m_quads + 1) * 4 > m_vertices.size()) m_vertices.resize(std::max<size_t>(256, m_vertices.size() * 2));
+            if ((m_quads + 1) * 6 > m_indices.size()) {
+                // Same two triangles for every quad, only extended when the buffer grows
+                size_t first = m_indices.size() / 6;
+                m_indices.resize(m_vertices.size() / 4 * 6);
+                for (size_t q = first; q < m_indices.size() / 6; q++) {
+                    int v = static_cast<int>(q * 4);
+                    int* idx = &m_indices[q * 6];
+                    idx[0] = v; idx[1] = v + 1; idx[2] = v + 2;
+                    idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+                }
+            }
+
+            float u0 = (c % ATLAS_COLUMNS) * GLYPH_SIZE / ATLAS_WIDTH;
+            float v0 = (c / ATLAS_COLUMNS) * GLYPH_SIZE / ATLAS_HEIGHT;
+            float u1 = u0 + GLYPH_SIZE / ATLAS_WIDTH;
+            float v1 = v0 + GLYPH_SIZE / ATLAS_HEIGHT;
+
+            SDL_Vertex* v = &m_vertices[m_quads * 4];
+            v[0] = {{pen_x, y}, color, {u0, v0}};
+            v[1] = {{pen_x, y + size}, color, {u0, v1}};
+            v[2] = {{pen_x + size, y}, color, {u1, v0}};
+            v[3] = {{pen_x + size, y + size}, color, {u1, v1}};
+            m_quads++;
+        }
+        pen_x += size;
+    }
+}
+
+void HudText::flush() {
+    if (m_quads == 0) return;
+    if (m_atlas == nullptr && (m_atlas_failed || !build_atlas())) {
+        m_quads = 0;
+        return;
+    }
+
+    SDL_RenderGeometry(m_renderer, m_atlas, m_vertices.data(), static_cast<int>(m_quads * 4),
+                       m_indices.data(), static_cast<int>(m_quads * 6));
+    m_quads = 0;
+}
+
+std::string_view CachedNumber::get(double value) {
+    // Only re-format when the value moved by at least one displayed step
+    double steps = value / m_step;
+    bool cacheable = std::isfinite(steps) && std::fabs(steps) < 9.0e18;
+    int64_t key = cacheable ? std::llround(steps) : INT64_MIN;
+
+    if (!cacheable || key != m_last || m_length == 0) {
+        int n = std::snprintf(m_text, sizeof(m_text), m_format, value);
+        m_length = (n < 0) ? 0 : std::min(static_cast<size_t>(n), sizeof(m_text) - 1);
+        m_last = key;
+    }
+    return std::string_view(m_text, m_length);
+}
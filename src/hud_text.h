@@ -0,0 +1,70 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief In-window text for the HUD, drawn from a glyph atlas in one geometry call per frame.
+ *
+ * The atlas is built once by rendering SDL's built-in 8x8 debug font into a
+ * target texture. text() only appends textured quads to a buffer; flush()
+ * submits every string queued this frame with a single SDL_RenderGeometry.
+ * Buffers keep their capacity, so steady-state frames allocate nothing.
+ *
+ * If the renderer cannot render to textures, text() falls back to
+ * SDL_RenderDebugText so the HUD still shows up.
+ */
+class HudText {
+public:
+    static constexpr int GLYPH_SIZE = SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
+
+    explicit HudText(SDL_Renderer* renderer);
+    ~HudText();
+
+    HudText(const HudText&) = delete;
+    HudText& operator=(const HudText&) = delete;
+
+    // Queues a string; (x, y) is the top-left corner, scale multiplies the 8 px glyphs
+    void text(float x, float y, std::string_view str, SDL_FColor color, float scale = 1.0f);
+
+    // Draws everything queued since the last flush
+    void flush();
+
+    // Call on SDL_EVENT_RENDER_TARGETS_RESET / SDL_EVENT_RENDER_DEVICE_RESET: the atlas contents are gone
+    void invalidate();
+
+private:
+    bool build_atlas();
+
+    SDL_Renderer* m_renderer;
+    SDL_Texture* m_atlas = nullptr;
+    bool m_atlas_failed = false;
+
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+    size_t m_quads = 0;
+};
+
+/**
+ * @brief A number formatted with snprintf only when its displayed value changes.
+ *
+ * Telemetry at 120 FPS mostly repeats the same digits; keeping the last
+ * string skips the formatting entirely on those frames.
+ */
+class CachedNumber {
+public:
+    // format is a printf format for one double (e.g. "%8.2f"), step the smallest displayed change (0.01)
+    CachedNumber(const char* format, double step) : m_format(format), m_step(step) {}
+
+    std::string_view get(double value);
+
+private:
+    const char* m_format;
+    double m_step;
+    int64_t m_last = INT64_MIN; // value / step of the cached string
+    char m_text[32] = {};
+    size_t m_length = 0;
+};
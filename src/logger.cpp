@@ -0,0 +1,229 @@
+#include "logger.h"
+#include <SDL3/SDL.h>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(10);
+
+    constexpr char LEVEL_LETTERS[] = {'T', 'D', 'I', 'W', 'E'};
+
+    bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+    // Formats one conversion of a stored record with snprintf.
+    // spec is the original "%-8.3" part (no length modifier, no conversion character).
+    void format_arg(std::string& line, std::string_view spec, char conversion,
+                    const LogRecord& record, const LogRecord::Arg& arg) {
+        using Type = LogRecord::ArgType;
+
+        char format[32];
+        char buffer[160];
+        int n = -1;
+        if (spec.size() > sizeof(format) - 4) spec = spec.substr(0, sizeof(format) - 4);
+
+        // Every integer was widened to 64 bits when captured, so the length modifier is always "ll"
+        auto make_format = [&](const char* length, char conv) {
+            std::snprintf(format, sizeof(format), "%.*s%s%c", static_cast<int>(spec.size()), spec.data(), length, conv);
+        };
+        auto as_int = [&]() -> long long {
+            if (arg.type == Type::Double) return static_cast<long long>(arg.d);
+            if (arg.type == Type::UInt) return static_cast<long long>(arg.u);
+            return arg.type == Type::Int ? arg.i : 0;
+        };
+        auto as_double = [&]() -> double {
+            if (arg.type == Type::Int) return static_cast<double>(arg.i);
+            if (arg.type == Type::UInt) return static_cast<double>(arg.u);
+            return arg.type == Type::Double ? arg.d : 0.0;
+        };
+
+        switch (conversion) {
+            case 'd': case 'i':
+                make_format("ll", 'd');
+                n = std::snprintf(buffer, sizeof(buffer), format, as_int());
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                make_format("ll", conversion);
+                n = std::snprintf(buffer, sizeof(buffer), format, static_cast<unsigned long long>(as_int()));
+                break;
+            case 'c':
+                make_format("", 'c');
+                n = std::snprintf(buffer, sizeof(buffer), format, static_cast<int>(as_int()));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                make_format("", conversion);
+                n = std::snprintf(buffer, sizeof(buffer), format, as_double());
+                break;
+            case 's':
+                make_format("", 's');
+                n = std::snprintf(buffer, sizeof(buffer), format,
+                                  arg.type == Type::String ? record.text + arg.text_offset : "<?>");
+                break;
+            case 'p':
+                make_format("", 'p');
+                n = std::snprintf(buffer, sizeof(buffer), format, arg.type == Type::Pointer ? arg.p : nullptr);
+                break;
+            default:
+                line += "<?>";
+                return;
+        }
+
+        if (n > 0) line.append(buffer, std::min(static_cast<size_t>(n), sizeof(buffer) - 1));
+    }
+
+    void SDLCALL sdl_log_output(void*, int, SDL_LogPriority priority, const char* message) {
+        LogLevel level = LogLevel::Info;
+        switch (priority) {
+            case SDL_LOG_PRIORITY_TRACE:
+            case SDL_LOG_PRIORITY_VERBOSE:  level = LogLevel::Trace; break;
+            case SDL_LOG_PRIORITY_DEBUG:    level = LogLevel::Debug; break;
+            case SDL_LOG_PRIORITY_WARN:     level = LogLevel::Warn; break;
+            case SDL_LOG_PRIORITY_ERROR:
+            case SDL_LOG_PRIORITY_CRITICAL: level = LogLevel::Error; break;
+            default: break;
+        }
+
+        static LogSite site(LogSite::DEFAULT_RATE);
+        Logger::instance().log(site, level, "[SDL] %s", message);
+    }
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : m_start_us(telemetry_now_us()) {
+    m_batch.reserve(LogQueue::CAPACITY * 4);
+    m_thread = std::thread(&Logger::drain_loop, this);
+}
+
+Logger::~Logger() {
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+    drain_once(); // Whatever came in after the last pass
+}
+
+void Logger::route_sdl_log() {
+    SDL_SetLogOutputFunction(sdl_log_output, nullptr);
+}
+
+LogQueue& Logger::thread_queue() {
+    // Each thread registers its own queue on first use; the queue outlives the
+    // thread until the drain thread has written what is left in it
+    struct Holder {
+        std::shared_ptr<LogQueue> queue;
+        ~Holder() {
+            if (queue) queue->orphaned = true;
+        }
+    };
+    thread_local Holder holder;
+
+    if (!holder.queue) {
+        holder.queue = std::make_shared<LogQueue>();
+        std::lock_guard<std::mutex> lock(m_queues_mutex);
+        m_queues.push_back(holder.queue);
+    }
+    return *holder.queue;
+}
+
+void Logger::flush() {
+    drain_once();
+}
+
+void Logger::drain_loop() {
+    while (m_running) {
+        std::this_thread::sleep_for(DRAIN_INTERVAL);
+        drain_once();
+    }
+}
+
+void Logger::drain_once() {
+    std::lock_guard<std::mutex> drain_lock(m_drain_mutex);
+
+    m_batch.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_queues_mutex);
+        for (auto& queue : m_queues) queue->drain(m_batch);
+
+        // Threads that exited and whose last records are now in the batch
+        std::erase_if(m_queues, [](const std::shared_ptr<LogQueue>& queue) {
+            return queue->orphaned && queue->empty();
+        });
+    }
+
+    // Queues are per thread: restore the global order
+    std::stable_sort(m_batch.begin(), m_batch.end(),
+        [](const LogRecord& a, const LogRecord& b) { return a.timestamp_us < b.timestamp_us; });
+
+    std::string line;
+    for (const LogRecord& record : m_batch) write_record(record, line);
+
+    uint64_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::fflush(stdout);
+        std::fprintf(stderr, "%9.3f W [Log] %llu messages dropped (queue full)\n",
+                     (telemetry_now_us() - m_start_us) / 1e6, static_cast<unsigned long long>(dropped));
+    }
+
+    if (!m_batch.empty() || dropped > 0) {
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+}
+
+void Logger::write_record(const LogRecord& record, std::string& line) {
+    char prefix[32];
+    int level = static_cast<int>(record.level);
+    std::snprintf(prefix, sizeof(prefix), "%9.3f %c ", (record.timestamp_us - m_start_us) / 1e6,
+                  LEVEL_LETTERS[std::min(level, DRONE_LOG_ERROR)]);
+    line = prefix;
+
+    // printf interpreter over the stored arguments: literal runs are copied,
+    // each conversion is handed to snprintf on its own with the matching argument
+    const char* f = record.format;
+    int next_arg = 0;
+    while (*f != '\0') {
+        if (*f != '%') {
+            const char* run = f;
+            while (*f != '\0' && *f != '%') f++;
+            line.append(run, f - run);
+            continue;
+        }
+        if (f[1] == '%') {
+            line += '%';
+            f += 2;
+            continue;
+        }
+
+        const char* spec = f++;
+        while (*f == '-' || *f == '+' || *f == ' ' || *f == '#' || *f == '0') f++;
+        while (is_digit(*f)) f++;
+        if (*f == '.') {
+            f++;
+            while (is_digit(*f)) f++;
+        }
+        std::string_view spec_text(spec, f - spec);
+        while (*f == 'h' || *f == 'l' || *f == 'L' || *f == 'q' || *f == 'j' || *f == 'z' || *f == 't') f++;
+        if (*f == '\0') break;
+        char conversion = *f++;
+
+        if (next_arg >= record.arg_count) {
+            line += "<?>";
+            continue;
+        }
+        format_arg(line, spec_text, conversion, record, record.args[next_arg++]);
+    }
+
+    if (record.suppressed > 0) {
+        char note[48];
+        std::snprintf(note, sizeof(note), " (%u similar suppressed)", record.suppressed);
+        line += note;
+    }
+    line += '\n';
+
+    // stdout is buffered and stderr is not: flush on every switch so the terminal keeps the order
+    FILE* stream = record.level >= LogLevel::Warn ? stderr : stdout;
+    if (stream != m_last_stream && m_last_stream != nullptr) std::fflush(m_last_stream);
+    m_last_stream = stream;
+    std::fwrite(line.data(), 1, line.size(), stream);
+}
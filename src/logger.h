@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "telemetry.h"
+
+/**
+ * @brief Asynchronous logger: the calling thread never formats, never locks and never touches the terminal.
+ *
+ * A log call copies the format string pointer and its raw arguments into the
+ * calling thread's own single-producer ring (registered on first use) and
+ * returns. A drain thread collects the rings every few milliseconds, formats
+ * the records printf-style, orders them by time and writes them out. If a ring
+ * is full the record is dropped and counted rather than waiting.
+ *
+ * Use the LOG_* macros below. Levels under DRONE_LOG_LEVEL compile to nothing.
+ * Every call site is rate-limited on its own (LogSite), so a flaky serial link
+ * logging the same warning thousands of times a second prints a few lines and
+ * a "suppressed" count instead.
+ *
+ * Formats must be string literals; strings passed as arguments are copied.
+ */
+
+#define DRONE_LOG_TRACE 0
+#define DRONE_LOG_DEBUG 1
+#define DRONE_LOG_INFO  2
+#define DRONE_LOG_WARN  3
+#define DRONE_LOG_ERROR 4
+#define DRONE_LOG_OFF   5
+
+// Compile-time filter; override with -DDRONE_LOG_LEVEL=DRONE_LOG_DEBUG (CMake: DRONE_LOG_LEVEL)
+#ifndef DRONE_LOG_LEVEL
+    #define DRONE_LOG_LEVEL DRONE_LOG_INFO
+#endif
+
+enum class LogLevel : uint8_t {
+    Trace = DRONE_LOG_TRACE,
+    Debug = DRONE_LOG_DEBUG,
+    Info = DRONE_LOG_INFO,
+    Warn = DRONE_LOG_WARN,
+    Error = DRONE_LOG_ERROR
+};
+
+/**
+ * @brief Per-call-site rate limiter: at most `per_second` records per one second window.
+ * Lock-free; a few extra records can slip through when threads race the window reset.
+ */
+class LogSite {
+public:
+    static constexpr uint32_t DEFAULT_RATE = 20;
+
+    explicit constexpr LogSite(uint32_t per_second) : m_limit(per_second) {}
+
+    // True if this record may be logged; suppressed receives how many were dropped since the last one
+    bool allow(int64_t now_us, uint32_t& suppressed) {
+        int64_t start = m_window_start.load(std::memory_order_relaxed);
+        if (now_us - start >= 1000000 && m_window_start.compare_exchange_strong(start, now_us, std::memory_order_relaxed)) {
+            m_count.store(0, std::memory_order_relaxed);
+        }
+
+        if (m_count.fetch_add(1, std::memory_order_relaxed) < m_limit) {
+            suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+    uint32_t m_limit;
+    std::atomic<int64_t> m_window_start{INT64_MIN / 2};
+    std::atomic<uint32_t> m_count{0};
+    std::atomic<uint32_t> m_suppressed{0};
+};
+
+/**
+ * @brief One queued log call: the format pointer and raw arguments, formatted later by the drain thread.
+ */
+struct LogRecord {
+    static constexpr int MAX_ARGS = 8;
+    static constexpr size_t TEXT_CAPACITY = 104; // Copied string arguments share this buffer
+
+    enum class ArgType : uint8_t { Int, UInt, Double, String, Pointer };
+
+    struct Arg {
+        ArgType type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            uint32_t text_offset; // String: offset into text, NUL-terminated
+            const void* p;
+        };
+    };
+
+    int64_t timestamp_us;
+    const char* format;
+    uint32_t suppressed;
+    LogLevel level;
+    uint8_t arg_count;
+    uint8_t text_used;
+    Arg args[MAX_ARGS];
+    char text[TEXT_CAPACITY];
+
+    void add(bool v) { add_int(v ? 1 : 0); }
+    void add(char v) { add_int(v); }
+    void add(double v) {
+        Arg arg{ArgType::Double, {}};
+        arg.d = v;
+        push(arg);
+    }
+    void add(float v) { add(static_cast<double>(v)); }
+    void add(const char* v) { add_string(v != nullptr ? std::string_view(v) : std::string_view("(null)")); }
+    void add(const std::string& v) { add_string(v); }
+    void add(std::string_view v) { add_string(v); }
+    void add(const void* v) {
+        Arg arg{ArgType::Pointer, {}};
+        arg.p = v;
+        push(arg);
+    }
+
+    template <typename T>
+    requires std::is_integral_v<T>
+    void add(T v) {
+        if constexpr (std::is_signed_v<T>) {
+            add_int(v);
+        } else {
+            Arg arg{ArgType::UInt, {}};
+            arg.u = v;
+            push(arg);
+        }
+    }
+
+private:
+    void add_int(int64_t v) {
+        Arg arg{ArgType::Int, {}};
+        arg.i = v;
+        push(arg);
+    }
+
+    void add_string(std::string_view v) {
+        // Copied into the record's text buffer, truncated to whatever room is left
+        Arg arg{ArgType::String, {}};
+        size_t room = TEXT_CAPACITY - text_used;
+        if (room <= 1) {
+            arg.text_offset = TEXT_CAPACITY - 1; // Always the empty string
+            return push(arg);
+        }
+        size_t n = std::min(v.size(), room - 1);
+        std::memcpy(text + text_used, v.data(), n);
+        text[text_used + n] = '\0';
+        arg.text_offset = text_used;
+        text_used = static_cast<uint8_t>(text_used + n + 1);
+        push(arg);
+    }
+
+    void push(const Arg& arg) {
+        if (arg_count < MAX_ARGS) args[arg_count++] = arg;
+    }
+};
+
+/**
+ * @brief Single-producer / single-consumer ring of LogRecords, one per logging thread.
+ */
+class LogQueue {
+public:
+    static constexpr size_t CAPACITY = 512; // Power of two
+
+    // Producer: slot to fill, or nullptr when full
+    LogRecord* begin_write() {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= CAPACITY) return nullptr;
+        return &m_records[head % CAPACITY];
+    }
+    void commit() { m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer: appends everything queued to out
+    void drain(std::vector<LogRecord>& out) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) out.push_back(m_records[tail % CAPACITY]);
+        m_tail.store(tail, std::memory_order_release);
+    }
+
+    bool empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+
+    std::atomic<bool> orphaned{false}; // Owning thread exited; freed once drained
+
+private:
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+    LogRecord m_records[CAPACITY];
+};
+
+class Logger {
+public:
+    static Logger& instance();
+
+    template <typename... Args>
+    void log(LogSite& site, LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+        if (static_cast<int>(level) < DRONE_LOG_LEVEL) return; // Runtime levels (SDL callback)
+
+        int64_t now = telemetry_now_us();
+        uint32_t suppressed = 0;
+        if (!site.allow(now, suppressed)) return;
+
+        LogQueue& queue = thread_queue();
+        LogRecord* record = queue.begin_write();
+        if (record == nullptr) {
+            m_dropped.fetch_add(1 + suppressed, std::memory_order_relaxed);
+            return;
+        }
+
+        record->timestamp_us = now;
+        record->format = format;
+        record->suppressed = suppressed;
+        record->level = level;
+        record->arg_count = 0;
+        record->text_used = 0;
+        (record->add(args), ...);
+        queue.commit();
+    }
+
+    // Writes everything queued so far (blocks; for shutdown and fatal paths, not the hot path)
+    void flush();
+
+    // Sends SDL_Log output through this logger instead of straight to the console
+    static void route_sdl_log();
+
+    ~Logger();
+
+private:
+    Logger();
+
+    LogQueue& thread_queue();
+    void drain_loop();
+    void drain_once();
+    void write_record(const LogRecord& record, std::string& line);
+
+    std::mutex m_queues_mutex;
+    std::vector<std::shared_ptr<LogQueue>> m_queues;
+
+    std::mutex m_drain_mutex; // Serialises drain_once between the thread and flush()
+    std::vector<LogRecord> m_batch;
+    std::atomic<uint64_t> m_dropped{0};
+    int64_t m_start_us;
+    FILE* m_last_stream = nullptr; // Drain thread only
+
+    std::atomic<bool> m_running{true};
+    std::thread m_thread;
+};
+
+#define DRONE_LOG_AT(level, per_second, ...)                                   \
+    do {                                                                       \
+        if constexpr (static_cast<int>(level) >= DRONE_LOG_LEVEL) {            \
+            static LogSite drone_log_site_{per_second};                        \
+            Logger::instance().log(drone_log_site_, level, __VA_ARGS__);       \
+        }                                                                      \
+    } while (0)
+
+#define LOG_TRACE(...) DRONE_LOG_AT(LogLevel::Trace, LogSite::DEFAULT_RATE, __VA_ARGS__)
+#define LOG_DEBUG(...) DRONE_LOG_AT(LogLevel::Debug, LogSite::DEFAULT_RATE, __VA_ARGS__)
+#define LOG_INFO(...)  DRONE_LOG_AT(LogLevel::Info,  LogSite::DEFAULT_RATE, __VA_ARGS__)
+#define LOG_WARN(...)  DRONE_LOG_AT(LogLevel::Warn,  LogSite::DEFAULT_RATE, __VA_ARGS__)
+#define LOG_ERROR(...) DRONE_LOG_AT(LogLevel::Error, LogSite::DEFAULT_RATE, __VA_ARGS__)
+
+// Explicit per-site budget, e.g. LOG_WARN_EVERY(1, "[Serial] Checksum error") for one line per second
+#define LOG_WARN_EVERY(per_second, ...)  DRONE_LOG_AT(LogLevel::Warn,  per_second, __VA_ARGS__)
+#define LOG_ERROR_EVERY(per_second, ...) DRONE_LOG_AT(LogLevel::Error, per_second, __VA_ARGS__)
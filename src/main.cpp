@@ -1,108 +1,253 @@
 #include <SDL3/SDL.h>
-#include <iostream> 
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <numbers>
+#include <string>
+#include <utility>
+#include "blackbox_decoder.h"
+#include "drone_model.h"
+#include "frame_capture.h"
+#include "hud_text.h"
+#include "offline_render.h"
+#include "logger.h"
+#include "mapped_file.h"
+#include "mesh.h"
+#include "model_loader.h"
+#include "mesh_lod.h"
 #include "render_engine.h"
 #include "sdl_engine.h"
 #include "pythonManager.h"
+#include "session_recorder.h"
+#include "session_replay.h"
+#include "strip_chart.h"
+#include "telemetry_mailbox.h"
+#include "timeline_view.h"
 
 const int FPS = 120;
 
-void draw_drone_with_engine(RenderEngine& engine, float delta_x, float delta_y, float delta_z, float pitch_deg, float yaw_deg, float roll_deg) {
-    float width = (float)engine.get_width();
-    float height = (float)engine.get_height();
-    float aspect = width / height;
-    float screen_scale = height / 1000.0f; 
-    
-    float rad_pitch = engine.to_radians(pitch_deg);
-    float rad_yaw   = engine.to_radians(yaw_deg);
-    float rad_roll  = engine.to_radians(roll_deg);
-
-    auto transform = [&](RenderEngine::Point_3D p) {
-        // 1. Rotation (Local Space)
-        RenderEngine::Point_3D r = engine.rotate_roll(p, rad_roll);
-        r = engine.rotate_pitch(r, rad_pitch);
-        r = engine.rotate_yaw(r, rad_yaw);
-        
-        // 2. Translation (World Space)
-        // We add the offsets to move the object in the 3D world
-        r.x += delta_x;
-        r.y += delta_y;
-        r.z += delta_z; 
-
-        // 3. Projection & Aspect Correction
-        RenderEngine::Point_2D projected = engine.project(r);
-        projected.x /= aspect; 
-
-        return engine.screen(projected);
-    };
-
-    // --- REST OF THE DRAWING LOGIC REMAINS THE SAME ---
-    static const float base = 0.15f; 
-    static const float bw = base * 0.5f, bh = base * 0.3f, bl = base * 1.2f;
-    
-    // Body
-    RenderEngine::Point_3D body_local[8] = {
-        {bw,bh,bl}, {bw,-bh,bl}, {-bw,bh,bl}, {-bw,-bh,bl},
-        {bw,bh,-bl}, {bw,-bh,-bl}, {-bw,bh,-bl}, {-bw,-bh,-bl}
-    };
-    
-    RenderEngine::Point_2D body_screen[8];
-    for(int i=0; i<8; i++) body_screen[i] = transform(body_local[i]);
-
-    float body_thickness = 2.0f * screen_scale;
-    float arm_thickness = 15.0f * screen_scale;
-    float arrow_thickness = 6.0f * screen_scale; 
-    float ring_thickness = 1.5f * screen_scale;
-
-    static const int b_edges[12][2] = {{0,1},{2,3},{4,5},{6,7},{0,2},{2,6},{6,4},{4,0},{1,3},{3,7},{7,5},{5,1}};
-    for(const auto& e : b_edges) 
-        engine.draw_thick_line(body_screen[e[0]], body_screen[e[1]], body_thickness);
-
-    // Front Arrow (Center of front face)
-    RenderEngine::Point_2D arrow_base = transform({0.0f, 0.0f, bl});
-    RenderEngine::Point_2D arrow_tip  = transform({0.0f, 0.0f, bl + (base * 1.5f)});
-    RenderEngine::Point_2D arrow_left  = transform({-base * 0.4f, 0.0f, bl + (base * 0.8f)});
-    RenderEngine::Point_2D arrow_right = transform({base * 0.4f, 0.0f, bl + (base * 0.8f)});
-
-    engine.draw_thick_line(arrow_base, arrow_tip, arrow_thickness);
-    engine.draw_thick_line(arrow_tip, arrow_left, arrow_thickness);
-    engine.draw_thick_line(arrow_tip, arrow_right, arrow_thickness);
-
-    // Arms and Motors
-    RenderEngine::Point_2D center_screen = transform({0.0f, 0.0f, 0.0f});
-    static const RenderEngine::Point_3D motors[4] = {
-        {base*5, 0, base*3.5}, {-base*5, 0, base*3.5}, 
-        {base*5, 0, -base*3.5}, {-base*5, 0, -base*3.5}
-    };
-
-    for(int i=0; i<4; i++) {
-        RenderEngine::Point_2D m_pos = transform(motors[i]);
-        engine.draw_thick_line(center_screen, m_pos, arm_thickness);
-
-        for(int s=0; s<16; s++) {
-            float a1 = (float)s * (2.0f * M_PI / 16.0f);
-            float a2 = (float)(s+1) * (2.0f * M_PI / 16.0f);
-            auto get_ring_pt = [&](float angle, float h) {
-                return transform({
-                    motors[i].x + std::cos(angle) * (base * 0.5f), 
-                    motors[i].y + h * base, 
-                    motors[i].z + std::sin(angle) * (base * 0.5f)
-                });
-            };
-            engine.draw_thick_line(get_ring_pt(a1, 0.2f), get_ring_pt(a2, 0.2f), ring_thickness); 
-            engine.draw_thick_line(get_ring_pt(a1, -0.2f), get_ring_pt(a2, -0.2f), ring_thickness); 
-            engine.draw_thick_line(get_ring_pt(a1, 0.2f), get_ring_pt(a1, -0.2f), ring_thickness); 
+bool convert_blackbox(const std::string& log_path, const std::string& session_path) {
+    // Decodes every log in a blackbox file and writes them back to back as one session.
+    // Skipped when the converted file was made from this very log (same size and modification time).
+    session_format::SourceStamp source;
+    if (!session_format::source_stamp(log_path, source)) {
+        LOG_ERROR("Cannot open %s", log_path);
+        return false;
+    }
+    if (session_format::converted_from(session_path, source)) return true;
+
+    BlackboxDecoder decoder;
+    if (!decoder.decode_file(log_path)) return false;
+
+    // Time must strictly increase, the replay index relies on it. The FC clock is a 32-bit
+    // microsecond counter that wraps every ~71.6 minutes and restarts with every reboot, so
+    // wraps are unwrapped and every log is moved to start one sample period after the previous.
+    constexpr int64_t CLOCK_WRAP_US = int64_t(1) << 32;
+    std::vector<TelemetrySample> samples;
+    for (size_t i = 0; i < decoder.logs().size(); i++) {
+        const std::vector<TelemetrySample>& log_samples = decoder.logs()[i].samples;
+        if (log_samples.empty()) continue;
+
+        int64_t offset = 0;
+        if (!samples.empty() && log_samples.front().timestamp_us <= samples.back().timestamp_us) {
+            int64_t period = log_samples.size() > 1 ? log_samples[1].timestamp_us - log_samples[0].timestamp_us : 0;
+            if (period <= 0) period = 1000;
+            offset = samples.back().timestamp_us + period - log_samples.front().timestamp_us;
+            LOG_INFO("[Blackbox] Log %zu restarts the clock, moved by %+.3f s to follow log %zu", i + 1, offset / 1e6, i);
         }
+
+        size_t wraps = 0, dropped = 0;
+        int64_t previous = log_samples.front().timestamp_us;
+        for (TelemetrySample sample : log_samples) {
+            if (previous - sample.timestamp_us > CLOCK_WRAP_US / 2) {
+                offset += CLOCK_WRAP_US;
+                wraps++;
+            }
+            previous = sample.timestamp_us;
+            sample.timestamp_us += offset;
+
+            if (samples.empty() || sample.timestamp_us > samples.back().timestamp_us) {
+                samples.push_back(sample);
+            } else {
+                dropped++; // Time stepped back within the log: corruption the decoder did not catch
+            }
+        }
+        if (wraps > 0) LOG_INFO("[Blackbox] Log %zu: unwrapped the 32-bit clock %zu time(s)", i + 1, wraps);
+        if (dropped > 0) LOG_WARN("[Blackbox] Log %zu: dropped %zu samples whose time went backwards", i + 1, dropped);
+    }
+
+    if (!session_format::write_session(session_path, samples, source)) {
+        LOG_ERROR("Failed to write %s", session_path);
+        return false;
+    }
+    return true;
+}
+
+bool load_model(const std::string& path, const MeshLod::Options& options, MeshLod& model) {
+    // A loaded airframe is scaled to the built-in drone's size and simplified into levels of detail.
+    // The result is cached next to the model, tied to its content: the next start just maps it.
+    MappedFile file;
+    if (!file.open(path) || file.size() == 0) {
+        LOG_ERROR("[Model] Cannot open %s", path);
+        return false;
+    }
+
+    MeshLod::CacheKey key;
+    key.source_size = file.size();
+    key.source_hash = MeshLod::hash_source(file.data(), file.size());
+    key.fit_size = DRONE_MODEL_SIZE;
+    key.options = options;
+    std::string cache_path = path + ".mshc";
+    if (model.load(cache_path, key)) return true;
+
+    ModelLoader loader;
+    Mesh mesh;
+    ModelLoader::Format format = ModelLoader::detect_format(path, file.data(), file.size());
+    if (format == ModelLoader::Format::Unknown) {
+        LOG_ERROR("[Model] %s is not an OBJ or STL file", path);
+        return false;
+    }
+    if (!loader.load(file.data(), file.size(), format, mesh)) {
+        LOG_ERROR("[Model] No faces found in %s", path);
+        return false;
     }
+    ModelLoader::fit(mesh, DRONE_MODEL_SIZE);
+    model.build(std::move(mesh), options);
+    if (!model.save(cache_path, key)) LOG_WARN("[Model] Could not write the cache %s", cache_path);
+    return true;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Startup timing: field operators restart the app often, so time-to-first-frame matters
+    auto app_start = std::chrono::steady_clock::now();
+
+    // Child process mode: run only the Python plugin and stream samples back to the renderer
+    if (argc >= 4 && std::strcmp(argv[1], "--plugin-host") == 0) {
+        return PythonManager::runPluginHost(argv[2], argv[3]);
+    }
+
+    // --isolated-plugin runs the Python plugin in its own process (crash / hang isolation)
+    // --record <file.drec> keeps every telemetry sample for post-flight analysis
+    // --replay <file.drec> [--speed x] plays a recorded session instead of live telemetry
+    // --console also prints the attitude to the terminal (rate-limited, the HUD is the primary readout)
+    // --capture <file.y4m | frames.qoi> [--capture-fps n] [--capture-block] records the rendered view
+    // --render <file.y4m | frames.qoi> renders the --replay session to video without a window, on all cores
+    //   [--render-size WxH] [--render-fps n] [--render-threads n] [--render-tile-threads n] [--render-aliased]
+    // --hidden-lines starts with hidden-line removal on (H toggles it in the window)
+    // --solid starts with shaded solid surfaces (S toggles it in the window)
+    // --model <file.obj | file.stl> draws a loaded airframe instead of the built-in drone
+    //   [--model-crease deg] wireframe keeps the edges where faces meet at more than deg, plus the silhouette
+    // --frame <quad-x | quad-plus | hex | octo | x8> picks the built-in airframe
+    PluginMode plugin_mode = PluginMode::InProcess;
+    bool console_output = false;
+    const char* record_path = nullptr;
+    const char* replay_path = nullptr;
+    double replay_speed = 1.0;
+    const char* capture_path = nullptr;
+    FrameCapture::Options capture_options;
+    const char* render_path = nullptr;
+    OfflineRenderer::Options render_options;
+    bool hidden_lines = false;
+    bool solid = false;
+    const char* model_path = nullptr;
+    MeshLod::Options lod_options;
+    FrameType frame = FrameType::QuadX;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--isolated-plugin") == 0) plugin_mode = PluginMode::OutOfProcess;
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) record_path = argv[++i];
+        if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replay_path = argv[++i];
+        if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc) replay_speed = std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--console") == 0) console_output = true;
+        if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) capture_path = argv[++i];
+        if (std::strcmp(argv[i], "--capture-fps") == 0 && i + 1 < argc) capture_options.fps = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--capture-block") == 0) capture_options.policy = FrameCapture::Policy::Block;
+        if (std::strcmp(argv[i], "--render") == 0 && i + 1 < argc) render_path = argv[++i];
+        if (std::strcmp(argv[i], "--render-size") == 0 && i + 1 < argc) {
+            std::sscanf(argv[++i], "%dx%d", &render_options.width, &render_options.height);
+        }
+        if (std::strcmp(argv[i], "--render-fps") == 0 && i + 1 < argc) render_options.fps = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--render-threads") == 0 && i + 1 < argc) render_options.threads = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--render-tile-threads") == 0 && i + 1 < argc) render_options.tile_threads = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--render-aliased") == 0) render_options.antialias = false;
+        if (std::strcmp(argv[i], "--hidden-lines") == 0) hidden_lines = true;
+        if (std::strcmp(argv[i], "--solid") == 0) solid = true;
+        if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) model_path = argv[++i];
+        if (std::strcmp(argv[i], "--model-crease") == 0 && i + 1 < argc) lod_options.crease_degrees = static_cast<float>(std::atof(argv[++i]));
+        if (std::strcmp(argv[i], "--frame") == 0 && i + 1 < argc) {
+            if (!frame_type_from_name(argv[++i], frame)) LOG_WARN("[Model] Unknown frame type %s, drawing quad-x", argv[i]);
+        }
+    }
+
+    // SDL's own messages go through the async logger like ours
+    Logger::route_sdl_log();
+
+    // Blackbox logs from the FC are decoded once into a .drec next to them, then replayed like our own recordings
+    std::string converted_path;
+    if (replay_path != nullptr && BlackboxDecoder::is_blackbox_file(replay_path)) {
+        converted_path = std::string(replay_path) + ".drec";
+        if (!convert_blackbox(replay_path, converted_path)) return 1;
+        replay_path = converted_path.c_str();
+    }
+
+    // A loaded airframe replaces the built-in drone
+    MeshLod model;
+    bool have_model = false;
+    if (model_path != nullptr) {
+        have_model = load_model(model_path, lod_options, model);
+        if (!have_model) LOG_WARN("[Model] Drawing the built-in drone instead");
+    }
+
+    // Offline render: no window, no telemetry source, every core drawing into its own surface
+    if (render_path != nullptr) {
+        render_options.hidden_lines = hidden_lines;
+        render_options.solid = solid;
+        render_options.model = have_model ? &model : nullptr;
+        render_options.frame = frame;
+        SessionReplay session;
+        bool ok = replay_path != nullptr && session.open(replay_path) &&
+                  OfflineRenderer::render(session, render_path, render_options);
+        if (replay_path == nullptr) LOG_ERROR("--render needs a session: --replay <file>");
+        Logger::instance().flush();
+        return ok ? 0 : 1;
+    }
+
     SDL_Engine sdl_obj("window", 1800, 1300, SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_GAMEPAD, SDL_WINDOW_RESIZABLE);
     RenderEngine engine(1800, 1300, sdl_obj.renderer);
+    engine.set_hidden_line_removal(hidden_lines);
+    engine.set_solid(solid);
     SDL_Gamepad* controller = sdl_obj.Connect_First_Controller();
 
-    PythonManager* py = new PythonManager("drone_telemetry");
+    // All on-screen text of a frame goes out in one batch; released before the renderer is destroyed
+    auto hud = std::make_unique<HudText>(sdl_obj.renderer);
+
+    // Reads frames back from the renderer, so it too goes before the renderer
+    std::unique_ptr<FrameCapture> capture;
+    if (capture_path != nullptr) capture = std::make_unique<FrameCapture>(capture_path, capture_options);
+
+    // The telemetry source publishes into the mailbox from its own thread; the loop below only reads it.
+    // Construction returns as soon as the interpreter is up, the module import happens in the background.
+    TelemetryMailbox telemetry_mailbox;
+    PythonManager* py = nullptr;
+    SessionReplay replay;
+    TimelineView timeline;
+    StripChart strip_chart; // Last 10 s of roll / pitch / yaw with current values
+
+    if (replay_path != nullptr) {
+        if (!replay.open(replay_path)) return 1;
+        replay.play(telemetry_mailbox, replay_speed);
+        timeline.set_session(replay.start_time_us(), replay.end_time_us());
+    } else {
+        py = new PythonManager("drone_telemetry", telemetry_mailbox, plugin_mode);
+    }
+
+    std::unique_ptr<SessionRecorder> recorder;
+    if (record_path != nullptr && py != nullptr) {
+        recorder = std::make_unique<SessionRecorder>(record_path);
+        if (recorder->is_open()) py->setRecorder(recorder.get());
+    }
 
     float delta_x = 0.2f;
     float delta_y = 0.2f;
@@ -111,9 +256,15 @@ int main() {
     float pitch_cmd = 0.0f;
     float roll_cmd = 0.0f;
     float yaw_cmd = 0.0f;
+    math3d::Quatf attitude;       // The angles above as an orientation, redone only when they change
+    bool attitude_dirty = false;
+    int64_t attitude_sample_us = -1; // Timestamp of the sample it was made from
     
     float yaw_rate = 10.0f;
     bool running = true; // Added to handle clean shutdowns
+    bool first_frame = true;
+    bool first_telemetry = true;
+    auto last_console_print = std::chrono::steady_clock::now();
 
     while (running) {
         SDL_Event e;
@@ -122,28 +273,71 @@ int main() {
                 running = false; // Break the loop safely instead of 'return 0;'
             }
 
+            // The atlas lives in a render target, which some backends lose on device reset
+            if (e.type == SDL_EVENT_RENDER_TARGETS_RESET || e.type == SDL_EVENT_RENDER_DEVICE_RESET) {
+                hud->invalidate();
+            }
+
             if (e.type == SDL_EVENT_GAMEPAD_REMOVED) {
                 SDL_CloseGamepad(controller);
                 controller = nullptr;
             }
+
+            // H toggles hidden-line removal, S solid surfaces
+            if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_H && !e.key.repeat) {
+                engine.set_hidden_line_removal(!engine.hidden_line_removal());
+            }
+            if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_S && !e.key.repeat) {
+                engine.set_solid(!engine.solid_mode());
+            }
+
+            // Replay controls: arrows seek 5 s / change speed, space pauses
+            if (e.type == SDL_EVENT_KEY_DOWN && replay.is_open()) {
+                switch (e.key.key) {
+                    case SDLK_LEFT:  replay.seek(replay.position_us() - 5000000); break;
+                    case SDLK_RIGHT: replay.seek(replay.position_us() + 5000000); break;
+                    case SDLK_UP:    replay.set_speed(replay.speed() * 2.0); break;
+                    case SDLK_DOWN:  replay.set_speed(replay.speed() * 0.5); break;
+                    case SDLK_SPACE: replay.set_paused(!replay.paused()); break;
+                    default: break;
+                }
+            }
+
+            // Timeline: click / drag to seek, wheel to zoom
+            int64_t seek_us = 0;
+            if (replay.is_open() && timeline.handle_event(e, seek_us)) replay.seek(seek_us);
         }
         
         // Fixed: We only want to read the controller if it IS connected
         if (controller != nullptr) {
             yaw_cmd += engine.normalize_axis(SDL_GetGamepadAxis(controller, SDL_GAMEPAD_AXIS_LEFTX)) * yaw_rate; 
+            attitude_dirty = true;
         }
 
         SDL_SetRenderDrawColor(sdl_obj.renderer, 0, 0, 0, 255);
         SDL_RenderClear(sdl_obj.renderer);
 
-        // 1. Get Live Telemetry from Python
-        DroneTelemetry telemetry = py->getTelemetry();
+        // 1. Get Live Telemetry (latest sample published by the plugin thread, never blocks)
+        TelemetrySample sample;
+        bool has_telemetry = telemetry_mailbox.read(sample);
+
+        if (has_telemetry) {
+            // 2. Map Telemetry to 3D Engine Commands
+            // We cast to float because SDL and your RenderEngine likely use 32-bit floats
+            roll_cmd  = static_cast<float>(sample.attitude.roll);
+            pitch_cmd = static_cast<float>(sample.attitude.pitch);
+            yaw_cmd   = static_cast<float>(sample.attitude.yaw);
+            if (sample.timestamp_us != attitude_sample_us) {
+                attitude_sample_us = sample.timestamp_us;
+                attitude_dirty = true;
+            }
 
-        // 2. Map Telemetry to 3D Engine Commands
-        // We cast to float because SDL and your RenderEngine likely use 32-bit floats
-        roll_cmd  = static_cast<float>(telemetry.roll);
-        pitch_cmd = static_cast<float>(telemetry.pitch);
-        yaw_cmd   = static_cast<float>(telemetry.yaw);
+            if (first_telemetry) {
+                first_telemetry = false;
+                auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - app_start);
+                LOG_INFO("[Startup] First telemetry after %.1f ms", ms.count());
+            }
+        }
 
         // --- AXIS INVERSION CHECK ---
         // Flight controllers usually have: Pitch Forward = Negative
@@ -153,24 +347,70 @@ int main() {
         // pitch_cmd = -static_cast<float>(telemetry.pitch);
         // roll_cmd  = -static_cast<float>(telemetry.roll);
 
-        std::cout << "\r[C++] Roll: " << roll_cmd 
-                  << " | Pitch: " << pitch_cmd 
-                  << " | Yaw: " << yaw_cmd << "      " << std::flush;
+        // Optional terminal readout, at most 10 times per second (the logger writes it off this thread)
+        if (console_output && has_telemetry) {
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_console_print >= std::chrono::milliseconds(100)) {
+                last_console_print = now;
+                LOG_INFO("[C++] Roll: %.2f | Pitch: %.2f | Yaw: %.2f", roll_cmd, pitch_cmd, yaw_cmd);
+            }
+        }
 
-        // 3. Draw the Drone
-        draw_drone_with_engine(engine, delta_x, delta_y, delta_z, pitch_cmd, yaw_cmd, roll_cmd);
+        // 3. Draw the Drone (one quaternion per new sample; the renderer makes one matrix of it per frame)
+        if (attitude_dirty) {
+            attitude = attitude_orientation({roll_cmd, pitch_cmd, yaw_cmd});
+            attitude_dirty = false;
+        }
+        if (have_model) {
+            draw_model_with_engine(engine, model, delta_x, delta_y, delta_z, attitude);
+        } else {
+            draw_drone_with_engine(engine, delta_x, delta_y, delta_z, attitude, frame);
+        }
+
+        strip_chart.update(telemetry_mailbox);
+        if (has_telemetry) {
+            SDL_FRect chart_area = {20.0f, 20.0f, 560.0f, 300.0f};
+            strip_chart.draw(engine, sdl_obj.renderer, *hud, chart_area);
+        }
 
+        if (replay.is_open()) {
+            int output_w = 0, output_h = 0;
+            SDL_GetCurrentRenderOutputSize(sdl_obj.renderer, &output_w, &output_h);
+            SDL_FRect area = {20.0f, output_h - 170.0f, output_w - 40.0f, 150.0f};
+            timeline.draw(sdl_obj.renderer, *hud, replay.pyramid(), area, replay.position_us());
+        }
+
+        if (!has_telemetry) {
+            hud->text(20.0f, 20.0f, (py == nullptr || py->isReady()) ? "Waiting for telemetry..." : "Loading telemetry plugin...",
+                      {0.27f, 1.0f, 0.27f, 1.0f});
+        }
+
+        hud->flush();
+        if (capture) capture->capture(sdl_obj.renderer); // Must read the back buffer before it is presented
         SDL_RenderPresent(sdl_obj.renderer);
+
+        if (first_frame) {
+            first_frame = false;
+            auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - app_start);
+            LOG_INFO("[Startup] Time to first frame: %.1f ms", ms.count());
+        }
         SDL_Delay(1000 / FPS);
     }
 
     // Safely clean up everything
+    hud.reset();
+    capture.reset(); // Writes the queued frames
     SDL_DestroyRenderer(sdl_obj.renderer);
     SDL_DestroyWindow(sdl_obj.window);
     SDL_Quit();
     
-    std::cout << "\nCleaning up Python..." << std::endl;
+    replay.stop();
+
+    LOG_INFO("Cleaning up Python...");
     delete py; // Destructor will now close the COM port properly
+    recorder.reset(); // Flushes the last samples (the plugin threads are gone now)
+
+    Logger::instance().flush();
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "mapped_file.h"
+#include <utility>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_open, other.m_open);
+#ifdef _WIN32
+        std::swap(m_file, other.m_file);
+        std::swap(m_mapping, other.m_mapping);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_open = true;
+    if (m_size == 0) return true; // Empty files cannot be mapped, but are valid
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        return false;
+    }
+    m_mapping = mapping;
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_file) CloseHandle(static_cast<HANDLE>(m_file));
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    m_open = true;
+    if (m_size == 0) {
+        ::close(fd);
+        return true; // Empty files cannot be mapped, but are valid
+    }
+
+    void* base = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping stays valid after the descriptor is closed
+    if (base == MAP_FAILED) {
+        m_size = 0;
+        m_open = false;
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(base);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ * Opening is O(1) regardless of file size: pages are only read from disk
+ * when they are first touched.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return m_open; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+
+#ifdef _WIN32
+    void* m_file = nullptr;    // HANDLE
+    void* m_mapping = nullptr; // HANDLE
+#endif
+};
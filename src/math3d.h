@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define MATH3D_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MATH3D_NEON 1
+#endif
+
+/**
+ * @brief The renderer's math: vectors, matrices and quaternions, header-only and usable in constexpr.
+ *
+ * Vec2 / Vec3 / Vec4 are plain aggregates ({x, y, z} initializes them, they
+ * copy with memcpy), so RenderEngine::Point_2D / Point_3D are just Vec2f /
+ * Vec3f. Matrices are stored by columns: Mat4 c[3] is the translation, and
+ * m * v is one multiply-add per column. Mat4f * Vec4f and transform_points()
+ * use SSE or NEON when the target has them; every other operation is plain
+ * code the compiler vectorizes or folds at compile time.
+ *
+ * math3d::sin / cos exist for geometry tables generated at compile time.
+ * std::sin / std::cos are not constexpr in C++20, so these evaluate the
+ * Taylor series after reducing the angle to [-pi/2, pi/2]; the result is
+ * within a few units in the last place of a double, far below float
+ * precision. At run time use the std functions, they are faster.
+ */
+namespace math3d {
+    constexpr double PI = 3.14159265358979323846;
+
+    constexpr double radians(double degrees) { return degrees * (PI / 180.0); }
+
+    constexpr double sin(double x) {
+        // Nearest whole turn off, then fold onto the half period around 0 (sin(pi - x) = sin(x))
+        double turns = x / (2.0 * PI);
+        long long whole = static_cast<long long>(turns < 0.0 ? turns - 0.5 : turns + 0.5);
+        x -= static_cast<double>(whole) * (2.0 * PI);
+        if (x > PI / 2.0) x = PI - x;
+        if (x < -PI / 2.0) x = -PI - x;
+
+        double x2 = x * x;
+        double term = x;
+        double sum = x;
+        for (int n = 1; n <= 11; n++) {
+            term *= -x2 / static_cast<double>((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cos(double x) { return sin(x + PI / 2.0); }
+
+    // --- Vectors ---
+
+    template <typename T>
+    struct Vec2 {
+        T x;
+        T y;
+    };
+
+    template <typename T>
+    struct Vec3 {
+        T x;
+        T y;
+        T z;
+    };
+
+    template <typename T>
+    struct Vec4 {
+        T x;
+        T y;
+        T z;
+        T w;
+    };
+
+    template <typename T> constexpr Vec2<T> operator+(const Vec2<T>& a, const Vec2<T>& b) { return {a.x + b.x, a.y + b.y}; }
+    template <typename T> constexpr Vec2<T> operator-(const Vec2<T>& a, const Vec2<T>& b) { return {a.x - b.x, a.y - b.y}; }
+    template <typename T> constexpr Vec2<T> operator*(const Vec2<T>& a, T s) { return {a.x * s, a.y * s}; }
+    template <typename T> constexpr T dot(const Vec2<T>& a, const Vec2<T>& b) { return a.x * b.x + a.y * b.y; }
+    template <typename T> constexpr T cross(const Vec2<T>& a, const Vec2<T>& b) { return a.x * b.y - a.y * b.x; } // z of the 3D cross product
+
+    template <typename T> constexpr Vec3<T> operator+(const Vec3<T>& a, const Vec3<T>& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    template <typename T> constexpr Vec3<T> operator-(const Vec3<T>& a, const Vec3<T>& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    template <typename T> constexpr Vec3<T> operator-(const Vec3<T>& a) { return {-a.x, -a.y, -a.z}; }
+    template <typename T> constexpr Vec3<T> operator*(const Vec3<T>& a, T s) { return {a.x * s, a.y * s, a.z * s}; }
+    template <typename T> constexpr T dot(const Vec3<T>& a, const Vec3<T>& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    template <typename T> constexpr Vec3<T> cross(const Vec3<T>& a, const Vec3<T>& b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+    template <typename T> T length(const Vec3<T>& a) { return std::sqrt(dot(a, a)); }
+
+    template <typename T> constexpr Vec4<T> operator+(const Vec4<T>& a, const Vec4<T>& b) { return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; }
+    template <typename T> constexpr Vec4<T> operator-(const Vec4<T>& a, const Vec4<T>& b) { return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; }
+    template <typename T> constexpr Vec4<T> operator*(const Vec4<T>& a, T s) { return {a.x * s, a.y * s, a.z * s, a.w * s}; }
+    template <typename T> constexpr T dot(const Vec4<T>& a, const Vec4<T>& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    // a + (b - a) t
+    template <typename V, typename T> constexpr V lerp(const V& a, const V& b, T t) { return a + (b - a) * t; }
+
+    // --- Matrices (by columns) ---
+
+    template <typename T>
+    struct Mat3 {
+        Vec3<T> c[3];
+
+        static constexpr Mat3 identity() { return {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}}; }
+    };
+
+    template <typename T>
+    struct Mat4 {
+        Vec4<T> c[4];
+
+        static constexpr Mat4 identity() { return {{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}}}; }
+
+        // Rotation, then translation: p -> r p + t
+        static constexpr Mat4 rigid(const Mat3<T>& r, const Vec3<T>& t) {
+            return {{{r.c[0].x, r.c[0].y, r.c[0].z, 0}, {r.c[1].x, r.c[1].y, r.c[1].z, 0},
+                     {r.c[2].x, r.c[2].y, r.c[2].z, 0}, {t.x, t.y, t.z, 1}}};
+        }
+    };
+
+    template <typename T> constexpr Vec3<T> operator*(const Mat3<T>& m, const Vec3<T>& v) {
+        return m.c[0] * v.x + m.c[1] * v.y + m.c[2] * v.z;
+    }
+
+    template <typename T> constexpr Mat3<T> operator*(const Mat3<T>& a, const Mat3<T>& b) {
+        return {{a * b.c[0], a * b.c[1], a * b.c[2]}};
+    }
+
+    template <typename T> constexpr Mat3<T> transpose(const Mat3<T>& m) {
+        return {{{m.c[0].x, m.c[1].x, m.c[2].x}, {m.c[0].y, m.c[1].y, m.c[2].y}, {m.c[0].z, m.c[1].z, m.c[2].z}}};
+    }
+
+    template <typename T> constexpr Vec4<T> operator*(const Mat4<T>& m, const Vec4<T>& v) {
+        return m.c[0] * v.x + m.c[1] * v.y + m.c[2] * v.z + m.c[3] * v.w;
+    }
+
+    // float: four lanes per column, the whole product is four multiply-adds
+    constexpr Vec4<float> operator*(const Mat4<float>& m, const Vec4<float>& v) {
+#if defined(MATH3D_SSE) || defined(MATH3D_NEON)
+        if (!std::is_constant_evaluated()) {
+            Vec4<float> out;
+#if defined(MATH3D_SSE)
+            __m128 r = _mm_mul_ps(_mm_loadu_ps(&m.c[0].x), _mm_set1_ps(v.x));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m.c[1].x), _mm_set1_ps(v.y)));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m.c[2].x), _mm_set1_ps(v.z)));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m.c[3].x), _mm_set1_ps(v.w)));
+            _mm_storeu_ps(&out.x, r);
+#else
+            float32x4_t r = vmulq_n_f32(vld1q_f32(&m.c[0].x), v.x);
+            r = vmlaq_n_f32(r, vld1q_f32(&m.c[1].x), v.y);
+            r = vmlaq_n_f32(r, vld1q_f32(&m.c[2].x), v.z);
+            r = vmlaq_n_f32(r, vld1q_f32(&m.c[3].x), v.w);
+            vst1q_f32(&out.x, r);
+#endif
+            return out;
+        }
+#endif
+        return m.c[0] * v.x + m.c[1] * v.y + m.c[2] * v.z + m.c[3] * v.w;
+    }
+
+    template <typename T> constexpr Mat4<T> operator*(const Mat4<T>& a, const Mat4<T>& b) {
+        return {{a * b.c[0], a * b.c[1], a * b.c[2], a * b.c[3]}};
+    }
+
+    // out[i] = m (in[i], 1): a batch of points through one matrix, the columns loaded once
+    inline void transform_points(const Mat4<float>& m, const Vec3<float>* in, Vec4<float>* out, size_t count) {
+#if defined(MATH3D_SSE)
+        __m128 c0 = _mm_loadu_ps(&m.c[0].x), c1 = _mm_loadu_ps(&m.c[1].x);
+        __m128 c2 = _mm_loadu_ps(&m.c[2].x), c3 = _mm_loadu_ps(&m.c[3].x);
+        for (size_t i = 0; i < count; i++) {
+            __m128 r = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(in[i].x)));
+            r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(in[i].y)));
+            r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(in[i].z)));
+            _mm_storeu_ps(&out[i].x, r);
+        }
+#elif defined(MATH3D_NEON)
+        float32x4_t c0 = vld1q_f32(&m.c[0].x), c1 = vld1q_f32(&m.c[1].x);
+        float32x4_t c2 = vld1q_f32(&m.c[2].x), c3 = vld1q_f32(&m.c[3].x);
+        for (size_t i = 0; i < count; i++) {
+            float32x4_t r = vmlaq_n_f32(c3, c0, in[i].x);
+            r = vmlaq_n_f32(r, c1, in[i].y);
+            r = vmlaq_n_f32(r, c2, in[i].z);
+            vst1q_f32(&out[i].x, r);
+        }
+#else
+        for (size_t i = 0; i < count; i++) out[i] = m * Vec4<float>{in[i].x, in[i].y, in[i].z, 1.0f};
+#endif
+    }
+
+    // --- Quaternions ---
+
+    /**
+     * @brief Unit quaternion: an orientation without Euler angles' gimbal lock.
+     *
+     * Composes with * (a * b rotates by b, then by a), blends with slerp() /
+     * nlerp(), and becomes a rotation matrix once per pose (to_mat3) rather
+     * than three rotations per point.
+     */
+    template <typename T>
+    struct Quat {
+        T w = 1;
+        T x = 0;
+        T y = 0;
+        T z = 0;
+    };
+
+    template <typename T> constexpr Quat<T> operator*(const Quat<T>& a, const Quat<T>& b) {
+        return {a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+                a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w};
+    }
+
+    template <typename T> constexpr Quat<T> conjugate(const Quat<T>& q) { return {q.w, -q.x, -q.y, -q.z}; } // The inverse rotation
+
+    template <typename T> constexpr T dot(const Quat<T>& a, const Quat<T>& b) { return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    template <typename T> Quat<T> normalize(const Quat<T>& q) {
+        T length = std::sqrt(dot(q, q));
+        if (!(length > T(0))) return {};
+        T inv = T(1) / length;
+        return {q.w * inv, q.x * inv, q.y * inv, q.z * inv};
+    }
+
+    // Rotation by angle (radians, right-handed) around a unit axis
+    template <typename T> Quat<T> quat_from_axis_angle(const Vec3<T>& axis, T angle) {
+        T s = std::sin(T(0.5) * angle);
+        return {std::cos(T(0.5) * angle), axis.x * s, axis.y * s, axis.z * s};
+    }
+
+    // The renderer's Euler convention (radians): roll around Z, then pitch around X, then yaw around Y
+    template <typename T> Quat<T> quat_from_euler(T roll, T pitch, T yaw) {
+        return quat_from_axis_angle<T>({0, 1, 0}, yaw) * quat_from_axis_angle<T>({1, 0, 0}, pitch) *
+               quat_from_axis_angle<T>({0, 0, 1}, roll);
+    }
+
+    // Rotation matrix; its columns are the images of the X, Y and Z axes
+    template <typename T> constexpr Mat3<T> to_mat3(const Quat<T>& q) {
+        T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        T wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        return {{{1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy)},
+                 {2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx)},
+                 {2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy)}}};
+    }
+
+    // Blends along the shorter way round (q and -q are the same orientation). nlerp is the cheap
+    // one for nearby orientations; slerp keeps the angular speed constant over any distance.
+    template <typename T> Quat<T> nlerp(const Quat<T>& a, Quat<T> b, T t) {
+        if (dot(a, b) < T(0)) b = {-b.w, -b.x, -b.y, -b.z};
+        return normalize(Quat<T>{a.w + (b.w - a.w) * t, a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t});
+    }
+
+    template <typename T> Quat<T> slerp(const Quat<T>& a, Quat<T> b, T t) {
+        T d = dot(a, b);
+        if (d < T(0)) {
+            b = {-b.w, -b.x, -b.y, -b.z};
+            d = -d;
+        }
+        if (d > T(0.9995)) return nlerp(a, b, t); // sin(angle) ~ 0: the two are the same to float precision
+
+        T angle = std::acos(d);
+        T inv_sin = T(1) / std::sin(angle);
+        T wa = std::sin((T(1) - t) * angle) * inv_sin;
+        T wb = std::sin(t * angle) * inv_sin;
+        return {a.w * wa + b.w * wb, a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb};
+    }
+
+    using Vec2f = Vec2<float>;
+    using Vec3f = Vec3<float>;
+    using Vec4f = Vec4<float>;
+    using Mat3f = Mat3<float>;
+    using Mat4f = Mat4<float>;
+    using Quatf = Quat<float>;
+
+    static_assert(sizeof(Vec4f) == 4 * sizeof(float) && sizeof(Mat4f) == 16 * sizeof(float), "SIMD loads need packed lanes");
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include "render_engine.h"
+
+/**
+ * @brief Indexed model in its own (local) coordinates: shared vertices, triangle faces and wireframe edges.
+ *
+ * Edges are what gets drawn; faces are surfaces that hide what is behind
+ * them in hidden-line mode. A part may have only edges (a thin arm, an arrow)
+ * or faces that are not drawn as lines (a cylinder side).
+ *
+ * Faces are wound so that (b - a) x (c - a) points out of the solid: solid
+ * mode culls the faces turned away from the camera by that normal.
+ */
+struct Mesh {
+    struct Face {
+        int a;
+        int b;
+        int c;
+    };
+
+    std::vector<RenderEngine::Point_3D> vertices;
+    std::vector<Face> faces;
+    std::vector<RenderEngine::Edge> edges;
+
+    int add_vertex(const RenderEngine::Point_3D& p) {
+        vertices.push_back(p);
+        return static_cast<int>(vertices.size()) - 1;
+    }
+
+    void add_edge(int start, int end) { edges.push_back({start, end}); }
+
+    // Two triangles; a b c d in order around the quad, wound like a face
+    void add_quad(int a, int b, int c, int d) {
+        faces.push_back({a, b, c});
+        faces.push_back({a, c, d});
+    }
+};
+
+/**
+ * @brief A mesh's three tables without owning them: what RenderEngine draws.
+ *
+ * A Mesh converts to it, and so do tables that are not vectors, like the
+ * compile-time airframe geometry (StaticMesh in airframe.h).
+ */
+struct MeshView {
+    std::span<const RenderEngine::Point_3D> vertices;
+    std::span<const Mesh::Face> faces;
+    std::span<const RenderEngine::Edge> edges;
+
+    constexpr MeshView(std::span<const RenderEngine::Point_3D> v, std::span<const Mesh::Face> f,
+                       std::span<const RenderEngine::Edge> e) : vertices(v), faces(f), edges(e) {}
+    MeshView(const Mesh& mesh) : vertices(mesh.vertices), faces(mesh.faces), edges(mesh.edges) {}
+};
@@ -0,0 +1,366 @@
+#include "mesh_lod.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include "logger.h"
+#include "mapped_file.h"
+#include "mesh_simplifier.h"
+#include "thread_pool.h"
+
+namespace {
+    // A level must drop at least this share of the faces, or the chain ends (borders, folds)
+    constexpr float MIN_REDUCTION = 0.1f;
+
+    constexpr float GRID_MAX = 65535.0f; // 16-bit positions
+
+    // --- Cache file ---
+
+    constexpr char CACHE_MAGIC[8] = {'D', 'R', 'N', 'M', 'E', 'S', 'H', '\0'};
+    constexpr uint32_t CACHE_VERSION = 1;
+    constexpr uint32_t MAX_CACHE_LEVELS = 64;
+
+    struct CacheFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t level_count; // Followed by level_count x (CacheLevelHeader, sections)
+        uint64_t source_size;
+        uint64_t source_hash;
+        uint64_t min_faces;
+        uint64_t max_levels;
+        float fit_size;
+        float face_ratio;
+        float crease_degrees;
+        float radius;
+        float grid_origin[3];
+        float grid_step[3];
+    };
+    static_assert(sizeof(CacheFileHeader) == 88, "CacheFileHeader layout is part of the .mshc file format");
+
+    // Sections, each padded to 8 bytes: uint16 positions[3 * vertex_count], Face[face_count],
+    // Edge[edge_count], Edge[feature_count], Edge[candidate_count], uint32 candidate_faces[2 * candidate_count]
+    struct CacheLevelHeader {
+        uint64_t vertex_count;
+        uint64_t face_count;
+        uint64_t edge_count;
+        uint64_t feature_count;
+        uint64_t candidate_count;
+        float error;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(CacheLevelHeader) == 48, "CacheLevelHeader layout is part of the .mshc file format");
+    static_assert(sizeof(Mesh::Face) == 12 && sizeof(RenderEngine::Edge) == 8, "Faces and edges are stored as they are");
+
+    size_t padded(size_t bytes) { return (bytes + 7) & ~static_cast<size_t>(7); }
+
+    // The same float expression on build and on load, so both give the same vertices
+    float from_grid(uint16_t q, float origin, float step) { return origin + static_cast<float>(q) * step; }
+
+    uint16_t to_grid(float v, float origin, float step) {
+        if (!(step > 0.0f)) return 0;
+        return static_cast<uint16_t>(std::clamp(std::lround((v - origin) / step), 0L, static_cast<long>(GRID_MAX)));
+    }
+
+    // --- Content hash ---
+
+    // Chunks hashed independently (in parallel), then combined in order
+    constexpr size_t HASH_CHUNK = 1 << 20;
+    constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+
+    uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    uint64_t finalize(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Four independent multiply-rotate lanes over 32-byte blocks, the bytes after the last block one by one
+    uint64_t hash_chunk(const uint8_t* data, size_t size) {
+        uint64_t lanes[4] = {PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1};
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (int l = 0; l < 4; l++) {
+                uint64_t word;
+                std::memcpy(&word, data + i + l * 8, 8);
+                lanes[l] = rotl(lanes[l] + word * PRIME2, 31) * PRIME1;
+            }
+        }
+        uint64_t h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18) + size;
+        for (; i < size; i++) h = rotl(h ^ (data[i] * PRIME1), 11) * PRIME2;
+        return finalize(h);
+    }
+
+    // Reads the sections of a cache file in order, each checked against the file's end
+    class SectionReader {
+    public:
+        SectionReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+        const uint8_t* take(uint64_t count, size_t item_size) {
+            if (count > (m_size - m_offset) / item_size) return nullptr;
+            size_t bytes = padded(static_cast<size_t>(count) * item_size);
+            if (bytes > m_size - m_offset) return nullptr;
+            const uint8_t* section = m_data + m_offset;
+            m_offset += bytes;
+            return section;
+        }
+
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_offset = 0;
+    };
+
+    bool write_section(FILE* f, const void* data, size_t bytes) {
+        static const uint8_t zeros[8] = {};
+        size_t padding = padded(bytes) - bytes;
+        return (bytes == 0 || std::fwrite(data, 1, bytes, f) == bytes) &&
+               (padding == 0 || std::fwrite(zeros, 1, padding, f) == padding);
+    }
+
+    template <typename T>
+    bool read_section(SectionReader& reader, uint64_t count, std::vector<T>& out) {
+        const uint8_t* section = reader.take(count, sizeof(T));
+        if (section == nullptr) return false;
+        // Straight from the mapping, without zero-filling first: the pages are touched once
+        const T* items = reinterpret_cast<const T*>(section);
+        out.assign(items, items + count);
+        return true;
+    }
+
+    bool edges_valid(const std::vector<RenderEngine::Edge>& edges, size_t vertex_count) {
+        for (const RenderEngine::Edge& e : edges) {
+            if (e.start < 0 || e.end < 0 || static_cast<size_t>(e.start) >= vertex_count ||
+                static_cast<size_t>(e.end) >= vertex_count) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void MeshLod::build(Mesh model, const Options& options) {
+    auto start = std::chrono::steady_clock::now();
+    m_levels.clear();
+    m_levels.reserve(options.max_levels);
+    m_levels.push_back({std::move(model), FeatureEdges(), 0.0f});
+
+    while (m_levels.size() < options.max_levels) {
+        const Level& previous = m_levels.back();
+        size_t faces = previous.mesh.faces.size();
+        size_t target = static_cast<size_t>(static_cast<float>(faces) * options.face_ratio);
+        if (target < options.min_faces) break;
+
+        Level level;
+        float error = MeshSimplifier::simplify(previous.mesh, target, level.mesh);
+        if (static_cast<float>(level.mesh.faces.size()) > static_cast<float>(faces) * (1.0f - MIN_REDUCTION)) break;
+
+        // Each level is simplified from the one before: deviations add up
+        level.error = previous.error + error;
+        m_levels.push_back(std::move(level));
+    }
+
+    // Positions as they will come back from the cache; the edges are classified on those
+    quantize();
+    for (Level& level : m_levels) level.features.build(level.mesh, options.crease_degrees);
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    for (size_t i = 0; i < m_levels.size(); i++) {
+        const Level& level = m_levels[i];
+        LOG_INFO("[Model] LOD %zu: %zu faces, %zu vertices, %zu feature edges, error %.5f",
+                 i, level.mesh.faces.size(), level.mesh.vertices.size(), level.features.feature_count(), level.error);
+    }
+    LOG_INFO("[Model] %zu levels of detail in %.1f ms", m_levels.size(), ms.count());
+}
+
+void MeshLod::quantize() {
+    float lo[3] = {0.0f, 0.0f, 0.0f}, hi[3] = {0.0f, 0.0f, 0.0f};
+    bool first = true;
+    for (const Level& level : m_levels) {
+        for (const RenderEngine::Point_3D& v : level.mesh.vertices) {
+            const float p[3] = {v.x, v.y, v.z};
+            for (int a = 0; a < 3; a++) {
+                lo[a] = first ? p[a] : std::min(lo[a], p[a]);
+                hi[a] = first ? p[a] : std::max(hi[a], p[a]);
+            }
+            first = false;
+        }
+    }
+    for (int a = 0; a < 3; a++) {
+        m_grid_origin[a] = lo[a];
+        m_grid_step[a] = (hi[a] - lo[a]) / GRID_MAX;
+    }
+
+    m_radius = 0.0f;
+    for (Level& level : m_levels) {
+        for (RenderEngine::Point_3D& v : level.mesh.vertices) {
+            v.x = from_grid(to_grid(v.x, m_grid_origin[0], m_grid_step[0]), m_grid_origin[0], m_grid_step[0]);
+            v.y = from_grid(to_grid(v.y, m_grid_origin[1], m_grid_step[1]), m_grid_origin[1], m_grid_step[1]);
+            v.z = from_grid(to_grid(v.z, m_grid_origin[2], m_grid_step[2]), m_grid_origin[2], m_grid_step[2]);
+            m_radius = std::max(m_radius, std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z));
+        }
+    }
+}
+
+uint64_t MeshLod::hash_source(const uint8_t* data, size_t size, ThreadPool* pool) {
+    std::unique_ptr<ThreadPool> own_pool;
+    if (pool == nullptr) {
+        own_pool = std::make_unique<ThreadPool>();
+        pool = own_pool.get();
+    }
+
+    size_t chunk_count = (size + HASH_CHUNK - 1) / HASH_CHUNK;
+    std::vector<uint64_t> chunk_hashes(chunk_count);
+    pool->parallel_for(chunk_count, [&](size_t k) {
+        size_t first = k * HASH_CHUNK;
+        chunk_hashes[k] = hash_chunk(data + first, std::min(HASH_CHUNK, size - first));
+    });
+
+    uint64_t h = finalize(size ^ PRIME1);
+    for (uint64_t chunk_hash : chunk_hashes) h = finalize(rotl(h, 27) ^ chunk_hash) * PRIME1;
+    return h;
+}
+
+bool MeshLod::save(const std::string& path, const CacheKey& key) const {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) return false; // Read-only media: the next start builds the chain again
+
+    CacheFileHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.level_count = static_cast<uint32_t>(m_levels.size());
+    header.source_size = key.source_size;
+    header.source_hash = key.source_hash;
+    header.min_faces = key.options.min_faces;
+    header.max_levels = key.options.max_levels;
+    header.fit_size = key.fit_size;
+    header.face_ratio = key.options.face_ratio;
+    header.crease_degrees = key.options.crease_degrees;
+    header.radius = m_radius;
+    for (int a = 0; a < 3; a++) {
+        header.grid_origin[a] = m_grid_origin[a];
+        header.grid_step[a] = m_grid_step[a];
+    }
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    std::vector<uint16_t> grid;
+    for (const Level& level : m_levels) {
+        const Mesh& mesh = level.mesh;
+        const FeatureEdges& features = level.features;
+        CacheLevelHeader level_header = {};
+        level_header.vertex_count = mesh.vertices.size();
+        level_header.face_count = mesh.faces.size();
+        level_header.edge_count = mesh.edges.size();
+        level_header.feature_count = features.features().size();
+        level_header.candidate_count = features.candidates().size();
+        level_header.error = level.error;
+
+        // Exact: the positions are on the grid already (quantize())
+        grid.resize(mesh.vertices.size() * 3);
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            grid[i * 3 + 0] = to_grid(mesh.vertices[i].x, m_grid_origin[0], m_grid_step[0]);
+            grid[i * 3 + 1] = to_grid(mesh.vertices[i].y, m_grid_origin[1], m_grid_step[1]);
+            grid[i * 3 + 2] = to_grid(mesh.vertices[i].z, m_grid_origin[2], m_grid_step[2]);
+        }
+
+        ok = ok && std::fwrite(&level_header, sizeof(level_header), 1, f) == 1;
+        ok = ok && write_section(f, grid.data(), grid.size() * sizeof(uint16_t));
+        ok = ok && write_section(f, mesh.faces.data(), mesh.faces.size() * sizeof(Mesh::Face));
+        ok = ok && write_section(f, mesh.edges.data(), mesh.edges.size() * sizeof(RenderEngine::Edge));
+        ok = ok && write_section(f, features.features().data(), features.features().size() * sizeof(RenderEngine::Edge));
+        ok = ok && write_section(f, features.candidates().data(), features.candidates().size() * sizeof(RenderEngine::Edge));
+        ok = ok && write_section(f, features.candidate_faces().data(), features.candidate_faces().size() * sizeof(uint32_t));
+    }
+
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::remove(path.c_str());
+    return ok;
+}
+
+bool MeshLod::load(const std::string& path, const CacheKey& key) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(CacheFileHeader)) return false;
+
+    CacheFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    bool ok = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+              header.version == CACHE_VERSION &&
+              header.level_count > 0 && header.level_count <= MAX_CACHE_LEVELS &&
+              header.source_size == key.source_size &&
+              header.source_hash == key.source_hash &&
+              header.min_faces == key.options.min_faces &&
+              header.max_levels == key.options.max_levels &&
+              header.fit_size == key.fit_size &&
+              header.face_ratio == key.options.face_ratio &&
+              header.crease_degrees == key.options.crease_degrees;
+    if (!ok) return false;
+
+    SectionReader reader(file.data() + sizeof(header), file.size() - sizeof(header));
+    std::vector<Level> levels(header.level_count);
+    std::vector<uint16_t> grid;
+    for (Level& level : levels) {
+        const uint8_t* level_data = reader.take(1, sizeof(CacheLevelHeader));
+        if (level_data == nullptr) return false;
+        CacheLevelHeader level_header;
+        std::memcpy(&level_header, level_data, sizeof(level_header));
+
+        // Indices are ints in memory
+        if (level_header.vertex_count > INT32_MAX || level_header.face_count > INT32_MAX) return false;
+
+        Mesh& mesh = level.mesh;
+        std::vector<RenderEngine::Edge> features, candidates;
+        std::vector<uint32_t> candidate_faces;
+        ok = read_section(reader, level_header.vertex_count * 3, grid) &&
+             read_section(reader, level_header.face_count, mesh.faces) &&
+             read_section(reader, level_header.edge_count, mesh.edges) &&
+             read_section(reader, level_header.feature_count, features) &&
+             read_section(reader, level_header.candidate_count, candidates) &&
+             read_section(reader, level_header.candidate_count * 2, candidate_faces);
+        if (!ok) return false;
+
+        // A damaged file must not send an index past its arrays
+        size_t vertex_count = static_cast<size_t>(level_header.vertex_count);
+        for (const Mesh::Face& face : mesh.faces) {
+            if (face.a < 0 || face.b < 0 || face.c < 0 || static_cast<size_t>(face.a) >= vertex_count ||
+                static_cast<size_t>(face.b) >= vertex_count || static_cast<size_t>(face.c) >= vertex_count) {
+                return false;
+            }
+        }
+        if (!edges_valid(mesh.edges, vertex_count) || !edges_valid(features, vertex_count) ||
+            !edges_valid(candidates, vertex_count)) {
+            return false;
+        }
+        for (uint32_t face : candidate_faces) {
+            if (face >= mesh.faces.size()) return false;
+        }
+
+        mesh.vertices.reserve(vertex_count);
+        for (size_t i = 0; i < vertex_count; i++) {
+            mesh.vertices.push_back({from_grid(grid[i * 3 + 0], header.grid_origin[0], header.grid_step[0]),
+                                     from_grid(grid[i * 3 + 1], header.grid_origin[1], header.grid_step[1]),
+                                     from_grid(grid[i * 3 + 2], header.grid_origin[2], header.grid_step[2])});
+        }
+        level.features.assign(mesh, std::move(features), std::move(candidates), std::move(candidate_faces));
+        level.error = level_header.error;
+    }
+
+    m_levels = std::move(levels);
+    m_radius = header.radius;
+    for (int a = 0; a < 3; a++) {
+        m_grid_origin[a] = header.grid_origin[a];
+        m_grid_step[a] = header.grid_step[a];
+    }
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("[Model] %zu levels of detail (%zu faces at full detail) from %s in %.1f ms",
+             m_levels.size(), m_levels[0].mesh.faces.size(), path, ms.count());
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "feature_edges.h"
+#include "mesh.h"
+
+class ThreadPool;
+
+/**
+ * @brief A loaded model and its simplified levels of detail, each with its wireframe edges.
+ *
+ * Level 0 is the model itself; every further level has about face_ratio
+ * times the faces of the one before (MeshSimplifier), down to min_faces.
+ * Each level records how far it may deviate from level 0 in model units, so
+ * RenderEngine::select_lod() can take the coarsest one whose deviation stays
+ * under a fraction of a pixel: a drone far away or small on screen draws a
+ * few hundred faces instead of the full CAD model, and looks the same.
+ *
+ * Vertex positions are rounded to a 16-bit grid over the model's bounds
+ * (a hundred-thousandth of its size) once the levels are built. Saved next
+ * to the model as "<model>.mshc", the chain then loads back exactly as built:
+ * the file is memory-mapped and copied out, no parsing, welding,
+ * simplification or edge classification on the next start.
+ */
+class MeshLod {
+public:
+    struct Options {
+        float face_ratio = 0.25f;  // Faces of each level relative to the one before
+        size_t min_faces = 256;    // No level below this
+        size_t max_levels = 8;     // Including level 0
+        float crease_degrees = FeatureEdges::DEFAULT_CREASE_DEGREES;
+    };
+
+    // What a cache file was built from; any difference on load means rebuild
+    struct CacheKey {
+        uint64_t source_size = 0;
+        uint64_t source_hash = 0; // hash_source() of the model file
+        float fit_size = 0.0f;    // ModelLoader::fit() size of level 0
+        Options options;
+    };
+
+    // Takes the model (moved in) and simplifies it into the chain
+    void build(Mesh model, const Options& options);
+
+    // 64-bit content hash of a whole file, chunks hashed in parallel (pool may be null: a temporary
+    // pool with one thread per core is used then). Same value for any thread count.
+    static uint64_t hash_source(const uint8_t* data, size_t size, ThreadPool* pool = nullptr);
+
+    bool save(const std::string& path, const CacheKey& key) const;
+    bool load(const std::string& path, const CacheKey& key);
+
+    size_t level_count() const { return m_levels.size(); }
+    const Mesh& mesh(size_t level) const { return m_levels[level].mesh; }
+    const FeatureEdges& features(size_t level) const { return m_levels[level].features; }
+    float error(size_t level) const { return m_levels[level].error; } // Deviation from level 0, model units
+    float radius() const { return m_radius; } // Of a sphere around the model's origin holding every level
+
+private:
+    struct Level {
+        Mesh mesh;
+        FeatureEdges features;
+        float error = 0.0f;
+    };
+
+    // Rounds every level's positions to the 16-bit grid over their bounds
+    void quantize();
+
+    std::vector<Level> m_levels;
+    float m_radius = 0.0f;
+    float m_grid_origin[3] = {};
+    float m_grid_step[3] = {};
+};
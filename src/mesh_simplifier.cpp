@@ -0,0 +1,375 @@
+#include "mesh_simplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "mesh.h"
+
+namespace {
+    // Sweeps over the faces; every few the face list is compacted and the references rebuilt
+    constexpr int MAX_PASSES = 100;
+    constexpr int REBUILD_EVERY = 5;
+    // Threshold of pass i: THRESHOLD_BASE * (i + 3)^THRESHOLD_POWER, times the squared model size
+    constexpr double THRESHOLD_BASE = 1e-9;
+    constexpr double THRESHOLD_POWER = 7.0;
+    // A collapse may not fold a face (normal turning by more than ~78 degrees) or make a sliver
+    constexpr double MIN_NORMAL_DOT = 0.2;
+    constexpr double MAX_CORNER_COS = 0.999;
+
+    struct Vec3 {
+        double x, y, z;
+    };
+
+    Vec3 operator+(const Vec3& a, const Vec3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    Vec3 operator-(const Vec3& a, const Vec3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    Vec3 operator*(const Vec3& a, double s) { return {a.x * s, a.y * s, a.z * s}; }
+    double dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    Vec3 cross(const Vec3& a, const Vec3& b) { return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+
+    Vec3 normalized(const Vec3& v) {
+        double length = std::sqrt(dot(v, v));
+        return length > 0.0 ? v * (1.0 / length) : Vec3{0.0, 0.0, 0.0};
+    }
+
+    // Symmetric 4x4 matrix, upper triangle: a2 ab ac ad b2 bc bd c2 cd d2
+    struct Quadric {
+        double m[10] = {};
+
+        static Quadric plane(double a, double b, double c, double d) {
+            return {{a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d}};
+        }
+
+        Quadric& operator+=(const Quadric& q) {
+            for (int i = 0; i < 10; i++) m[i] += q.m[i];
+            return *this;
+        }
+
+        // Summed squared plane distance of p
+        double error(const Vec3& p) const {
+            return m[0] * p.x * p.x + 2 * m[1] * p.x * p.y + 2 * m[2] * p.x * p.z + 2 * m[3] * p.x +
+                   m[4] * p.y * p.y + 2 * m[5] * p.y * p.z + 2 * m[6] * p.y +
+                   m[7] * p.z * p.z + 2 * m[8] * p.z + m[9];
+        }
+
+        // Point of least error, if the planes pin one down
+        bool optimum(Vec3& p) const {
+            double det = m[0] * (m[4] * m[7] - m[5] * m[5]) - m[1] * (m[1] * m[7] - m[5] * m[2]) +
+                         m[2] * (m[1] * m[5] - m[4] * m[2]);
+            if (std::abs(det) < 1e-12) return false;
+            // Cramer's rule on A p = -b
+            double bx = -m[3], by = -m[6], bz = -m[8];
+            double inv = 1.0 / det;
+            p.x = inv * (bx * (m[4] * m[7] - m[5] * m[5]) - m[1] * (by * m[7] - m[5] * bz) + m[2] * (by * m[5] - m[4] * bz));
+            p.y = inv * (m[0] * (by * m[7] - bz * m[5]) - bx * (m[1] * m[7] - m[5] * m[2]) + m[2] * (m[1] * bz - by * m[2]));
+            p.z = inv * (m[0] * (m[4] * bz - m[5] * by) - m[1] * (m[1] * bz - by * m[2]) + bx * (m[1] * m[5] - m[4] * m[2]));
+            return std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z);
+        }
+    };
+
+    struct Vertex {
+        Vec3 p;
+        Quadric q;
+        uint32_t ref_start = 0;
+        uint32_t ref_count = 0;
+        bool border = false;
+    };
+
+    // Floats where precision does not matter: the sweep reads every face each pass
+    struct Triangle {
+        int v[3];
+        float error[4]; // Collapse cost of the sides v0v1, v1v2, v2v0, and their minimum
+        float normal[3];
+        bool deleted;
+        bool dirty; // Touched this pass: its costs are stale until the next
+    };
+
+    void set_normal(Triangle& t, const Vec3& n) {
+        t.normal[0] = static_cast<float>(n.x);
+        t.normal[1] = static_cast<float>(n.y);
+        t.normal[2] = static_cast<float>(n.z);
+    }
+
+    // Triangle tri uses the vertex as its corner corner
+    struct Ref {
+        uint32_t tri;
+        uint32_t corner;
+    };
+
+    class Decimator {
+    public:
+        Decimator(const Mesh& mesh) {
+            m_vertices.resize(mesh.vertices.size());
+            Vec3 lo = {1e300, 1e300, 1e300}, hi = {-1e300, -1e300, -1e300};
+            for (size_t i = 0; i < mesh.vertices.size(); i++) {
+                const RenderEngine::Point_3D& v = mesh.vertices[i];
+                m_vertices[i].p = {v.x, v.y, v.z};
+                lo = {std::min(lo.x, (double)v.x), std::min(lo.y, (double)v.y), std::min(lo.z, (double)v.z)};
+                hi = {std::max(hi.x, (double)v.x), std::max(hi.y, (double)v.y), std::max(hi.z, (double)v.z)};
+            }
+            m_size_squared = mesh.vertices.empty() ? 1.0 : std::max(dot(hi - lo, hi - lo), 1e-12);
+
+            m_triangles.reserve(mesh.faces.size());
+            for (const Mesh::Face& f : mesh.faces) {
+                if (f.a == f.b || f.b == f.c || f.c == f.a) continue;
+                Triangle t = {};
+                t.v[0] = f.a;
+                t.v[1] = f.b;
+                t.v[2] = f.c;
+                m_triangles.push_back(t);
+            }
+
+            m_merged_into.resize(mesh.vertices.size());
+            for (size_t i = 0; i < m_merged_into.size(); i++) m_merged_into[i] = static_cast<int>(i);
+        }
+
+        double run(size_t target_faces) {
+            size_t deleted = 0;
+            const size_t start_count = m_triangles.size();
+
+            for (int pass = 0; pass < MAX_PASSES; pass++) {
+                if (start_count - deleted <= target_faces) break;
+                if (pass % REBUILD_EVERY == 0) rebuild(pass == 0);
+                for (Triangle& t : m_triangles) t.dirty = false;
+
+                const double threshold = THRESHOLD_BASE * std::pow(pass + 3.0, THRESHOLD_POWER) * m_size_squared;
+                for (size_t ti = 0; ti < m_triangles.size(); ti++) {
+                    Triangle& t = m_triangles[ti];
+                    if (t.deleted || t.dirty || t.error[3] > threshold) continue;
+
+                    for (int j = 0; j < 3; j++) {
+                        if (t.error[j] > threshold) continue;
+                        int i0 = t.v[j], i1 = t.v[(j + 1) % 3];
+                        Vertex& v0 = m_vertices[i0];
+                        Vertex& v1 = m_vertices[i1];
+                        if (v0.border || v1.border) continue;
+
+                        Vec3 p;
+                        double error = collapse_error(i0, i1, p);
+                        m_removed0.assign(v0.ref_count, 0);
+                        m_removed1.assign(v1.ref_count, 0);
+                        if (flips(p, i1, v0, m_removed0) || flips(p, i0, v1, m_removed1)) continue;
+
+                        // i1 goes into i0; the faces of both now reference i0
+                        v0.p = p;
+                        v0.q += v1.q;
+                        m_merged_into[i1] = i0;
+                        m_max_error = std::max(m_max_error, error);
+
+                        uint32_t ref_start = static_cast<uint32_t>(m_refs.size());
+                        update_faces(i0, v0, m_removed0, deleted);
+                        update_faces(i0, v1, m_removed1, deleted);
+                        uint32_t ref_count = static_cast<uint32_t>(m_refs.size()) - ref_start;
+                        if (ref_count <= v0.ref_count) {
+                            // Fits where v0's list was: reuse it, the appended copies go again
+                            std::copy(m_refs.begin() + ref_start, m_refs.end(), m_refs.begin() + v0.ref_start);
+                            m_refs.resize(ref_start);
+                        } else {
+                            v0.ref_start = ref_start;
+                        }
+                        v0.ref_count = ref_count;
+                        break;
+                    }
+                    if (start_count - deleted <= target_faces) break;
+                }
+            }
+            return std::sqrt(std::max(m_max_error, 0.0));
+        }
+
+        void write(const Mesh& source, Mesh& out) {
+            // Vertices still used by a face or by a source edge, in their original order
+            std::vector<int> index(m_vertices.size(), -1);
+            auto root = [&](int v) {
+                while (m_merged_into[v] != v) v = m_merged_into[v];
+                return v;
+            };
+            for (const Triangle& t : m_triangles) {
+                if (t.deleted) continue;
+                for (int v : t.v) index[v] = 0;
+            }
+            for (const RenderEngine::Edge& e : source.edges) {
+                int a = root(e.start), b = root(e.end);
+                if (a != b) index[a] = index[b] = 0;
+            }
+
+            out = Mesh();
+            for (size_t i = 0; i < m_vertices.size(); i++) {
+                if (index[i] < 0) continue;
+                const Vec3& p = m_vertices[i].p;
+                index[i] = out.add_vertex({(float)p.x, (float)p.y, (float)p.z});
+            }
+
+            // Edges: the source's that survive and every face side, once each
+            std::vector<uint64_t> keys;
+            auto add_key = [&](int a, int b) {
+                a = index[a];
+                b = index[b];
+                if (a == b) return;
+                if (a > b) std::swap(a, b);
+                keys.push_back(static_cast<uint64_t>(a) << 32 | static_cast<uint32_t>(b));
+            };
+            for (const Triangle& t : m_triangles) {
+                if (t.deleted) continue;
+                out.faces.push_back({index[t.v[0]], index[t.v[1]], index[t.v[2]]});
+                for (int j = 0; j < 3; j++) add_key(t.v[j], t.v[(j + 1) % 3]);
+            }
+            for (const RenderEngine::Edge& e : source.edges) add_key(root(e.start), root(e.end));
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            out.edges.reserve(keys.size());
+            for (uint64_t key : keys) out.add_edge(static_cast<int>(key >> 32), static_cast<int>(key & 0xFFFFFFFFu));
+        }
+
+    private:
+        std::vector<Vertex> m_vertices;
+        std::vector<Triangle> m_triangles;
+        std::vector<Ref> m_refs;
+        std::vector<int> m_merged_into; // Collapsed vertex -> the one it went into (itself while alive)
+        std::vector<uint8_t> m_removed0, m_removed1; // Per reference of the collapsing pair: face disappears
+        double m_size_squared = 1.0;
+        double m_max_error = 0.0;
+
+        // Drops deleted faces and rebuilds every vertex's face list; the first time also
+        // the quadrics, borders and costs
+        void rebuild(bool first) {
+            if (!first) {
+                m_triangles.erase(std::remove_if(m_triangles.begin(), m_triangles.end(),
+                                                 [](const Triangle& t) { return t.deleted; }),
+                                  m_triangles.end());
+            }
+
+            for (Vertex& v : m_vertices) {
+                v.ref_start = 0;
+                v.ref_count = 0;
+            }
+            for (const Triangle& t : m_triangles) {
+                for (int v : t.v) m_vertices[v].ref_count++;
+            }
+            uint32_t start = 0;
+            for (Vertex& v : m_vertices) {
+                v.ref_start = start;
+                start += v.ref_count;
+                v.ref_count = 0;
+            }
+            m_refs.resize(m_triangles.size() * 3);
+            for (size_t i = 0; i < m_triangles.size(); i++) {
+                for (uint32_t j = 0; j < 3; j++) {
+                    Vertex& v = m_vertices[m_triangles[i].v[j]];
+                    m_refs[v.ref_start + v.ref_count++] = {static_cast<uint32_t>(i), j};
+                }
+            }
+            if (!first) return;
+
+            // Border vertices: some side from them belongs to one face only
+            std::vector<int> neighbours, counts;
+            for (size_t i = 0; i < m_vertices.size(); i++) {
+                const Vertex& v = m_vertices[i];
+                neighbours.clear();
+                counts.clear();
+                for (uint32_t k = 0; k < v.ref_count; k++) {
+                    const Triangle& t = m_triangles[m_refs[v.ref_start + k].tri];
+                    for (int n : t.v) {
+                        if (n == static_cast<int>(i)) continue;
+                        auto it = std::find(neighbours.begin(), neighbours.end(), n);
+                        if (it == neighbours.end()) {
+                            neighbours.push_back(n);
+                            counts.push_back(1);
+                        } else {
+                            counts[it - neighbours.begin()]++;
+                        }
+                    }
+                }
+                for (size_t n = 0; n < neighbours.size(); n++) {
+                    if (counts[n] == 1) {
+                        m_vertices[i].border = true;
+                        m_vertices[neighbours[n]].border = true;
+                    }
+                }
+            }
+
+            for (Triangle& t : m_triangles) {
+                const Vec3& p0 = m_vertices[t.v[0]].p;
+                Vec3 n = normalized(cross(m_vertices[t.v[1]].p - p0, m_vertices[t.v[2]].p - p0));
+                set_normal(t, n);
+                Quadric q = Quadric::plane(n.x, n.y, n.z, -dot(n, p0));
+                for (int v : t.v) m_vertices[v].q += q;
+            }
+            for (Triangle& t : m_triangles) update_costs(t);
+        }
+
+        void update_costs(Triangle& t) {
+            Vec3 p;
+            for (int j = 0; j < 3; j++) t.error[j] = static_cast<float>(collapse_error(t.v[j], t.v[(j + 1) % 3], p));
+            t.error[3] = std::min({t.error[0], t.error[1], t.error[2]});
+        }
+
+        // Cost of merging a and b, and where the merged vertex goes
+        double collapse_error(int a, int b, Vec3& p) const {
+            const Vertex& va = m_vertices[a];
+            const Vertex& vb = m_vertices[b];
+            Quadric q = va.q;
+            q += vb.q;
+
+            // The optimum, unless the planes leave it undetermined or far off the edge
+            Vec3 mid = (va.p + vb.p) * 0.5;
+            Vec3 side = vb.p - va.p;
+            if (q.optimum(p) && dot(p - mid, p - mid) <= dot(side, side)) return q.error(p);
+
+            double ea = q.error(va.p), eb = q.error(vb.p), em = q.error(mid);
+            if (ea <= eb && ea <= em) {
+                p = va.p;
+                return ea;
+            }
+            p = eb <= em ? vb.p : mid;
+            return std::min(eb, em);
+        }
+
+        // Would moving vertex v to p turn one of its faces over? Faces shared with other go away
+        // with the collapse; those are flagged in removed.
+        bool flips(const Vec3& p, int other, const Vertex& v, std::vector<uint8_t>& removed) const {
+            for (uint32_t k = 0; k < v.ref_count; k++) {
+                const Ref& r = m_refs[v.ref_start + k];
+                const Triangle& t = m_triangles[r.tri];
+                if (t.deleted) continue;
+                int id1 = t.v[(r.corner + 1) % 3];
+                int id2 = t.v[(r.corner + 2) % 3];
+                if (id1 == other || id2 == other) {
+                    removed[k] = 1;
+                    continue;
+                }
+                Vec3 d1 = normalized(m_vertices[id1].p - p);
+                Vec3 d2 = normalized(m_vertices[id2].p - p);
+                if (std::abs(dot(d1, d2)) > MAX_CORNER_COS) return true;
+                Vec3 normal = {t.normal[0], t.normal[1], t.normal[2]};
+                if (dot(normalized(cross(d1, d2)), normal) < MIN_NORMAL_DOT) return true;
+            }
+            return false;
+        }
+
+        // Points v's faces at target (or deletes those that collapse), appending their references
+        void update_faces(int target, const Vertex& v, const std::vector<uint8_t>& removed, size_t& deleted) {
+            for (uint32_t k = 0; k < v.ref_count; k++) {
+                Ref r = m_refs[v.ref_start + k];
+                Triangle& t = m_triangles[r.tri];
+                if (t.deleted) continue;
+                if (removed[k]) {
+                    t.deleted = true;
+                    deleted++;
+                    continue;
+                }
+                t.v[r.corner] = target;
+                t.dirty = true;
+                const Vec3& p0 = m_vertices[t.v[0]].p;
+                set_normal(t, normalized(cross(m_vertices[t.v[1]].p - p0, m_vertices[t.v[2]].p - p0)));
+                update_costs(t);
+                m_refs.push_back(r);
+            }
+        }
+    };
+}
+
+float MeshSimplifier::simplify(const Mesh& mesh, size_t target_faces, Mesh& out) {
+    Decimator decimator(mesh);
+    double error = decimator.run(target_faces);
+    decimator.write(mesh, out);
+    return static_cast<float>(error);
+}
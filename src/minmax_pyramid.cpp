@@ -0,0 +1,238 @@
+#include "minmax_pyramid.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace {
+    constexpr char PYRAMID_MAGIC[8] = {'D', 'R', 'N', 'M', 'M', 'X', '\0', '\0'};
+    constexpr uint32_t PYRAMID_VERSION = 1;
+
+    struct PyramidFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t leaf_samples;
+        uint32_t fanout;
+        uint32_t channel_count;
+        uint64_t log_size;    // Size of the log the pyramid was built from
+        int64_t end_us;
+        uint64_t level_count; // Followed by level_count x (uint64_t node_count, Node[node_count])
+    };
+
+    void merge_into(MinMaxPyramid::Node& into, const MinMaxPyramid::Node& node) {
+        for (int c = 0; c < MinMaxPyramid::CHANNEL_COUNT; ++c) {
+            into.min[c] = std::min(into.min[c], node.min[c]);
+            into.max[c] = std::max(into.max[c], node.max[c]);
+        }
+    }
+}
+
+void MinMaxPyramid::append(const TelemetrySample& sample) {
+    if (m_open_count == 0) {
+        m_open.first_timestamp_us = sample.timestamp_us;
+        for (int c = 0; c < CHANNEL_COUNT; ++c) {
+            m_open.min[c] = m_open.max[c] = static_cast<float>(sample.attitude.*session_format::CHANNEL_MEMBERS[c]);
+        }
+    } else {
+        for (int c = 0; c < CHANNEL_COUNT; ++c) {
+            float value = static_cast<float>(sample.attitude.*session_format::CHANNEL_MEMBERS[c]);
+            m_open.min[c] = std::min(m_open.min[c], value);
+            m_open.max[c] = std::max(m_open.max[c], value);
+        }
+    }
+    m_open_last_us = sample.timestamp_us;
+
+    // Only a completed leaf takes the lock, once every LEAF_SAMPLES samples
+    if (++m_open_count == LEAF_SAMPLES) flush();
+}
+
+void MinMaxPyramid::append(const TelemetrySample* samples, size_t count) {
+    for (size_t i = 0; i < count; ++i) append(samples[i]);
+}
+
+void MinMaxPyramid::flush() {
+    if (m_open_count == 0) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    push_node(0, m_open);
+    m_end_us = m_open_last_us;
+    m_open_count = 0;
+}
+
+void MinMaxPyramid::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_levels.clear();
+    m_end_us = 0;
+    m_open_count = 0;
+}
+
+void MinMaxPyramid::push_node(size_t level, const Node& node) {
+    if (m_levels.size() <= level) m_levels.emplace_back();
+
+    std::vector<Node>& nodes = m_levels[level];
+    nodes.push_back(node);
+    if (nodes.size() % FANOUT != 0) return;
+
+    // A group just filled up: its summary becomes one node of the level above
+    Node parent = nodes[nodes.size() - FANOUT];
+    for (size_t i = nodes.size() - FANOUT + 1; i < nodes.size(); ++i) merge_into(parent, nodes[i]);
+    push_node(level + 1, parent);
+}
+
+MinMaxPyramid::Column MinMaxPyramid::combine(int channel, size_t lo, size_t hi) const {
+    Column result = {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+    auto take = [&](const Node& node) {
+        result.min = std::min(result.min, node.min[channel]);
+        result.max = std::max(result.max, node.max[channel]);
+    };
+
+    // Segment-tree walk: peel the unaligned ends at this level, then continue one level up.
+    // At most 2 * (FANOUT - 1) nodes per level are touched.
+    for (size_t level = 0; lo < hi; ++level) {
+        const std::vector<Node>& nodes = m_levels[level];
+        if (level + 1 >= m_levels.size()) {
+            for (size_t i = lo; i < hi; ++i) take(nodes[i]);
+            break;
+        }
+
+        while (lo < hi && lo % FANOUT != 0) take(nodes[lo++]);
+        while (lo < hi && hi % FANOUT != 0) take(nodes[--hi]);
+        lo /= FANOUT;
+        hi /= FANOUT;
+    }
+    return result;
+}
+
+void MinMaxPyramid::query(int channel, int64_t begin_us, int64_t end_us, Column* out, size_t columns) const {
+    const Column empty = {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_levels.empty() || end_us <= begin_us || channel < 0 || channel >= CHANNEL_COUNT) {
+        std::fill(out, out + columns, empty);
+        return;
+    }
+
+    const std::vector<Node>& leaves = m_levels[0];
+    auto leaves_before = [&](int64_t t) { // Number of leaves starting at or before t
+        return static_cast<size_t>(std::upper_bound(leaves.begin(), leaves.end(), t,
+            [](int64_t time, const Node& node) { return time < node.first_timestamp_us; }) - leaves.begin());
+    };
+
+    int64_t span = end_us - begin_us;
+    for (size_t c = 0; c < columns; ++c) {
+        int64_t t0 = begin_us + static_cast<int64_t>(span * static_cast<double>(c) / columns);
+        int64_t t1 = begin_us + static_cast<int64_t>(span * static_cast<double>(c + 1) / columns);
+
+        if (t1 <= leaves.front().first_timestamp_us || t0 > m_end_us) {
+            out[c] = empty;
+            continue;
+        }
+
+        // Leaves overlapping [t0, t1): the one containing t0 up to the last one starting before t1
+        size_t lo = leaves_before(t0);
+        if (lo > 0) --lo;
+        size_t hi = std::max(leaves_before(t1 - 1), lo + 1);
+        out[c] = combine(channel, lo, hi);
+    }
+}
+
+MinMaxPyramid::Column MinMaxPyramid::channel_range(int channel) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_levels.empty() || channel < 0 || channel >= CHANNEL_COUNT) {
+        return {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+    }
+    return combine(channel, 0, m_levels[0].size());
+}
+
+int64_t MinMaxPyramid::start_time_us() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_levels.empty() ? 0 : m_levels[0].front().first_timestamp_us;
+}
+
+int64_t MinMaxPyramid::end_time_us() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_end_us;
+}
+
+bool MinMaxPyramid::empty() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_levels.empty();
+}
+
+bool MinMaxPyramid::save(const std::string& path, uint64_t log_size) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) return false; // Read-only media: the replay rebuilds it
+
+    PyramidFileHeader header = {};
+    std::memcpy(header.magic, PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC));
+    header.version = PYRAMID_VERSION;
+    header.leaf_samples = LEAF_SAMPLES;
+    header.fanout = FANOUT;
+    header.channel_count = CHANNEL_COUNT;
+    header.log_size = log_size;
+    header.end_us = m_end_us;
+    header.level_count = m_levels.size();
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    for (const std::vector<Node>& nodes : m_levels) {
+        uint64_t count = nodes.size();
+        ok = ok && std::fwrite(&count, sizeof(count), 1, f) == 1;
+        ok = ok && std::fwrite(nodes.data(), sizeof(Node), nodes.size(), f) == nodes.size();
+    }
+
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::remove(path.c_str());
+    return ok;
+}
+
+bool MinMaxPyramid::load(const std::string& path, uint64_t log_size) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+
+    // Node counts come from the file: never allocate more than it can actually hold
+    long file_size = -1;
+    if (std::fseek(f, 0, SEEK_END) == 0) file_size = std::ftell(f);
+    std::rewind(f);
+    uint64_t remaining = file_size > 0 ? static_cast<uint64_t>(file_size) : 0;
+
+    PyramidFileHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, f) == 1 &&
+              std::memcmp(header.magic, PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC)) == 0 &&
+              header.version == PYRAMID_VERSION &&
+              header.leaf_samples == LEAF_SAMPLES &&
+              header.fanout == FANOUT &&
+              header.channel_count == CHANNEL_COUNT &&
+              header.log_size == log_size &&
+              header.level_count < 64 &&
+              remaining >= sizeof(header);
+    if (ok) remaining -= sizeof(header);
+
+    std::vector<std::vector<Node>> levels(ok ? header.level_count : 0);
+    for (size_t level = 0; ok && level < levels.size(); ++level) {
+        uint64_t count = 0;
+        ok = remaining >= sizeof(count) && std::fread(&count, sizeof(count), 1, f) == 1;
+        if (ok) remaining -= sizeof(count);
+
+        // Every level must be exactly the merge of the full groups below it
+        size_t expected = (level == 0) ? count : levels[level - 1].size() / FANOUT;
+        ok = ok && count == expected && count > 0 && count <= remaining / sizeof(Node);
+        if (ok) {
+            remaining -= count * sizeof(Node);
+            levels[level].resize(count);
+            ok = std::fread(levels[level].data(), sizeof(Node), count, f) == count;
+        }
+    }
+    std::fclose(f);
+
+    // The top level must be the last one push_node() would have created
+    if (ok && !levels.empty() && levels.back().size() >= FANOUT) ok = false;
+    if (!ok) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_levels = std::move(levels);
+    m_end_us = header.end_us;
+    m_open_count = 0;
+    return true;
+}
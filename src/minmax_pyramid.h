@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "session_format.h"
+#include "telemetry.h"
+
+/**
+ * @brief Multi-level min/max summary of every telemetry channel, for drawing long sessions.
+ *
+ * Level 0 holds one node per LEAF_SAMPLES samples, every level above merges
+ * FANOUT nodes of the one below. A range query walks up the levels like a
+ * segment tree, so asking for one min/max pair per pixel column costs the same
+ * for a ten second hop and a ten hour flight.
+ *
+ * Built incrementally: append() is called as samples arrive (single producer),
+ * query() may run on another thread at the same time. Saved next to a log as
+ * "<log>.mmx" so replays do not rebuild it.
+ */
+class MinMaxPyramid {
+public:
+    static constexpr size_t LEAF_SAMPLES = 64;
+    static constexpr size_t FANOUT = 4;
+    static constexpr int CHANNEL_COUNT = session_format::CHANNEL_COUNT;
+
+    // Floats are plenty for drawing and halve the memory of a long session
+    struct Node {
+        int64_t first_timestamp_us; // Node covers [first_timestamp_us, next node's first_timestamp_us)
+        float min[CHANNEL_COUNT];
+        float max[CHANNEL_COUNT];
+    };
+    static_assert(sizeof(Node) == 32, "Node layout is part of the .mmx file format");
+
+    // Result for one pixel column. Empty columns (no data in range) have min > max.
+    struct Column {
+        float min;
+        float max;
+        bool empty() const { return min > max; }
+    };
+
+    MinMaxPyramid() = default;
+
+    MinMaxPyramid(const MinMaxPyramid&) = delete;
+    MinMaxPyramid& operator=(const MinMaxPyramid&) = delete;
+
+    // Producer side: samples must arrive in timestamp order
+    void append(const TelemetrySample& sample);
+    void append(const TelemetrySample* samples, size_t count);
+
+    // Publishes the partially filled leaf (end of a recording)
+    void flush();
+
+    void clear();
+
+    // Writes one Column per pixel for channel over [begin_us, end_us), split into `columns` equal slices
+    void query(int channel, int64_t begin_us, int64_t end_us, Column* out, size_t columns) const;
+
+    // Min / max of a channel over everything published so far
+    Column channel_range(int channel) const;
+
+    int64_t start_time_us() const;
+    int64_t end_time_us() const;
+    bool empty() const;
+
+    // log_size ties the file to the log it summarises: a mismatch on load means rebuild
+    bool save(const std::string& path, uint64_t log_size) const;
+    bool load(const std::string& path, uint64_t log_size);
+
+private:
+    // Appends a node to a level and merges full groups upwards (m_mutex held)
+    void push_node(size_t level, const Node& node);
+
+    // Min / max of channel over nodes [lo, hi) of level 0 (m_mutex held)
+    Column combine(int channel, size_t lo, size_t hi) const;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::vector<Node>> m_levels;
+    int64_t m_end_us = 0; // Last timestamp of the newest published leaf
+
+    // Leaf being filled (producer only)
+    Node m_open = {};
+    size_t m_open_count = 0;
+    int64_t m_open_last_us = 0;
+};
@@ -0,0 +1,642 @@
+#include "model_loader.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "logger.h"
+#include "mapped_file.h"
+#include "mesh.h"
+#include "thread_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define MODEL_LOADER_SSE2 1
+#endif
+
+namespace {
+    constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
+    constexpr size_t STL_HEADER_BYTES = 84;
+    constexpr size_t STL_RECORD_BYTES = 50;
+
+    // Vertices in the same grid cell are merged; the cell is this fraction of the bounding box diagonal
+    constexpr float WELD_TOLERANCE = 1e-6f;
+    constexpr int GRID_BITS = 21; // Per axis: 1 / WELD_TOLERANCE cells fit, three axes pack into 63 bits
+
+    // OBJ corner referring back from the current vertex (negative index), resolved after the chunks are joined
+    constexpr int64_t RELATIVE = int64_t(1) << 62;
+
+    using Point = RenderEngine::Point_3D;
+
+    // What the parsers produce: unwelded positions, triangles, and the edges to draw
+    struct RawModel {
+        std::vector<Point> positions;
+        std::vector<uint32_t> triangles;  // 3 corners per triangle, into positions; empty = every 3 positions (STL)
+        std::vector<uint32_t> edge_pairs; // 2 per edge; empty = the triangles' own sides
+    };
+
+    // Piece boundaries for parallel parsing: about even, each one just after a line break
+    std::vector<size_t> split_lines(const char* text, size_t size, size_t pieces) {
+        size_t piece_bytes = std::max(MIN_CHUNK_BYTES, size / std::max<size_t>(pieces, 1) + 1);
+        std::vector<size_t> splits = {0};
+        for (size_t pos = piece_bytes; pos < size; pos += piece_bytes) {
+            const void* nl = std::memchr(text + pos, '\n', size - pos);
+            if (nl == nullptr) break;
+            size_t next = static_cast<const char*>(nl) - text + 1;
+            if (next > splits.back() && next < size) splits.push_back(next);
+            pos = next;
+        }
+        splits.push_back(size);
+        return splits;
+    }
+
+    const char* skip_blanks(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        return p;
+    }
+
+    bool parse_float(const char*& p, const char* end, float& out) {
+        p = skip_blanks(p, end);
+        if (p < end && *p == '+') p++; // from_chars does not take a leading plus
+        auto result = std::from_chars(p, end, out);
+        if (result.ec != std::errc()) return false;
+        p = result.ptr;
+        return true;
+    }
+
+    bool parse_point(const char*& p, const char* end, Point& out) {
+        return parse_float(p, end, out.x) && parse_float(p, end, out.y) && parse_float(p, end, out.z);
+    }
+
+    bool starts_with(const char* p, const char* end, const char* word) {
+        size_t n = std::strlen(word);
+        return static_cast<size_t>(end - p) >= n && std::memcmp(p, word, n) == 0;
+    }
+
+    // --- STL ---
+
+    bool is_binary_stl(const uint8_t* data, size_t size) {
+        if (size < STL_HEADER_BYTES) return false;
+        uint32_t count;
+        std::memcpy(&count, data + 80, sizeof(count));
+        return STL_HEADER_BYTES + static_cast<uint64_t>(count) * STL_RECORD_BYTES == size;
+    }
+
+    bool parse_stl_binary(const uint8_t* data, size_t size, ThreadPool& pool, RawModel& raw) {
+        if (!is_binary_stl(data, size)) return false;
+        size_t count = (size - STL_HEADER_BYTES) / STL_RECORD_BYTES;
+        raw.positions.resize(count * 3);
+
+        // Fixed-size records: every range is independent. Floats are little-endian like the file.
+        size_t ranges = std::max<size_t>(pool.size() * 4, 1);
+        size_t per_range = count / ranges + 1;
+        pool.parallel_for(ranges, [&](size_t k) {
+            size_t first = k * per_range;
+            size_t last = std::min(first + per_range, count);
+            for (size_t i = first; i < last; i++) {
+                std::memcpy(&raw.positions[i * 3], data + STL_HEADER_BYTES + i * STL_RECORD_BYTES + 12, 3 * sizeof(Point));
+            }
+        });
+        return true;
+    }
+
+    bool parse_stl_ascii(const uint8_t* data, size_t size, ThreadPool& pool, RawModel& raw) {
+        // Only "vertex x y z" lines matter; facets are every three vertices in file order
+        const char* text = reinterpret_cast<const char*>(data);
+        std::vector<size_t> splits = split_lines(text, size, pool.size() * 4);
+        size_t piece_count = splits.size() - 1;
+
+        std::vector<std::vector<Point>> pieces(piece_count);
+        std::vector<char> bad(piece_count, 0);
+        pool.parallel_for(piece_count, [&](size_t k) {
+            const char* p = text + splits[k];
+            const char* end = text + splits[k + 1];
+            while (p < end) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                const char* line_end = nl != nullptr ? nl : end;
+
+                const char* q = skip_blanks(p, line_end);
+                if (starts_with(q, line_end, "vertex")) {
+                    q += 6;
+                    Point v;
+                    if (parse_point(q, line_end, v)) {
+                        pieces[k].push_back(v);
+                    } else {
+                        bad[k] = 1;
+                    }
+                }
+                p = line_end + 1;
+            }
+        });
+
+        if (std::find(bad.begin(), bad.end(), 1) != bad.end()) LOG_WARN("[Model] Unreadable vertex lines skipped");
+
+        size_t total = 0;
+        for (const auto& piece : pieces) total += piece.size();
+        raw.positions.reserve(total);
+        for (const auto& piece : pieces) raw.positions.insert(raw.positions.end(), piece.begin(), piece.end());
+
+        if (raw.positions.size() % 3 != 0) {
+            LOG_WARN("[Model] %zu vertices are not a whole number of facets, the last ones are dropped", raw.positions.size());
+            raw.positions.resize(raw.positions.size() / 3 * 3);
+        }
+        return !raw.positions.empty();
+    }
+
+    // --- OBJ ---
+
+    struct ObjPiece {
+        std::vector<Point> vertices;
+        std::vector<int64_t> corners;   // Polygons back to back: 0-based index, or RELATIVE + piece-local index
+        std::vector<uint32_t> sizes;    // Corners per polygon
+        size_t bad_lines = 0;
+    };
+
+    void parse_obj_piece(const char* p, const char* end, ObjPiece& piece) {
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* line_end = nl != nullptr ? nl : end;
+            const char* q = skip_blanks(p, line_end);
+            p = line_end + 1;
+
+            if (line_end - q < 2 || (q[1] != ' ' && q[1] != '\t')) continue; // vt, vn, comments, groups ...
+
+            if (q[0] == 'v') {
+                q += 1;
+                Point v;
+                if (parse_point(q, line_end, v)) {
+                    piece.vertices.push_back(v);
+                } else {
+                    piece.bad_lines++;
+                }
+            } else if (q[0] == 'f') {
+                // "f 1 2 3", "f 1/4/7 2/5/8 ...", "f -3 -2 -1": only the position index is used
+                q += 1;
+                size_t first = piece.corners.size();
+                bool ok = true;
+                while (true) {
+                    q = skip_blanks(q, line_end);
+                    if (q >= line_end) break;
+
+                    int64_t index = 0;
+                    auto result = std::from_chars(q, line_end, index);
+                    if (result.ec != std::errc() || index == 0) {
+                        ok = false;
+                        break;
+                    }
+                    q = result.ptr;
+                    while (q < line_end && *q != ' ' && *q != '\t' && *q != '\r') q++; // /vt/vn
+
+                    int64_t local = static_cast<int64_t>(piece.vertices.size());
+                    piece.corners.push_back(index > 0 ? index - 1 : RELATIVE + local + index);
+                }
+
+                size_t count = piece.corners.size() - first;
+                if (!ok || count < 3) {
+                    piece.corners.resize(first);
+                    piece.bad_lines++;
+                    continue;
+                }
+                piece.sizes.push_back(static_cast<uint32_t>(count));
+            }
+        }
+    }
+
+    bool parse_obj(const uint8_t* data, size_t size, ThreadPool& pool, RawModel& raw) {
+        const char* text = reinterpret_cast<const char*>(data);
+        std::vector<size_t> splits = split_lines(text, size, pool.size() * 4);
+        size_t piece_count = splits.size() - 1;
+
+        std::vector<ObjPiece> pieces(piece_count);
+        pool.parallel_for(piece_count, [&](size_t k) {
+            parse_obj_piece(text + splits[k], text + splits[k + 1], pieces[k]);
+        });
+
+        // Join: vertices in file order, relative indices now get their absolute base
+        size_t vertex_count = 0;
+        size_t bad_lines = 0;
+        for (const ObjPiece& piece : pieces) {
+            vertex_count += piece.vertices.size();
+            bad_lines += piece.bad_lines;
+        }
+        if (vertex_count >= UINT32_MAX) {
+            LOG_ERROR("[Model] Too many vertices (%zu)", vertex_count);
+            return false;
+        }
+        raw.positions.reserve(vertex_count);
+
+        size_t out_of_range = 0;
+        std::vector<uint32_t> polygon;
+        for (const ObjPiece& piece : pieces) {
+            int64_t base = static_cast<int64_t>(raw.positions.size());
+            raw.positions.insert(raw.positions.end(), piece.vertices.begin(), piece.vertices.end());
+
+            size_t c = 0;
+            for (uint32_t n : piece.sizes) {
+                polygon.clear();
+                bool ok = true;
+                for (uint32_t i = 0; i < n; i++, c++) {
+                    int64_t index = piece.corners[c];
+                    if (index >= RELATIVE / 2) index = base + (index - RELATIVE);
+                    if (index < 0 || index >= static_cast<int64_t>(vertex_count)) ok = false;
+                    polygon.push_back(static_cast<uint32_t>(index));
+                }
+                if (!ok) {
+                    out_of_range++;
+                    continue;
+                }
+
+                // Fan triangles for filling and depth; the outline for the wireframe
+                for (uint32_t i = 1; i + 1 < n; i++) {
+                    raw.triangles.insert(raw.triangles.end(), {polygon[0], polygon[i], polygon[i + 1]});
+                }
+                for (uint32_t i = 0; i < n; i++) {
+                    raw.edge_pairs.insert(raw.edge_pairs.end(), {polygon[i], polygon[(i + 1) % n]});
+                }
+            }
+        }
+
+        if (bad_lines > 0) LOG_WARN("[Model] %zu unreadable v / f lines skipped", bad_lines);
+        if (out_of_range > 0) LOG_WARN("[Model] %zu faces with vertex indices out of range skipped", out_of_range);
+        return !raw.triangles.empty();
+    }
+
+    // --- Welding and edges ---
+
+    // fn(first, last) over about even slices of [0, count), one parallel task per slice
+    template <typename Fn>
+    void for_ranges(ThreadPool& pool, size_t count, size_t ranges, Fn&& fn) {
+        size_t per_range = count / ranges + 1;
+        pool.parallel_for(ranges, [&](size_t k) {
+            size_t first = std::min(k * per_range, count);
+            size_t last = std::min(first + per_range, count);
+            fn(first, last, k);
+        });
+    }
+
+    // Turns per-range counts into their start offsets; returns the total
+    size_t exclusive_sum(std::vector<size_t>& counts) {
+        size_t total = 0;
+        for (size_t& c : counts) {
+            size_t n = c;
+            c = total;
+            total += n;
+        }
+        return total;
+    }
+
+    /**
+     * Merges positions sharing a grid cell; remap[i] becomes the new index of raw position i.
+     *
+     * All threads insert into one open-addressing table (CAS on the slot key)
+     * and each slot remembers the first position that hit it. New indices are
+     * handed out in that first-position order afterwards, so the result is the
+     * same whatever the thread count. False if the table was sized too small.
+     */
+    bool weld(const std::vector<Point>& positions, size_t expected_unique, ThreadPool& pool,
+              std::vector<Point>& vertices, std::vector<uint32_t>& remap) {
+        const size_t count = positions.size();
+        const size_t ranges = std::max<size_t>(pool.size() * 4, 1);
+
+        std::vector<Point> range_lo(ranges, positions[0]), range_hi(ranges, positions[0]);
+        for_ranges(pool, count, ranges, [&](size_t first, size_t last, size_t k) {
+            Point lo = range_lo[k], hi = range_hi[k];
+            for (size_t i = first; i < last; i++) {
+                const Point& p = positions[i];
+                lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+                hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+            }
+            range_lo[k] = lo;
+            range_hi[k] = hi;
+        });
+        Point lo = range_lo[0], hi = range_hi[0];
+        for (size_t k = 1; k < ranges; k++) {
+            lo = {std::min(lo.x, range_lo[k].x), std::min(lo.y, range_lo[k].y), std::min(lo.z, range_lo[k].z)};
+            hi = {std::max(hi.x, range_hi[k].x), std::max(hi.y, range_hi[k].y), std::max(hi.z, range_hi[k].z)};
+        }
+
+        float diagonal = std::sqrt((hi.x - lo.x) * (hi.x - lo.x) + (hi.y - lo.y) * (hi.y - lo.y) + (hi.z - lo.z) * (hi.z - lo.z));
+        float inv_cell = diagonal > 0.0f ? 1.0f / (diagonal * WELD_TOLERANCE) : 1.0f;
+        const float max_cell = static_cast<float>((1u << GRID_BITS) - 1);
+
+        auto cell_key = [&](const Point& p) {
+            auto q = [&](float v, float origin) {
+                float c = (v - origin) * inv_cell + 0.5f;
+                if (!(c >= 0.0f)) return uint64_t(0); // Also NaN
+                return static_cast<uint64_t>(std::min(c, max_cell));
+            };
+            return q(p.x, lo.x) << (2 * GRID_BITS) | q(p.y, lo.y) << GRID_BITS | q(p.z, lo.z);
+        };
+
+        // Open addressing, linear probing, no resizing: a fill beyond 3/4 aborts and the caller retries bigger
+        constexpr uint64_t EMPTY = UINT64_MAX; // Keys use 63 bits
+        constexpr uint32_t FIRST_BIT = 0x80000000u;
+        int bits = 4;
+        while ((size_t(1) << bits) < expected_unique * 2) bits++;
+        if (bits > 31) return false; // Slot numbers share remap with FIRST_BIT
+        const size_t capacity = size_t(1) << bits;
+        const size_t mask = capacity - 1;
+
+        // Key and first position side by side: one cache line per lookup
+        struct Slot {
+            uint64_t key;
+            uint32_t first; // First position in the slot, later its vertex index
+        };
+        std::vector<Slot> slots(capacity);
+        for_ranges(pool, capacity, ranges, [&](size_t first, size_t last, size_t) {
+            std::fill(slots.begin() + first, slots.begin() + last, Slot{EMPTY, UINT32_MAX});
+        });
+
+        std::atomic<size_t> used{0};
+        std::atomic<bool> overflow{false};
+        auto slot_of = [&](uint64_t key) { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - bits)); };
+
+        // 1. Every position finds or claims its cell's slot; remap temporarily holds slot numbers
+        remap.resize(count);
+        for_ranges(pool, count, ranges, [&](size_t first, size_t last, size_t) {
+            // Neighbouring triangles share corners, so most lookups repeat a key seen shortly before:
+            // a small direct-mapped cache that stays in L2 answers those without touching the table
+            constexpr int CACHE_BITS = 14;
+            std::vector<uint64_t> cache_keys(size_t(1) << CACHE_BITS, EMPTY);
+            std::vector<uint32_t> cache_slot(size_t(1) << CACHE_BITS);
+            auto cache_of = [](uint64_t key) { return static_cast<size_t>((key * 0xC2B2AE3D27D4EB4Full) >> (64 - CACHE_BITS)); };
+
+            // The rest land all over a table far bigger than the caches: fetch their slots a few positions ahead
+            constexpr size_t AHEAD = 32;
+            uint64_t ahead_keys[AHEAD];
+            for (size_t i = first; i < std::min(first + AHEAD, last); i++) ahead_keys[i % AHEAD] = cell_key(positions[i]);
+
+            for (size_t i = first; i < last; i++) {
+                uint64_t key = ahead_keys[i % AHEAD];
+                if (i + AHEAD < last) {
+                    uint64_t next = cell_key(positions[i + AHEAD]);
+                    ahead_keys[i % AHEAD] = next;
+#ifdef MODEL_LOADER_SSE2
+                    if (cache_keys[cache_of(next)] != next) {
+                        _mm_prefetch(reinterpret_cast<const char*>(&slots[slot_of(next)]), _MM_HINT_T0);
+                    }
+#endif
+                }
+
+                // A cache hit was seen earlier in this range, so this is not the slot's first position
+                size_t c = cache_of(key);
+                if (cache_keys[c] == key) {
+                    remap[i] = cache_slot[c];
+                    continue;
+                }
+
+                size_t s = slot_of(key);
+                while (true) {
+                    std::atomic_ref<uint64_t> slot(slots[s].key);
+                    uint64_t current = slot.load(std::memory_order_relaxed);
+                    if (current == EMPTY) {
+                        if (!slot.compare_exchange_strong(current, key, std::memory_order_relaxed)) continue; // Re-read
+                        if (used.fetch_add(1, std::memory_order_relaxed) + 1 > capacity / 4 * 3) {
+                            overflow.store(true, std::memory_order_relaxed);
+                            return;
+                        }
+                        break;
+                    }
+                    if (current == key) break;
+                    s = (s + 1) & mask;
+                }
+
+                std::atomic_ref<uint32_t> first_pos(slots[s].first);
+                uint32_t seen = first_pos.load(std::memory_order_relaxed);
+                while (i < seen && !first_pos.compare_exchange_weak(seen, static_cast<uint32_t>(i), std::memory_order_relaxed)) {}
+
+                remap[i] = static_cast<uint32_t>(s);
+                cache_keys[c] = key;
+                cache_slot[c] = static_cast<uint32_t>(s);
+            }
+        });
+        if (overflow.load()) return false;
+
+        // 2. Mark the positions that come first in their cell, count them per range
+        std::vector<size_t> offsets(ranges, 0);
+        for_ranges(pool, count, ranges, [&](size_t first, size_t last, size_t k) {
+            size_t n = 0;
+            for (size_t i = first; i < last; i++) {
+                if (slots[remap[i]].first == i) {
+                    remap[i] |= FIRST_BIT;
+                    n++;
+                }
+            }
+            offsets[k] = n;
+        });
+        vertices.resize(exclusive_sum(offsets));
+
+        // 3. Those become the vertices, in file order; their slot now holds the vertex index
+        for_ranges(pool, count, ranges, [&](size_t first, size_t last, size_t k) {
+            uint32_t next = static_cast<uint32_t>(offsets[k]);
+            for (size_t i = first; i < last; i++) {
+                if ((remap[i] & FIRST_BIT) == 0) continue;
+                vertices[next] = positions[i];
+                slots[remap[i] & ~FIRST_BIT].first = next++;
+            }
+        });
+
+        // 4. Slot numbers to vertex indices
+        for_ranges(pool, count, ranges, [&](size_t first, size_t last, size_t) {
+            for (size_t i = first; i < last; i++) remap[i] = slots[remap[i] & ~FIRST_BIT].first;
+        });
+        return true;
+    }
+
+    /**
+     * Unique undirected edges from edge_count candidates, endpoints(e, a, b) giving each one.
+     *
+     * Counting sort by the lower vertex into per-vertex buckets (atomic
+     * counters), then every bucket - a handful of entries - is sorted and
+     * deduplicated on its own. Output is ordered by vertex, independent of the
+     * thread count.
+     */
+    template <typename Endpoints>
+    void unique_edges(size_t edge_count, Endpoints&& endpoints, size_t vertex_count, ThreadPool& pool,
+                      std::vector<RenderEngine::Edge>& edges) {
+        const size_t ranges = std::max<size_t>(pool.size() * 4, 1);
+
+        std::vector<uint32_t> start(vertex_count + 1, 0);
+        for_ranges(pool, edge_count, ranges, [&](size_t first, size_t last, size_t) {
+            for (size_t e = first; e < last; e++) {
+                uint32_t a, b;
+                endpoints(e, a, b);
+                if (a != b) std::atomic_ref<uint32_t>(start[std::min(a, b) + 1]).fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        for (size_t v = 0; v < vertex_count; v++) start[v + 1] += start[v];
+
+        std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+        std::vector<uint32_t> upper(start[vertex_count]);
+        for_ranges(pool, edge_count, ranges, [&](size_t first, size_t last, size_t) {
+            for (size_t e = first; e < last; e++) {
+                uint32_t a, b;
+                endpoints(e, a, b);
+                if (a == b) continue;
+                uint32_t at = std::atomic_ref<uint32_t>(fill[std::min(a, b)]).fetch_add(1, std::memory_order_relaxed);
+                upper[at] = std::max(a, b);
+            }
+        });
+
+        // Deduplicate each bucket in place; fill[v] becomes its unique count
+        std::vector<size_t> offsets(ranges, 0);
+        for_ranges(pool, vertex_count, ranges, [&](size_t first, size_t last, size_t k) {
+            size_t n = 0;
+            for (size_t v = first; v < last; v++) {
+                uint32_t* begin = upper.data() + start[v];
+                uint32_t* end = upper.data() + start[v + 1];
+                std::sort(begin, end);
+                fill[v] = static_cast<uint32_t>(std::unique(begin, end) - begin);
+                n += fill[v];
+            }
+            offsets[k] = n;
+        });
+        edges.resize(exclusive_sum(offsets));
+
+        for_ranges(pool, vertex_count, ranges, [&](size_t first, size_t last, size_t k) {
+            RenderEngine::Edge* out = edges.data() + offsets[k];
+            for (size_t v = first; v < last; v++) {
+                const uint32_t* b = upper.data() + start[v];
+                for (uint32_t j = 0; j < fill[v]; j++) *out++ = {static_cast<int>(v), static_cast<int>(b[j])};
+            }
+        });
+    }
+}
+
+ModelLoader::Format ModelLoader::detect_format(const std::string& path, const uint8_t* data, size_t size) {
+    std::string ext = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (ext == ".obj") return Format::Obj;
+    if (ext != ".stl") return Format::Unknown;
+    if (is_binary_stl(data, size)) return Format::StlBinary;
+
+    const char* text = reinterpret_cast<const char*>(data);
+    const char* p = skip_blanks(text, text + size);
+    while (p < text + size && (*p == '\n')) p = skip_blanks(p + 1, text + size);
+    return starts_with(p, text + size, "solid") ? Format::StlAscii : Format::Unknown;
+}
+
+bool ModelLoader::load_file(const std::string& path, Mesh& mesh) {
+    MappedFile file;
+    if (!file.open(path) || file.size() == 0) {
+        LOG_ERROR("[Model] Cannot open %s", path);
+        return false;
+    }
+
+    Format format = detect_format(path, file.data(), file.size());
+    if (format == Format::Unknown) {
+        LOG_ERROR("[Model] %s is not an OBJ or STL file", path);
+        return false;
+    }
+    if (!load(file.data(), file.size(), format, mesh)) {
+        LOG_ERROR("[Model] No faces found in %s", path);
+        return false;
+    }
+    return true;
+}
+
+bool ModelLoader::load(const uint8_t* data, size_t size, Format format, Mesh& mesh) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::unique_ptr<ThreadPool> own_pool;
+    ThreadPool* pool = m_pool;
+    if (pool == nullptr) {
+        own_pool = std::make_unique<ThreadPool>();
+        pool = own_pool.get();
+    }
+
+    RawModel raw;
+    bool ok = false;
+    switch (format) {
+        case Format::Obj:       ok = parse_obj(data, size, *pool, raw); break;
+        case Format::StlAscii:  ok = parse_stl_ascii(data, size, *pool, raw); break;
+        case Format::StlBinary: ok = parse_stl_binary(data, size, *pool, raw); break;
+        case Format::Unknown:   break;
+    }
+    if (!ok || raw.positions.empty()) return false;
+    if (raw.positions.size() >= INT32_MAX) {
+        LOG_ERROR("[Model] Too many vertices (%zu)", raw.positions.size());
+        return false;
+    }
+
+    // STL repeats each shared vertex about six times, OBJ (mostly) not at all.
+    // Guessed too low (a triangle soup), the table overflows and welding runs again with room for everything.
+    size_t expected_unique = format == Format::Obj ? raw.positions.size() : raw.positions.size() / 5 + 16;
+    std::vector<uint32_t> remap;
+    std::vector<Point> vertices;
+    if (!weld(raw.positions, expected_unique, *pool, vertices, remap) &&
+        !weld(raw.positions, raw.positions.size(), *pool, vertices, remap)) {
+        LOG_ERROR("[Model] Too many vertices (%zu)", raw.positions.size());
+        return false;
+    }
+    const size_t position_count = raw.positions.size();
+    std::vector<Point>().swap(raw.positions);
+
+    // Triangles that collapsed in welding are dropped; their sides may still be real edges
+    const size_t ranges = std::max<size_t>(pool->size() * 4, 1);
+    const bool soup = raw.triangles.empty();
+    const size_t triangle_count = soup ? position_count / 3 : raw.triangles.size() / 3;
+    auto corner = [&](size_t t, int k) { return remap[soup ? t * 3 + k : raw.triangles[t * 3 + k]]; };
+    auto degenerate = [](uint32_t a, uint32_t b, uint32_t c) { return a == b || b == c || c == a; };
+
+    std::vector<size_t> offsets(ranges, 0);
+    for_ranges(*pool, triangle_count, ranges, [&](size_t first, size_t last, size_t k) {
+        size_t n = 0;
+        for (size_t t = first; t < last; t++) n += !degenerate(corner(t, 0), corner(t, 1), corner(t, 2));
+        offsets[k] = n;
+    });
+
+    mesh = Mesh();
+    mesh.faces.resize(exclusive_sum(offsets));
+    for_ranges(*pool, triangle_count, ranges, [&](size_t first, size_t last, size_t k) {
+        Mesh::Face* out = mesh.faces.data() + offsets[k];
+        for (size_t t = first; t < last; t++) {
+            uint32_t a = corner(t, 0), b = corner(t, 1), c = corner(t, 2);
+            if (!degenerate(a, b, c)) *out++ = {static_cast<int>(a), static_cast<int>(b), static_cast<int>(c)};
+        }
+    });
+
+    // Edges: OBJ polygon outlines, or the sides of the (STL) triangles
+    if (!raw.edge_pairs.empty()) {
+        unique_edges(raw.edge_pairs.size() / 2, [&](size_t e, uint32_t& a, uint32_t& b) {
+            a = remap[raw.edge_pairs[e * 2]];
+            b = remap[raw.edge_pairs[e * 2 + 1]];
+        }, vertices.size(), *pool, mesh.edges);
+    } else {
+        const std::vector<Mesh::Face>& faces = mesh.faces;
+        unique_edges(faces.size() * 3, [&](size_t e, uint32_t& a, uint32_t& b) {
+            const Mesh::Face& f = faces[e / 3];
+            int side = static_cast<int>(e % 3);
+            a = static_cast<uint32_t>(side == 0 ? f.a : side == 1 ? f.b : f.c);
+            b = static_cast<uint32_t>(side == 0 ? f.b : side == 1 ? f.c : f.a);
+        }, vertices.size(), *pool, mesh.edges);
+    }
+    mesh.vertices = std::move(vertices);
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("[Model] %zu vertices (%zu before welding), %zu faces, %zu edges in %.1f ms on %u threads",
+             mesh.vertices.size(), position_count, mesh.faces.size(), mesh.edges.size(), ms.count(), pool->size());
+    return !mesh.faces.empty();
+}
+
+void ModelLoader::fit(Mesh& mesh, float size) {
+    if (mesh.vertices.empty()) return;
+
+    Point lo = mesh.vertices[0], hi = mesh.vertices[0];
+    for (const Point& p : mesh.vertices) {
+        lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+        hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+    }
+
+    float extent = std::max({hi.x - lo.x, hi.y - lo.y, hi.z - lo.z});
+    float scale = extent > 0.0f ? size / extent : 1.0f;
+    Point center = {(lo.x + hi.x) * 0.5f, (lo.y + hi.y) * 0.5f, (lo.z + hi.z) * 0.5f};
+    for (Point& p : mesh.vertices) {
+        p = {(p.x - center.x) * scale, (p.y - center.y) * scale, (p.z - center.z) * scale};
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct Mesh;
+class ThreadPool;
+
+/**
+ * @brief Loads airframe models (OBJ, ASCII / binary STL) into a Mesh.
+ *
+ * The file is memory-mapped and parsed in place: text formats are split at
+ * line boundaries and the pieces parsed in parallel with std::from_chars,
+ * binary STL is read straight from the mapping. Vertices falling into the
+ * same cell of a grid a millionth of the model's size are merged, the cells
+ * found through a hash table (STL stores every triangle's corners
+ * separately). Every polygon side becomes one unique edge: OBJ quads keep
+ * their four edges, no triangulation diagonals.
+ *
+ * Welding and edge extraction run on all cores too; the resulting mesh is
+ * the same for any thread count (vertices in order of first appearance).
+ */
+class ModelLoader {
+public:
+    enum class Format {
+        Unknown,
+        Obj,
+        StlAscii,
+        StlBinary
+    };
+
+    // pool may be null: a temporary pool with one thread per core is used then
+    explicit ModelLoader(ThreadPool* pool = nullptr) : m_pool(pool) {}
+
+    bool load_file(const std::string& path, Mesh& mesh);
+
+    // Same, for a file already in memory
+    bool load(const uint8_t* data, size_t size, Format format, Mesh& mesh);
+
+    // OBJ by extension; STL by content (a binary STL may also start with "solid")
+    static Format detect_format(const std::string& path, const uint8_t* data, size_t size);
+
+    // Centers the model on its bounding box and scales its largest side to size
+    static void fit(Mesh& mesh, float size);
+
+private:
+    ThreadPool* m_pool;
+};
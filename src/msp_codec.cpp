@@ -0,0 +1,122 @@
+#include "msp_codec.h"
+
+std::vector<uint8_t> msp_encode(uint8_t command, const uint8_t* payload, size_t size) {
+    if (size > MSP_MAX_PAYLOAD) size = MSP_MAX_PAYLOAD;
+
+    std::vector<uint8_t> frame;
+    frame.reserve(size + MSP_OVERHEAD);
+    frame.push_back('$');
+    frame.push_back('M');
+    frame.push_back('<');
+    frame.push_back(static_cast<uint8_t>(size));
+    frame.push_back(command);
+
+    uint8_t checksum = static_cast<uint8_t>(size) ^ command;
+    for (size_t i = 0; i < size; i++) {
+        frame.push_back(payload[i]);
+        checksum ^= payload[i];
+    }
+    frame.push_back(checksum);
+    return frame;
+}
+
+size_t msp_split_frames(const uint8_t* data, size_t size, std::vector<MspFrame>& out) {
+    size_t pos = 0;
+
+    while (pos + MSP_OVERHEAD <= size) {
+        // Resynchronise on the "$M" preamble
+        if (data[pos] != '$' || data[pos + 1] != 'M') {
+            pos++;
+            continue;
+        }
+
+        char direction = static_cast<char>(data[pos + 2]);
+        if (direction != '<' && direction != '>' && direction != '!') {
+            pos++;
+            continue;
+        }
+
+        uint8_t length = data[pos + 3];
+        if (pos + MSP_OVERHEAD + length > size) break; // Incomplete, wait for more bytes
+
+        uint8_t command = data[pos + 4];
+        const uint8_t* payload = data + pos + 5;
+
+        uint8_t checksum = length ^ command;
+        for (uint8_t i = 0; i < length; i++) checksum ^= payload[i];
+
+        if (checksum != payload[length]) {
+            pos++; // Corrupt frame or a false preamble inside binary data
+            continue;
+        }
+
+        out.push_back({ direction, command, payload, length });
+        pos += MSP_OVERHEAD + length;
+    }
+
+    // Everything before pos is either a frame or garbage; keep the tail
+    return pos;
+}
+
+bool msp_decode_attitude(const MspFrame& frame, double out[3]) {
+    if (frame.command != MSP_ATTITUDE || frame.size < 6) return false;
+
+    auto read_i16 = [&](int offset) {
+        return static_cast<int16_t>(frame.payload[offset] | (frame.payload[offset + 1] << 8));
+    };
+
+    // Roll / pitch are in decidegrees, yaw in whole degrees
+    out[0] = read_i16(0) / 10.0;
+    out[1] = read_i16(2) / 10.0;
+    out[2] = static_cast<double>(read_i16(4));
+    return true;
+}
+
+bool MspDecoder::step(uint8_t byte) {
+    switch (m_state) {
+        case State::Idle:
+            if (byte == '$') m_state = State::M;
+            return false;
+
+        case State::M:
+            m_state = (byte == 'M') ? State::Direction : State::Idle;
+            return false;
+
+        case State::Direction:
+            if (byte == '<' || byte == '>' || byte == '!') {
+                m_direction = static_cast<char>(byte);
+                m_state = State::Size;
+            } else {
+                m_state = State::Idle;
+            }
+            return false;
+
+        case State::Size:
+            m_size = byte;
+            m_checksum = byte;
+            m_state = State::Command;
+            return false;
+
+        case State::Command:
+            m_command = byte;
+            m_checksum ^= byte;
+            m_received = 0;
+            m_state = (m_size > 0) ? State::Payload : State::Checksum;
+            return false;
+
+        case State::Payload:
+            m_payload[m_received++] = byte;
+            m_checksum ^= byte;
+            if (m_received == m_size) m_state = State::Checksum;
+            return false;
+
+        case State::Checksum:
+            m_state = State::Idle;
+            if (byte != m_checksum) {
+                m_checksum_errors++;
+                return false;
+            }
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief MultiWii Serial Protocol (MSP v1) framing used by Betaflight / iNav.
+ *
+ * Frame layout: '$' 'M' <direction> <size> <command> <payload...> <checksum>
+ * direction is '<' (to the FC), '>' (reply) or '!' (error reply),
+ * checksum is the XOR of size, command and every payload byte.
+ */
+
+constexpr uint8_t MSP_ATTITUDE = 108;
+constexpr size_t MSP_MAX_PAYLOAD = 255;
+constexpr size_t MSP_OVERHEAD = 6; // '$' 'M' dir size cmd checksum
+
+// One decoded frame. payload points into the caller's buffer (bulk split)
+// or into the decoder's internal buffer (incremental decode).
+struct MspFrame {
+    char direction;
+    uint8_t command;
+    const uint8_t* payload;
+    uint8_t size;
+};
+
+// Builds a request frame ('$M<') for the given command and payload
+std::vector<uint8_t> msp_encode(uint8_t command, const uint8_t* payload, size_t size);
+
+// Splits as many complete, checksum-valid frames out of a buffer as possible.
+// Garbage between frames is skipped. Returns the number of bytes consumed;
+// anything after that is the start of an incomplete frame and should be kept.
+size_t msp_split_frames(const uint8_t* data, size_t size, std::vector<MspFrame>& out);
+
+// Decodes the 6-byte MSP_ATTITUDE payload into degrees (roll, pitch, yaw)
+bool msp_decode_attitude(const MspFrame& frame, double out[3]);
+
+/**
+ * @brief Byte-at-a-time MSP state machine for streams that arrive in arbitrary pieces.
+ * feed() can be called with any chunk size; complete frames are handed to the callback.
+ */
+class MspDecoder {
+public:
+    template <typename Callback>
+    void feed(const uint8_t* data, size_t size, Callback&& on_frame) {
+        for (size_t i = 0; i < size; i++) {
+            if (step(data[i])) {
+                MspFrame frame = { m_direction, m_command, m_payload, m_size };
+                on_frame(frame);
+            }
+        }
+    }
+
+    void reset() { m_state = State::Idle; }
+
+    // Frames dropped because the checksum did not match
+    uint32_t checksum_errors() const { return m_checksum_errors; }
+
+private:
+    enum class State { Idle, M, Direction, Size, Command, Payload, Checksum };
+
+    // Advances the state machine by one byte, returns true when a valid frame completed
+    bool step(uint8_t byte);
+
+    State m_state = State::Idle;
+    char m_direction = 0;
+    uint8_t m_size = 0;
+    uint8_t m_command = 0;
+    uint8_t m_checksum = 0;
+    size_t m_received = 0;
+    uint32_t m_checksum_errors = 0;
+    uint8_t m_payload[MSP_MAX_PAYLOAD];
+};
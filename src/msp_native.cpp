@@ -0,0 +1,228 @@
+#include "msp_native.h"
+#include "msp_codec.h"
+#include <new>
+#include <vector>
+
+namespace {
+    // array.array, looked up once when the module is imported
+    PyObject* g_array_type = nullptr;
+
+    // [(cmd, payload_bytes), ...] for every reply frame ('>'). Error replies ('!') are skipped.
+    PyObject* frames_to_list(const std::vector<MspFrame>& frames) {
+        PyObject* list = PyList_New(0);
+        if (list == nullptr) return nullptr;
+
+        for (const MspFrame& frame : frames) {
+            if (frame.direction != '>') continue;
+
+            PyObject* item = Py_BuildValue("(iy#)", frame.command,
+                                           reinterpret_cast<const char*>(frame.payload),
+                                           static_cast<Py_ssize_t>(frame.size));
+            if (item == nullptr || PyList_Append(list, item) != 0) {
+                Py_XDECREF(item);
+                Py_DECREF(list);
+                return nullptr;
+            }
+            Py_DECREF(item);
+        }
+        return list;
+    }
+
+    // --- Module functions ---
+
+    PyObject* py_encode(PyObject*, PyObject* args) {
+        int command = 0;
+        Py_buffer payload = {}; // Optional argument, stays empty when omitted
+
+        if (!PyArg_ParseTuple(args, "i|y*", &command, &payload)) return nullptr;
+
+        if (command < 0 || command > 255 || payload.len > static_cast<Py_ssize_t>(MSP_MAX_PAYLOAD)) {
+            if (payload.obj) PyBuffer_Release(&payload);
+            PyErr_SetString(PyExc_ValueError, "MSP command must be 0-255 and payload at most 255 bytes");
+            return nullptr;
+        }
+
+        std::vector<uint8_t> frame = msp_encode(static_cast<uint8_t>(command),
+                                                static_cast<const uint8_t*>(payload.buf),
+                                                static_cast<size_t>(payload.len));
+        if (payload.obj) PyBuffer_Release(&payload);
+
+        return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(frame.data()),
+                                         static_cast<Py_ssize_t>(frame.size()));
+    }
+
+    PyObject* py_split_frames(PyObject*, PyObject* args) {
+        Py_buffer buffer;
+        if (!PyArg_ParseTuple(args, "y*", &buffer)) return nullptr;
+
+        std::vector<MspFrame> frames;
+        size_t consumed = msp_split_frames(static_cast<const uint8_t*>(buffer.buf),
+                                           static_cast<size_t>(buffer.len), frames);
+
+        // Payloads still point into the buffer, copy them out before releasing it
+        PyObject* list = frames_to_list(frames);
+        PyBuffer_Release(&buffer);
+        if (list == nullptr) return nullptr;
+
+        return Py_BuildValue("(Nn)", list, static_cast<Py_ssize_t>(consumed));
+    }
+
+    PyObject* py_attitude_array(PyObject*, PyObject* args) {
+        Py_buffer buffer;
+        if (!PyArg_ParseTuple(args, "y*", &buffer)) return nullptr;
+
+        std::vector<MspFrame> frames;
+        size_t consumed = msp_split_frames(static_cast<const uint8_t*>(buffer.buf),
+                                           static_cast<size_t>(buffer.len), frames);
+
+        std::vector<double> values;
+        values.reserve(frames.size() * 3);
+        for (const MspFrame& frame : frames) {
+            double attitude[3];
+            if (frame.direction == '>' && msp_decode_attitude(frame, attitude)) {
+                values.insert(values.end(), attitude, attitude + 3);
+            }
+        }
+        PyBuffer_Release(&buffer);
+
+        // array('d', raw_bytes) copies the doubles in one go, no per-element PyFloat objects
+        PyObject* raw = PyBytes_FromStringAndSize(reinterpret_cast<const char*>(values.data()),
+                                                  static_cast<Py_ssize_t>(values.size() * sizeof(double)));
+        if (raw == nullptr) return nullptr;
+
+        PyObject* array = PyObject_CallFunction(g_array_type, "sN", "d", raw);
+        if (array == nullptr) return nullptr;
+
+        return Py_BuildValue("(Nn)", array, static_cast<Py_ssize_t>(consumed));
+    }
+
+    PyMethodDef g_methods[] = {
+        {"encode", py_encode, METH_VARARGS,
+         "encode(cmd, payload=b'') -> bytes\nBuild an MSP v1 request frame."},
+        {"split_frames", py_split_frames, METH_VARARGS,
+         "split_frames(buffer) -> ([(cmd, payload), ...], consumed)\n"
+         "Extract every complete reply frame; keep buffer[consumed:] for the next call."},
+        {"attitude_array", py_attitude_array, METH_VARARGS,
+         "attitude_array(buffer) -> (array('d'), consumed)\n"
+         "Flat [roll, pitch, yaw, ...] in degrees for every MSP_ATTITUDE reply in the buffer."},
+        {nullptr, nullptr, 0, nullptr}
+    };
+
+    // --- Decoder type (incremental, for scripts that read in small pieces) ---
+
+    struct DecoderObject {
+        PyObject_HEAD
+        MspDecoder decoder;
+    };
+
+    PyObject* decoder_new(PyTypeObject* type, PyObject*, PyObject*) {
+        auto* self = reinterpret_cast<DecoderObject*>(type->tp_alloc(type, 0));
+        if (self) new (&self->decoder) MspDecoder();
+        return reinterpret_cast<PyObject*>(self);
+    }
+
+    void decoder_dealloc(PyObject* obj) {
+        PyTypeObject* type = Py_TYPE(obj);
+        reinterpret_cast<DecoderObject*>(obj)->decoder.~MspDecoder();
+        type->tp_free(obj);
+        Py_DECREF(type); // Heap types own a reference from each instance
+    }
+
+    PyObject* decoder_feed(PyObject* obj, PyObject* args) {
+        Py_buffer buffer;
+        if (!PyArg_ParseTuple(args, "y*", &buffer)) return nullptr;
+
+        auto* self = reinterpret_cast<DecoderObject*>(obj);
+        PyObject* list = PyList_New(0);
+        bool failed = (list == nullptr);
+
+        self->decoder.feed(static_cast<const uint8_t*>(buffer.buf), static_cast<size_t>(buffer.len),
+            [&](const MspFrame& frame) {
+                if (failed || frame.direction != '>') return;
+                PyObject* item = Py_BuildValue("(iy#)", frame.command,
+                                               reinterpret_cast<const char*>(frame.payload),
+                                               static_cast<Py_ssize_t>(frame.size));
+                if (item == nullptr || PyList_Append(list, item) != 0) failed = true;
+                Py_XDECREF(item);
+            });
+        PyBuffer_Release(&buffer);
+
+        if (failed) {
+            Py_XDECREF(list);
+            return nullptr;
+        }
+        return list;
+    }
+
+    PyObject* decoder_reset(PyObject* obj, PyObject*) {
+        reinterpret_cast<DecoderObject*>(obj)->decoder.reset();
+        Py_RETURN_NONE;
+    }
+
+    PyObject* decoder_checksum_errors(PyObject* obj, void*) {
+        return PyLong_FromUnsignedLong(reinterpret_cast<DecoderObject*>(obj)->decoder.checksum_errors());
+    }
+
+    PyMethodDef g_decoder_methods[] = {
+        {"feed", decoder_feed, METH_VARARGS,
+         "feed(chunk) -> [(cmd, payload), ...]\nPush bytes in, get every reply frame they completed."},
+        {"reset", decoder_reset, METH_NOARGS, "Drop any partially received frame."},
+        {nullptr, nullptr, 0, nullptr}
+    };
+
+    PyGetSetDef g_decoder_getset[] = {
+        {"checksum_errors", decoder_checksum_errors, nullptr, "Frames dropped because of a bad checksum.", nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}
+    };
+
+    PyType_Slot g_decoder_slots[] = {
+        {Py_tp_new, reinterpret_cast<void*>(decoder_new)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(decoder_dealloc)},
+        {Py_tp_methods, g_decoder_methods},
+        {Py_tp_getset, g_decoder_getset},
+        {Py_tp_doc, const_cast<char*>("Incremental MSP v1 frame decoder.")},
+        {0, nullptr}
+    };
+
+    PyType_Spec g_decoder_spec = {
+        "msp_native.Decoder",
+        sizeof(DecoderObject),
+        0,
+        Py_TPFLAGS_DEFAULT,
+        g_decoder_slots
+    };
+
+    PyModuleDef g_module = {
+        PyModuleDef_HEAD_INIT,
+        "msp_native",
+        "Native MSP encoder / decoder / frame splitter provided by DroneApp.",
+        -1,
+        g_methods,
+        nullptr, nullptr, nullptr, nullptr
+    };
+
+    PyObject* init_module() {
+        PyObject* array_module = PyImport_ImportModule("array");
+        if (array_module == nullptr) return nullptr;
+        g_array_type = PyObject_GetAttrString(array_module, "array");
+        Py_DECREF(array_module);
+        if (g_array_type == nullptr) return nullptr;
+
+        PyObject* module = PyModule_Create(&g_module);
+        if (module == nullptr) return nullptr;
+
+        PyObject* decoder_type = PyType_FromSpec(&g_decoder_spec);
+        if (decoder_type == nullptr || PyModule_AddObject(module, "Decoder", decoder_type) != 0) {
+            Py_XDECREF(decoder_type);
+            Py_DECREF(module);
+            return nullptr;
+        }
+
+        PyModule_AddIntConstant(module, "MSP_ATTITUDE", MSP_ATTITUDE);
+        return module;
+    }
+}
+
+void register_msp_native_module() {
+    PyImport_AppendInittab("msp_native", init_module);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+/**
+ * @brief Built-in "msp_native" extension module for embedded plugin scripts.
+ *
+ * Exposes the C++ MSP codec to Python so scripts can frame and parse MSP
+ * without struct.unpack loops:
+ *
+ *   msp_native.encode(cmd, payload=b"")     -> bytes
+ *   msp_native.split_frames(buffer)         -> ([(cmd, payload), ...], consumed)
+ *   msp_native.attitude_array(buffer)       -> (array('d', [roll, pitch, yaw, ...]), consumed)
+ *   msp_native.Decoder().feed(chunk)        -> [(cmd, payload), ...]
+ *
+ * Must be registered before the interpreter is initialized.
+ */
+void register_msp_native_module();
@@ -0,0 +1,245 @@
+#include "offline_render.h"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "drone_model.h"
+#include "hud_text.h"
+#include "logger.h"
+#include "render_engine.h"
+#include "software_rasterizer.h"
+#include "timeline_view.h"
+
+namespace {
+    // A range of consecutive frames, encoded by one worker and written as a whole
+    struct Chunk {
+        std::vector<std::vector<uint8_t>> frames;
+        bool done = false;
+    };
+
+    // Encoded frames waiting for the writer, counted at their worst-case size
+    constexpr size_t MAX_BUFFERED_BYTES = 256u << 20;
+
+    constexpr SDL_FColor TEXT_COLOR = {0.27f, 1.0f, 0.27f, 1.0f};
+
+    // Same scene as the live view: the drone, its attitude in numbers and the session timeline
+    void draw_frame(RenderEngine& engine, SoftwareRasterizer& rasterizer, SDL_Renderer* renderer, HudText& hud,
+                    TimelineView& timeline, const MinMaxPyramid& pyramid, const MeshLod* model, FrameType frame, const TelemetrySample& sample,
+                    const math3d::Quatf& orientation, int64_t time_us, int64_t start_us, int width, int height) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        SDL_FlushRenderer(renderer); // The rasterizer writes into the same surface next
+
+        // The wireframe is nearly all of the fill: our rasterizer rather than SDL's triangle-at-a-time one
+        if (model != nullptr) {
+            draw_model_with_engine(engine, *model, 0.2f, 0.2f, 2.0f, orientation);
+        } else {
+            draw_drone_with_engine(engine, 0.2f, 0.2f, 2.0f, orientation, frame);
+        }
+        rasterizer.flush();
+
+        const DroneTelemetry& attitude = sample.attitude;
+        char line[64];
+        float y = 20.0f;
+        float line_height = 2.5f * HudText::GLYPH_SIZE;
+        std::snprintf(line, sizeof(line), "T+ %9.2f s", (time_us - start_us) / 1e6);
+        hud.text(20.0f, y, line, TEXT_COLOR, 2.0f);
+        for (int c = 0; c < session_format::CHANNEL_COUNT; c++) {
+            y += line_height;
+            std::snprintf(line, sizeof(line), "%-6s %8.2f", session_format::CHANNEL_NAMES[c],
+                          attitude.*session_format::CHANNEL_MEMBERS[c]);
+            hud.text(20.0f, y, line, TEXT_COLOR, 2.0f);
+        }
+
+        float timeline_height = std::max(height * 0.12f, 60.0f);
+        SDL_FRect area = {20.0f, height - timeline_height - 20.0f, width - 40.0f, timeline_height};
+        timeline.draw(renderer, hud, pyramid, area, time_us);
+
+        hud.flush();
+        SDL_FlushRenderer(renderer);
+    }
+}
+
+bool OfflineRenderer::render(const SessionReplay& replay, const std::string& output_path, const Options& options) {
+    if (!replay.is_open() || replay.sample_count() == 0) {
+        LOG_ERROR("[Render] Nothing to render: the session is empty");
+        return false;
+    }
+
+    const int width = std::max(options.width, 16);
+    const int height = std::max(options.height, 16);
+    const int fps = std::max(options.fps, 1);
+    const int64_t start_us = replay.start_time_us();
+    const int64_t end_us = replay.end_time_us();
+
+    const size_t frame_count = static_cast<size_t>((end_us - start_us) * fps / 1000000) + 1;
+
+    VideoWriter writer;
+    if (!writer.open(output_path, width, height, fps)) return false;
+    const VideoWriter::Format format = writer.format();
+
+    // Cores are split between frames in flight and tiles within a frame
+    unsigned total_threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    unsigned tile_threads = std::clamp(options.tile_threads, 1u, total_threads);
+    unsigned frame_threads = std::max(total_threads / tile_threads, 1u);
+
+    // Frames taken by workers but not yet written are bounded in bytes: as many worst-case frames
+    // as fit in MAX_BUFFERED_BYTES (but at least one per worker). Chunks shrink so that every
+    // worker, and then some look-ahead, fits in that budget.
+    const size_t frame_bytes = VideoWriter::max_encoded_bytes(format, width, height);
+    const size_t max_frames_ahead = std::max<size_t>(MAX_BUFFERED_BYTES / frame_bytes, frame_threads);
+    const size_t chunk_frames = std::clamp<size_t>(max_frames_ahead / (static_cast<size_t>(frame_threads) * 2), 1,
+                                                   std::max<size_t>(options.chunk_frames, 1));
+    const size_t chunk_count = (frame_count + chunk_frames - 1) / chunk_frames;
+    const size_t max_ahead = std::max<size_t>(max_frames_ahead / chunk_frames, 1); // In chunks
+    unsigned threads = static_cast<unsigned>(std::min<size_t>(frame_threads, std::min(chunk_count, max_ahead)));
+
+    LOG_INFO("[Render] %llu frames (%dx%d @ %d FPS) on %u x %u threads -> %s",
+             static_cast<unsigned long long>(frame_count), width, height, fps, threads, tile_threads, output_path);
+    auto started = std::chrono::steady_clock::now();
+
+    std::vector<Chunk> chunks(chunk_count);
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t next_chunk = 0; // Next chunk a worker will take
+    size_t written = 0;    // Chunks the writer has finished
+    bool failed = false;
+
+    auto fail = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            failed = true;
+        }
+        cv.notify_all();
+    };
+
+    auto worker = [&]() {
+        // Everything SDL here is private to the thread: its own surface and software renderer
+        SDL_Surface* surface = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+        SDL_Renderer* renderer = surface != nullptr ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+        if (renderer == nullptr) {
+            LOG_ERROR("[Render] Cannot create a software renderer: %s", SDL_GetError());
+            if (surface != nullptr) SDL_DestroySurface(surface);
+            fail();
+            return;
+        }
+
+        {
+            std::unique_ptr<ThreadPool> tile_pool;
+            if (tile_threads > 1) tile_pool = std::make_unique<ThreadPool>(tile_threads);
+            SoftwareRasterizer rasterizer(tile_pool.get());
+            rasterizer.set_antialiasing(options.antialias);
+            rasterizer.set_target(static_cast<uint8_t*>(surface->pixels), width, height, surface->pitch);
+
+            RenderEngine engine(width, height, renderer);
+            engine.set_backend(&rasterizer);
+            engine.set_hidden_line_removal(options.hidden_lines);
+            engine.set_solid(options.solid);
+            HudText hud(renderer);
+            TimelineView timeline;
+            timeline.set_session(start_us, end_us);
+
+            // QOI is encoded into room for the worst case; the chunk keeps an exact-size copy
+            std::vector<uint8_t> encoded;
+
+            while (true) {
+                size_t k = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return failed || next_chunk >= chunk_count || next_chunk < written + max_ahead; });
+                    if (failed || next_chunk >= chunk_count) break;
+                    k = next_chunk++;
+                }
+
+                // Only this worker touches the chunk until it is marked done
+                Chunk& chunk = chunks[k];
+                size_t first = k * chunk_frames;
+                size_t last = std::min(first + chunk_frames, frame_count);
+                chunk.frames.resize(last - first);
+
+                for (size_t f = first; f < last; f++) {
+                    int64_t time_us = start_us + static_cast<int64_t>(f) * 1000000 / fps;
+                    TelemetrySample sample = {}, next = {};
+                    replay.samples_around(time_us, sample, next);
+
+                    // Frames fall between samples: the drone turns smoothly from one to the next (the HUD shows the sample)
+                    float t = 0.0f;
+                    if (next.timestamp_us > sample.timestamp_us) {
+                        t = std::clamp(static_cast<float>(time_us - sample.timestamp_us) / static_cast<float>(next.timestamp_us - sample.timestamp_us),
+                                       0.0f, 1.0f);
+                    }
+                    math3d::Quatf orientation = math3d::slerp(attitude_orientation(sample.attitude), attitude_orientation(next.attitude), t);
+
+                    draw_frame(engine, rasterizer, renderer, hud, timeline, replay.pyramid(), options.model, options.frame, sample, orientation,
+                               time_us, start_us, width, height);
+                    VideoWriter::encode_frame(format, static_cast<const uint8_t*>(surface->pixels), surface->pitch,
+                                              width, height, encoded);
+                    chunk.frames[f - first].assign(encoded.begin(), encoded.end());
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    chunk.done = true;
+                }
+                cv.notify_all();
+            }
+        }
+
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroySurface(surface);
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++) workers.emplace_back(worker);
+
+    // Write chunks in timeline order as they complete
+    size_t next_report = chunk_count / 10;
+    for (size_t k = 0; k < chunk_count; k++) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return chunks[k].done || failed; });
+            if (failed) break;
+        }
+
+        bool ok = true;
+        for (const std::vector<uint8_t>& frame : chunks[k].frames) {
+            if (!(ok = writer.write_encoded(frame))) break;
+        }
+        std::vector<std::vector<uint8_t>>().swap(chunks[k].frames);
+        if (!ok) {
+            fail();
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            written = k + 1;
+        }
+        cv.notify_all();
+
+        if (k + 1 >= next_report && k + 1 < chunk_count) {
+            LOG_INFO("[Render] %3d%%", static_cast<int>((k + 1) * 100 / chunk_count));
+            next_report += std::max<size_t>(chunk_count / 10, 1);
+        }
+    }
+
+    for (std::thread& t : workers) t.join();
+    if (!writer.close()) failed = true;
+
+    if (failed) {
+        LOG_ERROR("[Render] Stopped after %llu of %llu frames", static_cast<unsigned long long>(writer.frames_written()),
+                  static_cast<unsigned long long>(frame_count));
+        return false;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    LOG_INFO("[Render] Done: %llu frames in %.1f s (%.0f FPS, %.1fx real time)",
+             static_cast<unsigned long long>(frame_count), seconds, frame_count / seconds,
+             (end_us - start_us) / 1e6 / seconds);
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "airframe.h"
+#include "session_replay.h"
+#include "video_writer.h"
+
+class MeshLod;
+
+/**
+ * @brief Renders a recorded session to a video file as fast as the cores allow, without a window or GPU.
+ *
+ * The session is cut into frames at a fixed rate and the frames into short
+ * ranges (chunks). Each worker thread owns an SDL software renderer drawing
+ * into its own surface, takes the next chunk, looks every frame's sample up
+ * with SessionReplay::sample_at(), draws it and encodes it (VideoWriter) on
+ * the spot. The wireframe goes through a SoftwareRasterizer straight into the
+ * surface; SDL's renderer only draws the background and text. The calling
+ * thread writes finished chunks strictly in order.
+ *
+ * Frames encoded but not yet written are bounded in bytes (counted at their
+ * worst-case encoded size), so memory stays under a fixed budget however long
+ * the flight is and whatever the frame size and thread count.
+ */
+class OfflineRenderer {
+public:
+    struct Options {
+        int width = 1280;
+        int height = 720;
+        int fps = 60;
+        unsigned threads = 0;     // 0 = one per hardware core
+        unsigned tile_threads = 1; // Threads rasterizing each frame; threads / tile_threads frames render at once
+        size_t chunk_frames = 16; // Frames per range handed to a worker (at most; large frames get smaller chunks)
+        bool antialias = true;    // Coverage-based smooth line edges (SoftwareRasterizer::set_antialiasing)
+        bool hidden_lines = false; // Hidden-line removal (RenderEngine::set_hidden_line_removal)
+        bool solid = false;        // Shaded solid surfaces (RenderEngine::set_solid)
+        const MeshLod* model = nullptr; // Loaded airframe drawn instead of the built-in drone (not owned)
+        FrameType frame = FrameType::QuadX; // Built-in airframe layout
+    };
+
+    // Blocks until every frame is written; false if the output could not be written or a worker failed
+    static bool render(const SessionReplay& replay, const std::string& output_path, const Options& options);
+};
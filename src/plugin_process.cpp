@@ -0,0 +1,131 @@
+#include "plugin_process.h"
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <signal.h>
+    #include <spawn.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    extern char** environ;
+#endif
+
+PluginProcess::~PluginProcess() {
+    terminate();
+}
+
+#ifdef _WIN32
+
+bool PluginProcess::spawn(const std::vector<std::string>& args) {
+    terminate();
+
+    char exe_path[MAX_PATH];
+    DWORD len = GetModuleFileNameA(nullptr, exe_path, MAX_PATH);
+    if (len == 0 || len == MAX_PATH) return false;
+
+    // Windows wants one command line string, quote every argument
+    std::string cmd = "\"" + std::string(exe_path) + "\"";
+    for (const auto& arg : args) cmd += " \"" + arg + "\"";
+
+    // The job object kills the child together with us, even if we crash
+    HANDLE job = CreateJobObjectA(nullptr, nullptr);
+    if (job) {
+        JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = {};
+        limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+        SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+    }
+
+    STARTUPINFOA si = {};
+    si.cb = sizeof(si);
+    PROCESS_INFORMATION pi = {};
+
+    if (!CreateProcessA(exe_path, cmd.data(), nullptr, nullptr, FALSE, CREATE_SUSPENDED,
+                        nullptr, nullptr, &si, &pi)) {
+        if (job) CloseHandle(job);
+        return false;
+    }
+
+    if (job) AssignProcessToJobObject(job, pi.hProcess);
+    ResumeThread(pi.hThread);
+    CloseHandle(pi.hThread);
+
+    m_process = pi.hProcess;
+    m_job = job;
+    return true;
+}
+
+bool PluginProcess::is_running() {
+    if (m_process == nullptr) return false;
+    return WaitForSingleObject(static_cast<HANDLE>(m_process), 0) == WAIT_TIMEOUT;
+}
+
+void PluginProcess::terminate() {
+    if (m_process) {
+        TerminateProcess(static_cast<HANDLE>(m_process), 1);
+        WaitForSingleObject(static_cast<HANDLE>(m_process), INFINITE);
+        CloseHandle(static_cast<HANDLE>(m_process));
+        m_process = nullptr;
+    }
+    if (m_job) {
+        CloseHandle(static_cast<HANDLE>(m_job));
+        m_job = nullptr;
+    }
+}
+
+void PluginProcess::stop(unsigned timeout_ms) {
+    if (m_process) WaitForSingleObject(static_cast<HANDLE>(m_process), timeout_ms);
+    terminate();
+}
+
+#else
+
+bool PluginProcess::spawn(const std::vector<std::string>& args) {
+    terminate();
+
+    // /proc/self/exe always points at the running binary, wherever it was started from
+    std::vector<char*> argv;
+    std::string self = "/proc/self/exe";
+    argv.push_back(self.data());
+    std::vector<std::string> copies = args;
+    for (auto& arg : copies) argv.push_back(arg.data());
+    argv.push_back(nullptr);
+
+    pid_t pid = -1;
+    if (posix_spawn(&pid, self.c_str(), nullptr, nullptr, argv.data(), environ) != 0) return false;
+
+    m_pid = pid;
+    return true;
+}
+
+bool PluginProcess::is_running() {
+    if (m_pid <= 0) return false;
+
+    int status = 0;
+    if (waitpid(m_pid, &status, WNOHANG) == m_pid) {
+        m_pid = -1; // Reaped, the child is gone
+        return false;
+    }
+    return true;
+}
+
+void PluginProcess::terminate() {
+    if (m_pid <= 0) return;
+
+    kill(m_pid, SIGKILL);
+    waitpid(m_pid, nullptr, 0);
+    m_pid = -1;
+}
+
+void PluginProcess::stop(unsigned timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (is_running() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    terminate();
+}
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Owns one child process running this same executable in plugin-host mode.
+ * The child is killed when this object is destroyed, and on Windows it is
+ * placed in a job object so it also dies if the renderer crashes.
+ */
+class PluginProcess {
+public:
+    PluginProcess() = default;
+    ~PluginProcess();
+
+    PluginProcess(const PluginProcess&) = delete;
+    PluginProcess& operator=(const PluginProcess&) = delete;
+
+    // Launches the current executable with the given arguments
+    bool spawn(const std::vector<std::string>& args);
+
+    // True while the child has not exited
+    bool is_running();
+
+    // Asks the OS to kill the child and reaps it
+    void terminate();
+
+    // Waits up to timeout_ms for a voluntary exit, kills it afterwards
+    void stop(unsigned timeout_ms);
+
+private:
+#ifdef _WIN32
+    void* m_process = nullptr; // HANDLE
+    void* m_job = nullptr;     // HANDLE
+#else
+    int m_pid = -1;
+#endif
+};
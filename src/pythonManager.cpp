@@ -1,87 +1,397 @@
 #include "pythonManager.h"
+#include "logger.h"
+#include "msp_native.h"
+#include "session_recorder.h"
+#include <chrono>
+#include <cstdlib>
 
-PythonManager::PythonManager(const std::string& moduleName) {
-    std::cout << "[Manager] Initializing Python Interpreter..." << std::endl;
-    
-    // Start the embedded Python interpreter
-    Py_Initialize();
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
 
-    // Append standard paths so Python knows where to find your custom scripts.
-    // Modify these paths if your folder structure changes.
-    PyRun_SimpleString("import sys; sys.path.extend(['./python_scripts', '../python_scripts'])");
+namespace {
+    // How long the plugin host may go without a heartbeat before we consider it hung
+    constexpr auto HOST_STALL_TIMEOUT = std::chrono::seconds(3);
+
+    // Pause between restart attempts so a plugin that crashes on import does not spin
+    constexpr auto HOST_RESTART_BACKOFF = std::chrono::seconds(1);
+
+    // Room for a few seconds of kHz telemetry if the renderer falls behind
+    constexpr uint32_t RING_CAPACITY = 4096;
+
+    int current_pid() {
+#ifdef _WIN32
+        return static_cast<int>(GetCurrentProcessId());
+#else
+        return static_cast<int>(getpid());
+#endif
+    }
+}
+
+PythonManager::PythonManager(const std::string& moduleName, TelemetryMailbox& mailbox, PluginMode mode)
+    : m_mode(mode), m_moduleName(moduleName), m_mailbox(mailbox) {
+
+    if (m_mode == PluginMode::InProcess) {
+        initInterpreter();
+
+        // Hand the GIL over so the worker thread can import the module while we render.
+        // Importing drone_telemetry pulls in pyserial, which is the slow part of startup.
+        m_mainState = PyEval_SaveThread();
+
+        m_running = true;
+        m_worker = std::thread(&PythonManager::pollLoop, this);
+        return;
+    }
+
+    LOG_INFO("[Manager] Starting out-of-process plugin host...");
+
+    // Name is unique per renderer instance so two DroneApps don't share a ring
+#ifdef _WIN32
+    std::string ringName = "Local\\droneapp_telemetry_" + std::to_string(current_pid());
+#else
+    std::string ringName = "/droneapp_telemetry_" + std::to_string(current_pid());
+#endif
+
+    if (!m_ring.create(ringName, RING_CAPACITY)) {
+        throw std::runtime_error("Failed to create shared telemetry ring: " + ringName);
+    }
+    if (!spawnHost()) {
+        throw std::runtime_error("Failed to launch plugin host for module: " + moduleName);
+    }
+
+    m_ready = true;
+    m_running = true;
+    m_worker = std::thread(&PythonManager::readerLoop, this);
+}
+
+PythonManager::~PythonManager() {
+    m_running = false;
+    if (m_worker.joinable()) m_worker.join();
+
+    if (m_mode == PluginMode::OutOfProcess) {
+        LOG_INFO("[Manager] Stopping plugin host...");
+
+        // Give the child a moment to close the COM port cleanly, then kill it
+        m_ring.request_shutdown();
+        m_host.stop(500);
+        return;
+    }
+
+    LOG_INFO("[Manager] Shutting down Python Interpreter...");
+
+    // Take the GIL back from the (now finished) worker
+    PyEval_RestoreThread(m_mainState);
+
+    // We MUST release the module before calling Py_FinalizeEx,
+    // otherwise Python will try to clean up memory that is already destroyed.
+    m_pModule.reset();
+    Py_FinalizeEx();
+}
+
+void PythonManager::initInterpreter() {
+    LOG_INFO("[Manager] Initializing Python Interpreter...");
+    auto start = std::chrono::steady_clock::now();
+
+    // Built-in modules have to be registered before the interpreter starts
+    register_msp_native_module();
+
+    // Isolated config: ignores PYTHON* environment variables and the user site directory,
+    // and skips "import site" (which scans every .pth file in site-packages).
+    PyConfig config;
+    PyConfig_InitIsolatedConfig(&config);
+    config.site_import = 0;
+
+    // Explicit module search path, so Python does not have to probe the disk to compute one.
+    // Our scripts come first, then the stdlib and site-packages found by CMake (pyserial lives there).
+    std::vector<std::string> paths = {"./python_scripts", "../python_scripts"};
+#ifdef DRONE_PYTHON_STDLIB
+    paths.push_back(DRONE_PYTHON_STDLIB);
+    paths.push_back(DRONE_PYTHON_STDARCH);
+#ifdef DRONE_PYTHON_DLLS
+    paths.push_back(DRONE_PYTHON_DLLS);
+#endif
+    paths.push_back(DRONE_PYTHON_SITELIB);
+    config.module_search_paths_set = 1;
+#endif
+
+    // Isolated mode ignores PYTHONPATH, so field installs get their own override
+    if (const char* extra = std::getenv("DRONEAPP_PYTHONPATH")) {
+        std::string list = extra;
+#ifdef _WIN32
+        const char sep = ';';
+#else
+        const char sep = ':';
+#endif
+        size_t pos = 0;
+        while (pos <= list.size()) {
+            size_t next = list.find(sep, pos);
+            if (next == std::string::npos) next = list.size();
+            if (next > pos) paths.push_back(list.substr(pos, next - pos));
+            pos = next + 1;
+        }
+    }
+
+    PyStatus status = PyStatus_Ok();
+    for (const auto& path : paths) {
+        wchar_t* wide = Py_DecodeLocale(path.c_str(), nullptr);
+        if (wide == nullptr) continue;
+        status = PyWideStringList_Append(&config.module_search_paths, wide);
+        PyMem_RawFree(wide);
+        if (PyStatus_Exception(status)) break;
+    }
+
+    if (!PyStatus_Exception(status)) {
+        status = Py_InitializeFromConfig(&config);
+    }
+    PyConfig_Clear(&config);
+
+    if (PyStatus_Exception(status)) {
+        throw std::runtime_error(std::string("Failed to initialize Python: ") +
+                                 (status.err_msg ? status.err_msg : "unknown error"));
+    }
+
+#ifndef DRONE_PYTHON_STDLIB
+    // No paths from the build system: Python computed the stdlib path itself, add our scripts in front
+    PyObject* sysPath = PySys_GetObject("path"); // Borrowed reference
+    for (auto it = paths.rbegin(); it != paths.rend(); ++it) {
+        SmartPyPtr entry(PyUnicode_DecodeFSDefault(it->c_str()));
+        if (sysPath && entry) PyList_Insert(sysPath, 0, entry.get());
+    }
+#endif
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("[Manager] Interpreter ready in %.1f ms", elapsed.count());
+}
+
+SmartPyPtr PythonManager::importModule(const std::string& moduleName) {
+    auto start = std::chrono::steady_clock::now();
 
     // Convert the C++ string to a Python Unicode object
     SmartPyPtr pName(PyUnicode_DecodeFSDefault(moduleName.c_str()));
-    
-    // Import the module (the .py file) and store it in our class member
-    m_pModule.reset(PyImport_Import(pName.get()));
+
+    // Import the module (the .py file)
+    SmartPyPtr module(PyImport_Import(pName.get()));
 
     // Error handling if the script is missing or has a syntax error
-    if (!m_pModule) {
+    if (!module) {
         PyErr_Print();
         throw std::runtime_error("Failed to load Python module: " + moduleName);
     }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("[Manager] Imported '%s' in %.1f ms", moduleName, elapsed.count());
+    return module;
 }
 
-PythonManager::~PythonManager() {
-    std::cout << "[Manager] Shutting down Python Interpreter..." << std::endl;
-    
-    // We MUST release the module before calling Py_FinalizeEx, 
-    // otherwise Python will try to clean up memory that is already destroyed.
-    m_pModule.reset(); 
+void PythonManager::pollLoop() {
+    PyGILState_STATE gil = PyGILState_Ensure();
+    try {
+        m_pModule = importModule(m_moduleName);
+    } catch (const std::exception& e) {
+        // Keep rendering without telemetry rather than killing the app
+        LOG_ERROR("[Manager] %s", e.what());
+        PyGILState_Release(gil);
+        return;
+    }
+    m_ready = true;
+    PyGILState_Release(gil);
+
+    while (m_running) {
+        bool ok = false;
+        TelemetrySample sample;
+
+        // Hold the GIL only for the call itself so callStringFunc()/sendCommand() can get in
+        gil = PyGILState_Ensure();
+        sample.attitude = pollAttitude(m_pModule.get(), &ok);
+        PyGILState_Release(gil);
+
+        sample.timestamp_us = telemetry_now_us();
+        // A failed poll has no attitude; publishing or recording it would snap the model level
+        if (ok) {
+            m_mailbox.publish(sample);
+            if (SessionRecorder* recorder = m_recorder.load()) recorder->record(sample);
+        }
+
+        // A plugin that keeps raising (e.g. no serial port) would otherwise spin a core
+        if (!ok) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+bool PythonManager::spawnHost() {
+    return m_host.spawn({"--plugin-host", m_moduleName, m_ring.name()});
+}
+
+void PythonManager::readerLoop() {
+    using clock = std::chrono::steady_clock;
+
+    uint64_t lastBeat = m_ring.heartbeat();
+    auto lastProgress = clock::now();
+
+    while (m_running) {
+        // Sleep until the child pushes (or 100 ms pass so we can run the health checks)
+        if (m_ring.wait(100)) {
+            TelemetrySample sample;
+            SessionRecorder* recorder = m_recorder.load();
+            while (m_ring.pop(sample)) {
+                m_mailbox.publish(sample);
+                if (recorder) recorder->record(sample);
+            }
+        }
+
+        // --- Fault isolation: restart a crashed or hung plugin ---
+        uint64_t beat = m_ring.heartbeat();
+        if (beat != lastBeat) {
+            lastBeat = beat;
+            lastProgress = clock::now();
+            continue;
+        }
+
+        bool crashed = !m_host.is_running();
+        bool hung = clock::now() - lastProgress > HOST_STALL_TIMEOUT;
+        if (!crashed && !hung) continue;
+
+        LOG_WARN("[Manager] Plugin host %s, restarting...", crashed ? "exited" : "stopped responding");
+        m_host.terminate();
+        std::this_thread::sleep_for(HOST_RESTART_BACKOFF);
+
+        if (!spawnHost()) {
+            LOG_ERROR("[Manager] Failed to restart plugin host");
+        }
+        lastProgress = clock::now();
+    }
+}
+
+int PythonManager::runPluginHost(const std::string& moduleName, const std::string& ringName) {
+#ifndef _WIN32
+    // Die with the renderer instead of lingering as an orphan holding the COM port. Not
+    // PR_SET_PDEATHSIG: it fires when the spawning *thread* exits, and restarts are spawned
+    // from the reader thread, which is joined before the graceful shutdown below can run.
+    const pid_t parent = getppid();
+    if (parent == 1) return 1;
+#endif
+
+    SharedTelemetryRing ring;
+    if (!ring.open(ringName)) {
+        LOG_ERROR("[PluginHost] Failed to open telemetry ring: %s", ringName);
+        return 1;
+    }
+
+    int exitCode = 0;
+    try {
+        // The host is a separate process, so importing synchronously costs the renderer nothing
+        initInterpreter();
+        SmartPyPtr module = importModule(moduleName);
+
+        while (!ring.shutdown_requested()) {
+#ifndef _WIN32
+            if (getppid() != parent) break; // Reparented: the renderer is gone
+#endif
+            bool ok = false;
+            TelemetrySample sample;
+            sample.attitude = pollAttitude(module.get(), &ok);
+            sample.timestamp_us = telemetry_now_us();
+            // A failed poll has no attitude; pushing it would snap the model level. Still beat,
+            // or the renderer takes a plugin waiting for its FC as hung and keeps restarting it.
+            if (ok) {
+                ring.push(sample);
+            } else {
+                ring.beat();
+                // A plugin that keeps raising (e.g. no serial port) would otherwise spin a core
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+
+        module.reset();
+    } catch (const std::exception& e) {
+        LOG_ERROR("[PluginHost] %s", e.what());
+        exitCode = 1;
+    }
+
     Py_FinalizeEx();
+    return exitCode;
 }
 
 std::string PythonManager::callStringFunc(const std::string& funcName) {
-    // Look up the function by name inside our loaded module
-    SmartPyPtr pFunc(PyObject_GetAttrString(m_pModule.get(), funcName.c_str()));
+    // The module lives in another process in OutOfProcess mode, or is still importing
+    if (m_mode == PluginMode::OutOfProcess || !m_ready) return "ERROR";
 
-    // Check if the function exists and is actually callable
-    if (pFunc && PyCallable_Check(pFunc.get())) {
-        SmartPyPtr pValue(PyObject_CallObject(pFunc.get(), nullptr));
-        
-        // If the function returned a value, convert it to a C++ UTF-8 string
-        if (pValue) {
-            return PyUnicode_AsUTF8(pValue.get());
+    PyGILState_STATE gil = PyGILState_Ensure();
+    std::string result = "ERROR";
+    {
+        // Look up the function by name inside our loaded module.
+        // (Scoped so the SmartPyPtrs are released before we give the GIL back.)
+        SmartPyPtr pFunc(PyObject_GetAttrString(m_pModule.get(), funcName.c_str()));
+
+        // Check if the function exists and is actually callable
+        if (pFunc && PyCallable_Check(pFunc.get())) {
+            SmartPyPtr pValue(PyObject_CallObject(pFunc.get(), nullptr));
+
+            // If the function returned a value, convert it to a C++ UTF-8 string
+            if (pValue) {
+                const char* text = PyUnicode_AsUTF8(pValue.get());
+                if (text) result = text;
+            }
         }
+
+        if (PyErr_Occurred()) PyErr_Print();
     }
-    
-    PyErr_Print();
-    return "ERROR";
+    PyGILState_Release(gil);
+    return result;
 }
 
 void PythonManager::sendCommand(const std::string& funcName, const std::string& arg) {
-    SmartPyPtr pFunc(PyObject_GetAttrString(m_pModule.get(), funcName.c_str()));
+    if (m_mode == PluginMode::OutOfProcess || !m_ready) return;
 
-    if (pFunc && PyCallable_Check(pFunc.get())) {
-        // Create a tuple to hold our arguments (size 1)
-        SmartPyPtr pArgs(PyTuple_New(1));
-        
-        // Convert C++ string to Python string and pack it into the tuple.
-        // Note: PyTuple_SetItem "steals" the reference, so we don't need a SmartPyPtr for the string itself.
-        PyTuple_SetItem(pArgs.get(), 0, PyUnicode_FromString(arg.c_str())); 
+    PyGILState_STATE gil = PyGILState_Ensure();
+    {
+        SmartPyPtr pFunc(PyObject_GetAttrString(m_pModule.get(), funcName.c_str()));
 
-        // Execute the function
-        SmartPyPtr pResult(PyObject_CallObject(pFunc.get(), pArgs.get()));
+        if (pFunc && PyCallable_Check(pFunc.get())) {
+            // Create a tuple to hold our arguments (size 1)
+            SmartPyPtr pArgs(PyTuple_New(1));
+
+            // Convert C++ string to Python string and pack it into the tuple.
+            // Note: PyTuple_SetItem "steals" the reference, so we don't need a SmartPyPtr for the string itself.
+            PyTuple_SetItem(pArgs.get(), 0, PyUnicode_FromString(arg.c_str()));
+
+            // Execute the function
+            SmartPyPtr pResult(PyObject_CallObject(pFunc.get(), pArgs.get()));
+        }
+
+        if (PyErr_Occurred()) PyErr_Print();
     }
+    PyGILState_Release(gil);
 }
 
 DroneTelemetry PythonManager::getTelemetry() {
+    // Both modes publish from their worker thread; the caller never touches Python
+    TelemetrySample sample;
+    if (m_mailbox.read(sample)) return sample.attitude;
+    return {0.0, 0.0, 0.0};
+}
+
+DroneTelemetry PythonManager::pollAttitude(PyObject* module, bool* ok) {
     // Initialize with safe defaults (zeros) in case of communication failure
     DroneTelemetry data = {0.0, 0.0, 0.0};
+    if (ok) *ok = false;
 
     // 1. Target the specific telemetry gathering function
-    SmartPyPtr pFunc(PyObject_GetAttrString(m_pModule.get(), "get_drone_attitude"));
+    SmartPyPtr pFunc(PyObject_GetAttrString(module, "get_drone_attitude"));
 
     if (pFunc && PyCallable_Check(pFunc.get())) {
         // 2. Execute it. We expect a Python Dictionary in return.
         SmartPyPtr pDict(PyObject_CallObject(pFunc.get(), nullptr));
 
-        // 3. Ensure we actually got a dictionary object back to avoid crashes
+        // 3. Ensure we actually got a dictionary object back to avoid crashes.
+        //    None means "no data this time" and leaves ok false.
         if (pDict && PyDict_Check(pDict.get())) {
-            
+
             // Extract the values using string keys.
-            // WARNING: PyDict_GetItemString returns a BORROWED reference. 
+            // WARNING: PyDict_GetItemString returns a BORROWED reference.
             // We do NOT use SmartPyPtr here because we don't own these pointers, Python does.
             PyObject* pRoll  = PyDict_GetItemString(pDict.get(), "roll");
             PyObject* pPitch = PyDict_GetItemString(pDict.get(), "pitch");
@@ -95,6 +405,7 @@ DroneTelemetry PythonManager::getTelemetry() {
             // If any conversion failed (e.g., data wasn't a number), Python flags an error state.
             // We clear it here so it doesn't break the next loop iteration.
             if (PyErr_Occurred()) PyErr_Clear();
+            else if (ok) *ok = true;
 
         } else if (PyErr_Occurred()) {
             PyErr_Print();
@@ -104,4 +415,4 @@ DroneTelemetry PythonManager::getTelemetry() {
     }
 
     return data;
-}
\ No newline at end of file
+}
@@ -4,10 +4,19 @@
 // It ensures that Python uses the correct memory size types for your 64-bit system.
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
+#include "plugin_process.h"
+#include "shared_ring.h"
+#include "telemetry.h"
+#include "telemetry_mailbox.h"
+
+class SessionRecorder;
 
 /**
  * @brief Custom deleter for std::unique_ptr to handle Python objects.
@@ -24,12 +33,15 @@ struct PyObjectDeleter {
 using SmartPyPtr = std::unique_ptr<PyObject, PyObjectDeleter>;  
 
 /**
- * @brief Data structure to hold standard drone attitude telemetry.
+ * @brief Where the Python plugin runs.
+ * InProcess embeds the interpreter inside DroneApp (lowest overhead).
+ * OutOfProcess launches DroneApp again in plugin-host mode and reads samples
+ * back through a shared-memory ring, so a crashing or hanging plugin cannot
+ * take the renderer down with it.
  */
-struct DroneTelemetry {
-    double roll;
-    double pitch;
-    double yaw;
+enum class PluginMode {
+    InProcess,
+    OutOfProcess
 };
 
 /**
@@ -38,8 +50,10 @@ struct DroneTelemetry {
  */
 class PythonManager { 
 public:
-    // Initializes the Python environment and loads the specified module (.py script)
-    PythonManager(const std::string& moduleName);
+    // Initializes the Python environment and starts loading the specified module (.py script)
+    // on a background thread. Every sample the plugin produces is published to the mailbox.
+    // In OutOfProcess mode the interpreter lives in a child process instead.
+    PythonManager(const std::string& moduleName, TelemetryMailbox& mailbox, PluginMode mode = PluginMode::InProcess);
     
     // Cleans up the Python environment upon destruction
     ~PythonManager();
@@ -50,10 +64,55 @@ public:
     // Sends a string argument to a specific Python function
     void sendCommand(const std::string& funcName, const std::string& arg);
 
-    // Specific bridge to pull the Roll, Pitch, and Yaw dictionary from Python
+    // Latest Roll, Pitch, and Yaw published by the plugin (zeros until the first sample)
     DroneTelemetry getTelemetry();
 
+    // Every sample is also handed to this recorder (nullptr stops recording).
+    // The recorder must outlive this manager or be detached first.
+    void setRecorder(SessionRecorder* recorder) { m_recorder = recorder; }
+
+    // True once the plugin module has been imported (InProcess) or the host started (OutOfProcess)
+    bool isReady() const { return m_ready; }
+
+    // Entry point of the child process in OutOfProcess mode.
+    // Runs the plugin and pushes every sample into the named shared ring until told to stop.
+    static int runPluginHost(const std::string& moduleName, const std::string& ringName);
+
 private:
-    // Holds the loaded Python script module in memory
+    // Starts an isolated interpreter: no site import, explicit module search path
+    static void initInterpreter();
+
+    // Imports the plugin module (the GIL must be held)
+    static SmartPyPtr importModule(const std::string& moduleName);
+
+    // Calls get_drone_attitude() on the module and converts the returned dict.
+    // ok (optional) reports whether the call produced valid numbers.
+    static DroneTelemetry pollAttitude(PyObject* module, bool* ok = nullptr);
+
+    // InProcess: imports the module and polls it, off the render thread
+    void pollLoop();
+
+    // OutOfProcess: spawns the plugin host, watches it and drains the ring
+    bool spawnHost();
+    void readerLoop();
+
+    PluginMode m_mode;
+    std::string m_moduleName;
+    TelemetryMailbox& m_mailbox;
+
+    // Holds the loaded Python script module in memory (InProcess only)
     SmartPyPtr m_pModule;
+
+    // Thread state saved when the constructor hands the GIL to the worker (InProcess only)
+    PyThreadState* m_mainState = nullptr;
+
+    // OutOfProcess state
+    SharedTelemetryRing m_ring;
+    PluginProcess m_host;
+
+    // Worker thread: pollLoop() or readerLoop() depending on the mode
+    std::thread m_worker;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_ready{false};
+    std::atomic<SessionRecorder*> m_recorder{nullptr};
 };
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+/**
+ * @brief Where RenderEngine sends its triangles when it is not drawing through SDL directly.
+ *
+ * Same contract as SDL_RenderGeometry without a texture: indexed triangles,
+ * one color per vertex, positions in pixels. An implementation may queue the
+ * triangles and draw them later, as long as it keeps their submission order.
+ */
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual void geometry(const SDL_Vertex* vertices, int vertex_count, const int* indices, int index_count) = 0;
+
+    // A line segment with butt ends (the same shape as RenderEngine's quads). Backends that draw lines
+    // better than two triangles return true; false means "send me the quad instead".
+    virtual bool thick_line(SDL_FPoint /*p1*/, SDL_FPoint /*p2*/, float /*thickness*/, SDL_FColor /*color*/) {
+        return false;
+    }
+};
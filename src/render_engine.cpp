@@ -1,7 +1,54 @@
 #include "render_engine.h"
+#include <algorithm>
 #include <iostream>
 #include <numbers> // For std::numbers::pi_v
 #include <cmath>
+#include <cstring>
+#include <array>
+#include "math3d.h"
+#include "mesh.h"
+#include "mesh_lod.h"
+
+namespace {
+    // View-space depth below which geometry is cut off (or skipped, for occluders)
+    constexpr float NEAR_Z = 0.05f;
+
+    // Solid shading: direction towards the light in view space (up, left, behind the camera), normalized
+    constexpr float LIGHT_X = -0.331f, LIGHT_Y = 0.497f, LIGHT_Z = -0.802f;
+    constexpr float AMBIENT = 0.3f;
+
+    // Clip space to pixels: the perspective divide (w is the view-space depth)
+    RenderEngine::Point_2D clip_to_screen(const math3d::Vec4f& c) {
+        float inv_w = 1.0f / c.w;
+        return {c.x * inv_w, c.y * inv_w};
+    }
+
+    // The rotation part of a model matrix
+    math3d::Mat3f rotation_of(const math3d::Mat4f& m) {
+        return {{{m.c[0].x, m.c[0].y, m.c[0].z}, {m.c[1].x, m.c[1].y, m.c[1].z}, {m.c[2].x, m.c[2].y, m.c[2].z}}};
+    }
+
+    // LSD radix sort of (key << 32 | value) items by key, 8 bits per pass.
+    // Passes where every key has the same byte (usually the top ones) are skipped.
+    void radix_sort_by_key(std::vector<uint64_t>& items, std::vector<uint64_t>& scratch) {
+        if (items.empty()) return;
+        scratch.resize(items.size());
+        for (int shift = 32; shift < 64; shift += 8) {
+            size_t count[256] = {};
+            for (uint64_t item : items) count[(item >> shift) & 0xFF]++;
+            if (count[(items[0] >> shift) & 0xFF] == items.size()) continue;
+
+            size_t offset = 0;
+            for (size_t& c : count) {
+                size_t n = c;
+                c = offset;
+                offset += n;
+            }
+            for (uint64_t item : items) scratch[count[(item >> shift) & 0xFF]++] = item;
+            items.swap(scratch);
+        }
+    }
+}
 
 RenderEngine::RenderEngine(int w, int h, SDL_Renderer* r) {
     // Constructor - Sets variables to given values
@@ -9,6 +56,25 @@ RenderEngine::RenderEngine(int w, int h, SDL_Renderer* r) {
     this->width = w;
     this->height = h; 
     this->renderer = r;
+
+    // to_screen() as a matrix: pixel x = x / z * h/2 + w/2 (the aspect correction folded in),
+    // pixel y = -y / z * h/2 + h/2; the depth goes to both z and w
+    float half_w = 0.5f * static_cast<float>(w), half_h = 0.5f * static_cast<float>(h);
+    this->projection = {{{half_h, 0.0f, 0.0f, 0.0f}, {0.0f, -half_h, 0.0f, 0.0f}, {half_w, half_h, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 0.0f}}};
+}
+
+void RenderEngine::set_backend(RenderBackend* b) {
+    this->backend = b;
+}
+
+void RenderEngine::submit_geometry(const SDL_Vertex* vertices, int vertex_count, const int* indices, int index_count) {
+    // Either straight to SDL, or to the backend which may queue it and rasterize it later itself
+
+    if (backend != nullptr) {
+        backend->geometry(vertices, vertex_count, indices, index_count);
+    } else {
+        SDL_RenderGeometry(renderer, nullptr, vertices, vertex_count, indices, index_count);
+    }
 }
 
 float RenderEngine::to_radians(float degrees) {
@@ -41,6 +107,16 @@ void RenderEngine::point(Point_2D p) {
 
     const float scale = 25.0f;
 
+    if (backend != nullptr) {
+        // Same square as two triangles
+        SDL_FColor col = { 70 / 255.0f, 1.0f, 70 / 255.0f, 1.0f };
+        float l = p.x - scale/2, t = p.y - scale/2, r = l + scale, b = t + scale;
+        SDL_Vertex verts[4] = {{{l, t}, col, {0, 0}}, {{r, t}, col, {0, 0}}, {{l, b}, col, {0, 0}}, {{r, b}, col, {0, 0}}};
+        int indices[6] = { 0, 1, 2, 2, 1, 3 };
+        backend->geometry(verts, 4, indices, 6);
+        return;
+    }
+
     SDL_SetRenderDrawColor(renderer, 70, 255, 70, 255); 
     SDL_FRect rect = {  p.x - scale/2, p.y - scale/2, scale, scale}; 
     SDL_RenderFillRect(renderer, &rect);
@@ -87,12 +163,16 @@ void RenderEngine::draw_thick_line(Point_2D p1, Point_2D p2, float thickness) {
     
     if (length <= 0.0f) return;
 
+    SDL_FColor col = { 0.07f, 1.0f, 0.07f, 1.0f }; // SDL3 uses 0.0-1.0 for FColor
+
+    // A backend may draw the line itself (e.g. anti-aliased) instead of taking the quad
+    if (backend != nullptr && backend->thick_line({p1.x, p1.y}, {p2.x, p2.y}, thickness, col)) return;
+
     // Normal vector for thickness
     float nx = -dy / length * (thickness / 2.0f);
     float ny = dx / length * (thickness / 2.0f);
 
     SDL_Vertex verts[4];
-    SDL_FColor col = { 0.07f, 1.0f, 0.07f, 1.0f }; // SDL3 uses 0.0-1.0 for FColor
 
     // Vertex 0
     verts[0].position.x = p1.x + nx;
@@ -116,7 +196,7 @@ void RenderEngine::draw_thick_line(Point_2D p1, Point_2D p2, float thickness) {
 
     int indices[6] = { 0, 1, 2, 2, 1, 3 };
 
-    SDL_RenderGeometry(renderer, nullptr, verts, 4, indices, 6);
+    submit_geometry(verts, 4, indices, 6);
 }
 
 void RenderEngine::draw_filled_triangle(Point_2D p1, Point_2D p2, Point_2D p3) {
@@ -146,32 +226,398 @@ void RenderEngine::draw_filled_triangle(Point_2D p1, Point_2D p2, Point_2D p3) {
     // For a single triangle, the indices are just 0, 1, 2
     int indices[3] = { 0, 1, 2 };
 
-    SDL_RenderGeometry(renderer, nullptr, verts, 3, indices, 3);
+    submit_geometry(verts, 3, indices, 3);
 }
 
-RenderEngine::Point_3D RenderEngine::rotate_roll(const Point_3D& p, float angle) {
-    // Rotates the point around the Z-axis (tilting the drone left or right).
-    // Affects X and Y coordinates while Z remains unchanged.
+void RenderEngine::draw_polyline(const Point_2D* points, size_t count, float thickness, SDL_FColor color) {
+    /**
+     * Renders a connected line strip as ONE SDL_RenderGeometry call.
+     *
+     * Every segment becomes a quad like in draw_thick_line, but all quads go
+     * into one shared vertex buffer, so a trace with thousands of points costs
+     * a single submission instead of one per segment. The index pattern never
+     * changes, it is only extended when a longer line than before comes in.
+     */
 
-    float c = std::cos(angle);
-    float s = std::sin(angle);
-    return { p.x * c - p.y * s, p.x * s + p.y * c, p.z };
+    if (count < 2) return;
+    size_t segments = count - 1;
+
+    // Backends that draw lines themselves get the segments one by one
+    if (backend != nullptr && backend->thick_line({points[0].x, points[0].y}, {points[1].x, points[1].y}, thickness, color)) {
+        for (size_t i = 1; i < segments; i++) {
+            backend->thick_line({points[i].x, points[i].y}, {points[i + 1].x, points[i + 1].y}, thickness, color);
+        }
+        return;
+    }
+
+    polyline_vertices.resize(segments * 4);
+    if (polyline_indices.size() < segments * 6) {
+        size_t first = polyline_indices.size() / 6;
+        polyline_indices.resize(segments * 6);
+        for (size_t i = first; i < segments; i++) {
+            int v = static_cast<int>(i * 4);
+            int* idx = &polyline_indices[i * 6];
+            idx[0] = v; idx[1] = v + 1; idx[2] = v + 2;
+            idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+        }
+    }
+
+    float half = thickness / 2.0f;
+    size_t used = 0;
+    for (size_t i = 0; i < segments; i++) {
+        Point_2D p1 = points[i];
+        Point_2D p2 = points[i + 1];
+
+        float dx = p2.x - p1.x;
+        float dy = p2.y - p1.y;
+        float length = std::sqrt(dx * dx + dy * dy);
+        if (length <= 0.0f) continue;
+
+        // Normal vector for thickness
+        float nx = -dy / length * half;
+        float ny = dx / length * half;
+
+        SDL_Vertex* v = &polyline_vertices[used * 4];
+        v[0] = {{p1.x + nx, p1.y + ny}, color, {0.0f, 0.0f}};
+        v[1] = {{p1.x - nx, p1.y - ny}, color, {0.0f, 0.0f}};
+        v[2] = {{p2.x + nx, p2.y + ny}, color, {0.0f, 0.0f}};
+        v[3] = {{p2.x - nx, p2.y - ny}, color, {0.0f, 0.0f}};
+        used++;
+    }
+
+    if (used == 0) return;
+    submit_geometry(polyline_vertices.data(), static_cast<int>(used * 4),
+                    polyline_indices.data(), static_cast<int>(used * 6));
 }
 
-RenderEngine::Point_3D RenderEngine::rotate_pitch(const Point_3D& p, float angle) {
-    // Rotates the point around the X-axis (tilting the nose up or down).
-    // Affects Y and Z coordinates while X remains unchanged.
+RenderEngine::Point_2D RenderEngine::to_screen(const Point_3D& p) {
+    // Same steps the drone always took: perspective divide, squeeze X by the
+    // aspect ratio so the view is not stretched, then into pixels.
+
+    Point_2D projected = project(p);
+    projected.x /= static_cast<float>(width) / static_cast<float>(height);
+    return screen(projected);
+}
+
+void RenderEngine::set_hidden_line_removal(bool enabled) {
+    hidden_lines = enabled;
+    update_depth_buffer();
+}
 
-    float c = std::cos(angle);
-    float s = std::sin(angle);
-    return { p.x, p.y * c - p.z * s, p.y * s + p.z * c };
+void RenderEngine::set_solid(bool enabled) {
+    solid = enabled;
+    // Drop anything queued in the old mode; the order entries index into solid_faces
+    solid_faces.clear();
+    solid_order.clear();
+    update_depth_buffer();
 }
 
-RenderEngine::Point_3D RenderEngine::rotate_yaw(const Point_3D& p, float angle) {
-    // Rotates the point around the Y-axis (turning the nose left or right).
-    // Affects X and Z coordinates while Y remains unchanged.
+void RenderEngine::update_depth_buffer() {
+    // The depth buffer only exists while a mode using it is on
+    if (!depth_test()) {
+        depth = DepthBuffer();
+    } else if (depth.empty()) {
+        depth.resize(width, height);
+    }
+}
+
+void RenderEngine::clear_depth() {
+    if (depth_test()) depth.clear();
+}
+
+RenderEngine::Point_3D RenderEngine::camera_in_model(const Pose& pose) {
+    // The camera sits at the view-space origin. Undo the translation, then the
+    // rotation: its inverse is its transpose.
+
+    return math3d::transpose(rotation_of(pose.model)) * -pose.position;
+}
+
+size_t RenderEngine::select_lod(const MeshLod& lod, const Pose& pose, float tolerance) {
+    // The model fits in a sphere around its origin: no part comes nearer than its
+    // center's depth minus the radius. With the camera inside it, full detail.
+    float nearest = pose.position.z - lod.radius();
+    if (nearest < NEAR_Z) return 0;
+
+    // Pixels per model unit at that depth: to_screen maps y / z = 1 to half the
+    // screen height (and x the same, after the aspect correction)
+    float pixels_per_unit = 0.5f * static_cast<float>(height) / nearest;
+    size_t level = 0;
+    while (level + 1 < lod.level_count() && lod.error(level + 1) * pixels_per_unit <= tolerance) level++;
+    return level;
+}
+
+void RenderEngine::transform_mesh(const MeshView& mesh, const Pose& pose) {
+    // Model, view and projection are one matrix per call: every vertex is a
+    // single 4x4 multiply (SIMD, math3d::transform_points), then the divide.
+
+    math3d::Mat4f mvp = projection * pose.model;
+
+    size_t count = mesh.vertices.size();
+    clip_points.resize(count);
+    screen_points.resize(count);
+    math3d::transform_points(mvp, mesh.vertices.data(), clip_points.data(), count);
+    for (size_t i = 0; i < count; i++) {
+        screen_points[i] = clip_points[i].w >= NEAR_Z ? clip_to_screen(clip_points[i]) : Point_2D{0.0f, 0.0f};
+    }
+}
+
+void RenderEngine::add_occluder(const MeshView& mesh, const Pose& pose) {
+    // Faces into the coarse depth buffer. Faces reaching behind the near plane
+    // are left out: they hide a little less, never something in front of them.
+
+    if (!depth_test() || mesh.faces.empty()) return;
+    transform_mesh(mesh, pose);
+
+    for (const Mesh::Face& f : mesh.faces) {
+        float za = clip_points[f.a].w;
+        float zb = clip_points[f.b].w;
+        float zc = clip_points[f.c].w;
+        if (za < NEAR_Z || zb < NEAR_Z || zc < NEAR_Z) continue;
+
+        const Point_2D& sa = screen_points[f.a];
+        const Point_2D& sb = screen_points[f.b];
+        const Point_2D& sc = screen_points[f.c];
+        depth.add_triangle(sa.x, sa.y, 1.0f / za, sb.x, sb.y, 1.0f / zb, sc.x, sc.y, 1.0f / zc);
+    }
+}
+
+void RenderEngine::draw_mesh_edges(const MeshView& mesh, const Pose& pose, float thickness) {
+    draw_mesh_edges(mesh, mesh.edges.data(), mesh.edges.size(), pose, thickness);
+}
+
+void RenderEngine::draw_mesh_edges(const MeshView& mesh, const Edge* edges, size_t edge_count, const Pose& pose, float thickness) {
+    /**
+     * Draws the mesh's edges as thick lines.
+     *
+     * In hidden-line mode each edge is sampled about once per depth cell,
+     * every sample is tested against the depth buffer (1/z interpolates
+     * linearly along the projected edge), and each run of visible samples is
+     * drawn as its own line. Fully hidden edges cost no fill at all.
+     */
+
+    transform_mesh(mesh, pose);
+
+    for (size_t i = 0; i < edge_count; i++) {
+        const Edge& e = edges[i];
+        draw_clip_edge(clip_points[e.start], clip_points[e.end], screen_points[e.start], screen_points[e.end], thickness);
+    }
+}
+
+void RenderEngine::draw_clip_edge(math3d::Vec4f a, math3d::Vec4f b, Point_2D sa, Point_2D sb, float thickness) {
+    if (a.w < NEAR_Z && b.w < NEAR_Z) return;
+
+    // Cut the part behind the near plane off (clip coordinates are linear along the 3D line)
+    if (a.w < NEAR_Z || b.w < NEAR_Z) {
+        math3d::Vec4f& behind = a.w < NEAR_Z ? a : b;
+        const math3d::Vec4f& front = a.w < NEAR_Z ? b : a;
+        float t = (NEAR_Z - behind.w) / (front.w - behind.w);
+        behind = math3d::lerp(behind, front, t);
+        behind.w = NEAR_Z;
+        sa = clip_to_screen(a);
+        sb = clip_to_screen(b);
+    }
+
+    if (!depth_test()) {
+        draw_thick_line(sa, sb, thickness);
+        return;
+    }
+
+    float inv_za = 1.0f / a.w;
+    float inv_zb = 1.0f / b.w;
+    float dx = sb.x - sa.x;
+    float dy = sb.y - sa.y;
+    float length = std::sqrt(dx * dx + dy * dy);
+    int samples = std::clamp(static_cast<int>(length / depth.cell()) + 2, 2, 4096);
+    float step = 1.0f / (samples - 1);
+
+    // A fragment starts / ends halfway between a visible and a hidden sample
+    bool open = false;
+    float t_start = 0.0f;
+    for (int i = 0; i < samples; i++) {
+        float t = i * step;
+        bool vis = depth.visible(sa.x + dx * t, sa.y + dy * t, inv_za + (inv_zb - inv_za) * t);
+        if (vis && !open) {
+            t_start = i == 0 ? 0.0f : t - 0.5f * step;
+            open = true;
+        } else if (!vis && open) {
+            float t_end = t - 0.5f * step;
+            draw_thick_line({sa.x + dx * t_start, sa.y + dy * t_start}, {sa.x + dx * t_end, sa.y + dy * t_end}, thickness);
+            open = false;
+        }
+    }
+    if (open) draw_thick_line({sa.x + dx * t_start, sa.y + dy * t_start}, sb, thickness);
+}
+
+int RenderEngine::circle_segments(float radius_pixels, float tolerance) const {
+    // A chord over an angle of 2 pi / n lies r (1 - cos(pi / n)) inside the circle at its middle
+    int segments = MAX_CIRCLE_SEGMENTS;
+    if (!(radius_pixels < 1e6f)) return segments;
+    if (radius_pixels <= tolerance) return MIN_CIRCLE_SEGMENTS;
+    float half_angle = std::acos(1.0f - tolerance / radius_pixels);
+    if (half_angle > 0.0f) segments = static_cast<int>(std::min(std::ceil(PI / half_angle), (float)MAX_CIRCLE_SEGMENTS));
+
+    // Multiples of 4 keep rings symmetric and the number of tables small
+    segments = (segments + 3) / 4 * 4;
+    return std::clamp(segments, MIN_CIRCLE_SEGMENTS, MAX_CIRCLE_SEGMENTS);
+}
+
+namespace {
+    // Every unit circle draw_arc() can ask for (multiples of 4 from MIN_ to MAX_CIRCLE_SEGMENTS),
+    // back to back, segments + 1 points each: computed by the compiler
+    constexpr size_t circle_table_offset(int segments) {
+        size_t offset = 0;
+        for (int n = RenderEngine::MIN_CIRCLE_SEGMENTS; n < segments; n += 4) offset += static_cast<size_t>(n) + 1;
+        return offset;
+    }
+
+    constexpr size_t CIRCLE_TABLE_POINTS = circle_table_offset(RenderEngine::MAX_CIRCLE_SEGMENTS + 4);
+
+    constexpr std::array<RenderEngine::Point_2D, CIRCLE_TABLE_POINTS> make_circle_tables() {
+        std::array<RenderEngine::Point_2D, CIRCLE_TABLE_POINTS> tables{};
+        for (int n = RenderEngine::MIN_CIRCLE_SEGMENTS; n <= RenderEngine::MAX_CIRCLE_SEGMENTS; n += 4) {
+            size_t offset = circle_table_offset(n);
+            for (int i = 0; i < n; i++) {
+                double angle = i * (2.0 * math3d::PI / n);
+                tables[offset + i] = {static_cast<float>(math3d::cos(angle)), static_cast<float>(math3d::sin(angle))};
+            }
+            tables[offset + n] = tables[offset];
+        }
+        return tables;
+    }
+
+    constexpr auto CIRCLE_TABLES = make_circle_tables();
+}
+
+std::span<const RenderEngine::Point_2D> RenderEngine::unit_circle(int segments) {
+    segments = std::clamp((segments + 3) / 4 * 4, MIN_CIRCLE_SEGMENTS, MAX_CIRCLE_SEGMENTS);
+    return std::span<const Point_2D>(CIRCLE_TABLES).subspan(circle_table_offset(segments), static_cast<size_t>(segments) + 1);
+}
+
+float RenderEngine::projected_radius(const Pose& pose, const Point_3D& center, float radius) {
+    // Measured at the nearest depth any part of the circle can have; reaching the near
+    // plane it counts as huge (most segments)
+    float z = (pose.model * math3d::Vec4f{center.x, center.y, center.z, 1.0f}).z;
+    float nearest = z - radius;
+    if (nearest < NEAR_Z) return 1e9f;
+    return radius * 0.5f * static_cast<float>(height) / nearest;
+}
+
+void RenderEngine::draw_circle(const Pose& pose, const Point_3D& center, const Point_3D& u, const Point_3D& v, float thickness) {
+    draw_arc(pose, center, u, v, 0.0f, 2.0f * PI, thickness);
+}
+
+void RenderEngine::draw_arc(const Pose& pose, const Point_3D& center, const Point_3D& u, const Point_3D& v,
+                            float start_angle, float end_angle, float thickness) {
+    /**
+     * A point of the circle is linear in cos and sin, and so are its clip
+     * coordinates: only the center and the two radius vectors go through the
+     * model-view-projection matrix, every point is then c + u cos + v sin
+     * from the compile-time table. An arc uses the table points inside it
+     * plus its exact two ends.
+     */
+
+    if (!(end_angle > start_angle)) return;
+    float radius = std::max(math3d::length(u), math3d::length(v));
+    int segments = circle_segments(projected_radius(pose, center, radius));
+    std::span<const Point_2D> table = unit_circle(segments);
+
+    math3d::Mat4f mvp = projection * pose.model;
+    math3d::Vec4f c = mvp * math3d::Vec4f{center.x, center.y, center.z, 1.0f};
+    math3d::Vec4f cu = mvp * math3d::Vec4f{u.x, u.y, u.z, 0.0f};
+    math3d::Vec4f cv = mvp * math3d::Vec4f{v.x, v.y, v.z, 0.0f};
+
+    clip_points.clear();
+    auto add_point = [&](float cos_a, float sin_a) { clip_points.push_back(c + cu * cos_a + cv * sin_a); };
+
+    if (end_angle - start_angle >= 2.0f * PI) {
+        for (const Point_2D& p : table) add_point(p.x, p.y);
+    } else {
+        float step = 2.0f * PI / static_cast<float>(segments);
+        int first = static_cast<int>(std::floor(start_angle / step)) + 1;
+        int last = static_cast<int>(std::ceil(end_angle / step)) - 1;
+        add_point(std::cos(start_angle), std::sin(start_angle));
+        for (int i = first; i <= last; i++) {
+            const Point_2D& p = table[((i % segments) + segments) % segments];
+            add_point(p.x, p.y);
+        }
+        add_point(std::cos(end_angle), std::sin(end_angle));
+    }
+
+    screen_points.resize(clip_points.size());
+    for (size_t i = 0; i < clip_points.size(); i++) {
+        screen_points[i] = clip_points[i].w >= NEAR_Z ? clip_to_screen(clip_points[i]) : Point_2D{0.0f, 0.0f};
+    }
+    for (size_t i = 0; i + 1 < clip_points.size(); i++) {
+        draw_clip_edge(clip_points[i], clip_points[i + 1], screen_points[i], screen_points[i + 1], thickness);
+    }
+}
+
+void RenderEngine::add_solid(const MeshView& mesh, const Pose& pose, SDL_FColor color) {
+    /**
+     * Queues the mesh's visible faces for draw_solids().
+     *
+     * One pass over the faces after the vertex transform. Culling is the
+     * winding on screen (a face turned away from the camera is clockwise
+     * there), so roughly half of a closed mesh never gets further than a 2D
+     * cross product. The rest take the Lambert shade from their normal in
+     * model space, against the light turned into model space once per call.
+     * Faces crossing the near plane are dropped.
+     */
+
+    if (!solid || mesh.faces.empty()) return;
+    transform_mesh(mesh, pose);
+
+    // The rotation's inverse is its transpose
+    Point_3D light = math3d::transpose(rotation_of(pose.model)) * Point_3D{LIGHT_X, LIGHT_Y, LIGHT_Z};
+
+    for (const Mesh::Face& f : mesh.faces) {
+        float za = clip_points[f.a].w;
+        float zb = clip_points[f.b].w;
+        float zc = clip_points[f.c].w;
+        if (za < NEAR_Z || zb < NEAR_Z || zc < NEAR_Z) continue;
+
+        // Screen y points down: a face towards the camera winds counterclockwise in pixels
+        const Point_2D& sa = screen_points[f.a];
+        const Point_2D& sb = screen_points[f.b];
+        const Point_2D& sc = screen_points[f.c];
+        if (!(math3d::cross(sb - sa, sc - sa) > 0.0f)) {
+            solid_culled++;
+            continue;
+        }
+
+        // Outward normal (b - a) x (c - a)
+        const Point_3D& a = mesh.vertices[f.a];
+        Point_3D n = math3d::cross(mesh.vertices[f.b] - a, mesh.vertices[f.c] - a);
+        float length = math3d::length(n);
+        float diffuse = length > 0.0f ? std::max(math3d::dot(n, light) / length, 0.0f) : 0.0f;
+        float shade = AMBIENT + (1.0f - AMBIENT) * diffuse;
+
+        // Painter's order key: farther faces sort first. Positive floats order like their bits.
+        float depth_sum = za + zb + zc;
+        uint32_t bits;
+        std::memcpy(&bits, &depth_sum, sizeof(bits));
+
+        solid_order.push_back(static_cast<uint64_t>(~bits) << 32 | solid_faces.size());
+        solid_faces.push_back({{sa, sb, sc}, {color.r * shade, color.g * shade, color.b * shade, color.a}});
+    }
+}
+
+void RenderEngine::draw_solids() {
+    // Everything queued this frame, sorted back to front across meshes, as one geometry call
+
+    if (!solid_faces.empty()) {
+        radix_sort_by_key(solid_order, solid_order_scratch);
+
+        solid_vertices.resize(solid_faces.size() * 3);
+        SDL_Vertex* v = solid_vertices.data();
+        for (uint64_t item : solid_order) {
+            const SolidFace& face = solid_faces[static_cast<uint32_t>(item)];
+            for (const Point_2D& p : face.p) *v++ = {{p.x, p.y}, face.color, {0.0f, 0.0f}};
+        }
+        submit_geometry(solid_vertices.data(), static_cast<int>(solid_vertices.size()), nullptr, 0);
+    }
 
-    float c = std::cos(angle);
-    float s = std::sin(angle);
-    return { p.x * c + p.z * s, p.y, -p.x * s + p.z * c };
+    solid_faces.clear();
+    solid_order.clear();
+    solid_culled = 0;
 }
@@ -1,8 +1,16 @@
 #pragma once
 
 #include <SDL3/SDL.h>
+#include <cstdint>
 #include <numbers>
+#include <span>
 #include <vector>
+#include "depth_buffer.h"
+#include "math3d.h"
+#include "render_backend.h"
+
+struct MeshView;
+class MeshLod;
 
 constexpr float PI = 3.14159265358979323846f;
 constexpr int WINDOW_WIDTH = 1500;
@@ -10,18 +18,9 @@ constexpr int WINDOW_HEIGHT = 1500;
 
 class RenderEngine {
 public:
-    // Simple struct for (x,y) point representation
-    struct Point_2D {
-        float x;
-        float y;
-    };
-
-    // Simple struct for (x,y,z) point representation
-    struct Point_3D {
-        float x;
-        float y;
-        float z;
-    };
+    // (x,y) and (x,y,z) points: the math layer's vectors, still plain structs
+    using Point_2D = math3d::Vec2f;
+    using Point_3D = math3d::Vec3f;
 
     // Simple struct for (2D Point to 2D Point) line representation
     struct Edge {
@@ -29,10 +28,64 @@ public:
         int end;
     };
 
+    // Where a mesh sits: rotated by orientation, then moved to position. The model-to-view matrix
+    // is worked out once when the pose is made; every mesh and circle drawn with it reuses it.
+    struct Pose {
+        Point_3D position = {0.0f, 0.0f, 0.0f};
+        math3d::Quatf orientation;
+        math3d::Mat4f model = math3d::Mat4f::identity();
+
+        Pose() = default;
+        Pose(const Point_3D& p, const math3d::Quatf& q)
+            : position(p), orientation(q), model(math3d::Mat4f::rigid(math3d::to_mat3(q), p)) {}
+    };
+
 private:
     int width; // screen width
     int height; // screen height
     SDL_Renderer* renderer; // The class owns this!
+    RenderBackend* backend = nullptr; // When set, triangles go here instead of SDL_RenderGeometry
+
+    // Reused by draw_polyline so drawing a trace allocates nothing once warmed up
+    std::vector<SDL_Vertex> polyline_vertices;
+    std::vector<int> polyline_indices;
+
+    // Hidden-line mode: faces drawn with add_occluder() hide the edges behind them
+    bool hidden_lines = false;
+    DepthBuffer depth;
+
+    // Solid mode: faces queued by add_solid() (front-facing, already shaded) until draw_solids()
+    struct SolidFace {
+        Point_2D p[3];
+        SDL_FColor color;
+    };
+    bool solid = false;
+    std::vector<SolidFace> solid_faces;
+    std::vector<uint64_t> solid_order;         // Depth key << 32 | face index
+    std::vector<uint64_t> solid_order_scratch; // Radix sort ping-pong buffer
+    std::vector<SDL_Vertex> solid_vertices;
+    size_t solid_culled = 0;
+
+    // Edges are depth-tested in hidden-line and in solid mode; the buffer exists only then
+    bool depth_test() const { return hidden_lines || solid; }
+    void update_depth_buffer();
+
+    // View space to pixels as one matrix: clip (x, y, z, w) with screen = (x / w, y / w) and
+    // w = z = the view-space depth. Fixed with the screen size.
+    math3d::Mat4f projection;
+
+    // Per-mesh (and per-arc) scratch, reused across calls
+    std::vector<math3d::Vec4f> clip_points;
+    std::vector<Point_2D> screen_points;
+
+    // Mesh vertices through the pose's model-view-projection matrix (one multiply each) and on to screen
+    void transform_mesh(const MeshView& mesh, const Pose& pose);
+
+    // One clip-space line (screen points valid where w >= the near plane): clipped, depth-tested, drawn
+    void draw_clip_edge(math3d::Vec4f a, math3d::Vec4f b, Point_2D sa, Point_2D sb, float thickness);
+
+    // Every triangle this class draws goes through here
+    void submit_geometry(const SDL_Vertex* vertices, int vertex_count, const int* indices, int index_count);
 
     // Store object data inside the class
     // std::vector<Point_3D> vertices;
@@ -43,6 +96,9 @@ public:
     // Constructor
     RenderEngine(int w, int h, SDL_Renderer* r);
 
+    // Routes all geometry through a backend (e.g. SoftwareRasterizer); nullptr draws with SDL again
+    void set_backend(RenderBackend* b);
+
     // Helpers
     float to_radians(float degrees);
     float normalize_axis(Sint16 value);
@@ -58,11 +114,50 @@ public:
     Point_2D project(const Point_3D& p); 
     Point_2D screen(const Point_2D& p); 
 
+    // View-space point to pixels: project, correct for the aspect ratio, map to the screen
+    Point_2D to_screen(const Point_3D& p);
+
     void draw_thick_line(Point_2D p1, Point_2D p2, float thickness);
     void draw_filled_triangle(Point_2D p1, Point_2D p2, Point_2D p3);
+    void draw_polyline(const Point_2D* points, size_t count, float thickness, SDL_FColor color);
+
+    // Hidden-line mode. Per frame: clear_depth(), add_occluder() for every mesh, then draw_mesh_edges();
+    // edges are split into their visible fragments. Off, draw_mesh_edges() draws every edge whole.
+    void set_hidden_line_removal(bool enabled);
+    bool hidden_line_removal() const { return hidden_lines; }
+    void clear_depth();
+    void add_occluder(const MeshView& mesh, const Pose& pose);
+    void draw_mesh_edges(const MeshView& mesh, const Pose& pose, float thickness);
+    void draw_mesh_edges(const MeshView& mesh, const Edge* edges, size_t edge_count, const Pose& pose, float thickness); // A subset
+
+    // Where the camera is in the mesh's own coordinates (e.g. for silhouettes, FeatureEdges)
+    Point_3D camera_in_model(const Pose& pose);
+
+    // Level of detail for this frame: the coarsest level of lod that deviates from the full model by
+    // at most tolerance pixels on screen, judged at the nearest the model can come to the camera
+    static constexpr float LOD_TOLERANCE = 0.5f;
+    size_t select_lod(const MeshLod& lod, const Pose& pose, float tolerance = LOD_TOLERANCE);
+
+    // Circles and arcs: center + u cos(angle) + v sin(angle) in the pose's model space, u and v
+    // perpendicular radius vectors. The segment count follows the radius on screen, so no chord
+    // is more than CIRCLE_TOLERANCE pixels inside the true circle; small rings get few segments.
+    // Drawn like mesh edges (depth-tested in hidden-line mode).
+    static constexpr float CIRCLE_TOLERANCE = 0.5f;
+    static constexpr int MIN_CIRCLE_SEGMENTS = 8;
+    static constexpr int MAX_CIRCLE_SEGMENTS = 256;
+    int circle_segments(float radius_pixels, float tolerance = CIRCLE_TOLERANCE) const; // Multiple of 4
+    static std::span<const Point_2D> unit_circle(int segments); // cos / sin of segments + 1 points, the last one = the first
+    float projected_radius(const Pose& pose, const Point_3D& center, float radius); // Pixels, at the circle's nearest
+    void draw_circle(const Pose& pose, const Point_3D& center, const Point_3D& u, const Point_3D& v, float thickness);
+    void draw_arc(const Pose& pose, const Point_3D& center, const Point_3D& u, const Point_3D& v,
+                  float start_angle, float end_angle, float thickness); // Radians, counterclockwise from u to v
 
-    // Rotators
-    Point_3D rotate_roll(const Point_3D& p, float angle);
-    Point_3D rotate_pitch(const Point_3D& p, float angle);
-    Point_3D rotate_yaw(const Point_3D& p, float angle);
+    // Solid mode. Per frame: add_solid() for every mesh, then draw_solids() paints all queued faces
+    // far to near in one submission. Back faces are dropped and the rest Lambert-shaded as they are queued.
+    // Edges drawn afterwards are depth-tested against the solids (add_occluder() them too).
+    void set_solid(bool enabled);
+    bool solid_mode() const { return solid; }
+    void add_solid(const MeshView& mesh, const Pose& pose, SDL_FColor color);
+    void draw_solids();
+    size_t solid_faces_culled() const { return solid_culled; } // Back faces dropped since the last draw_solids()
 };
@@ -1,5 +1,5 @@
 #include "sdl_engine.h"
-#include <iostream>
+#include "logger.h"
 
 SDL_Engine::SDL_Engine(const char* window_name, int w, int h, SDL_InitFlags init_flags, SDL_WindowFlags window_flags) {
     // Set and declare all given variables 
@@ -12,21 +12,21 @@ SDL_Engine::SDL_Engine(const char* window_name, int w, int h, SDL_InitFlags init
     // The usual process of creating an SDL window and renderer
     // Initialize SDL - ...Later add exception thrown...
     if (!SDL_Init(this->init_flags)) {
-        std::cerr << "Failed to initialize SDL: " << SDL_GetError() << std::endl;
+        LOG_ERROR("Failed to initialize SDL: %s", SDL_GetError());
     }
-    std::cout << "SDL Initialized Successfully!" << std::endl;
+    LOG_INFO("SDL Initialized Successfully!");
 
     // Create a Window by the given parameters - ...Later add exception thrown...
     this->window = SDL_CreateWindow(this->window_name, this->width, this->height, this->window_flags);
     if(this->window == nullptr) {
-        std::cerr << "Failed to create a window: " << SDL_GetError() << std::endl;
+        LOG_ERROR("Failed to create a window: %s", SDL_GetError());
         SDL_Quit();
     }
 
     // Create a Renderer (with the created window) - ...Later add exception thrown...
     this->renderer = SDL_CreateRenderer(this->window, nullptr);
     if (this->renderer == nullptr) {
-        std::cerr << "Failed to create renderer: " << SDL_GetError() << std::endl;
+        LOG_ERROR("Failed to create renderer: %s", SDL_GetError());
         SDL_DestroyWindow(window);
         SDL_Quit();
     }
@@ -49,12 +49,12 @@ SDL_Gamepad* SDL_Engine::Connect_First_Controller() {
     if (count > 0) {
         handle = SDL_OpenGamepad(gamepads[0]);
         if (handle) {
-            SDL_Log("Successfully connected to: %s", SDL_GetGamepadName(handle));
+            LOG_INFO("Successfully connected to: %s", SDL_GetGamepadName(handle));
         } else {
-            SDL_Log("Failed to open gamepad: %s", SDL_GetError());
+            LOG_WARN("Failed to open gamepad: %s", SDL_GetError());
         }
     } else {
-        SDL_Log("No gamepads detected.");
+        LOG_INFO("No gamepads detected.");
     }
     SDL_free(gamepads);
     
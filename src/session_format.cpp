@@ -0,0 +1,376 @@
+#include "session_format.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SESSION_FORMAT_SSE2 1
+#endif
+
+namespace {
+    using namespace session_format;
+
+    // Largest magnitude we quantize; keeps every delta inside int64 and exact in a double
+    constexpr double MAX_QUANTIZED = 4503599627370496.0; // 2^52
+
+    // Worst case for a 64-bit varint
+    constexpr size_t MAX_VARINT_BYTES = 10;
+
+    uint64_t zigzag(int64_t v) {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    int64_t unzigzag(uint64_t v) {
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    uint8_t* put_varint(uint8_t* dst, uint64_t v) {
+        while (v >= 0x80) {
+            *dst++ = static_cast<uint8_t>(v) | 0x80;
+            v >>= 7;
+        }
+        *dst++ = static_cast<uint8_t>(v);
+        return dst;
+    }
+
+    // Decodes exactly count varints from [src, src + size) into out (still zigzagged).
+    // Fails on truncated or oversized data instead of reading past the column.
+    bool get_varints(const uint8_t* src, size_t size, size_t count, uint64_t* out) {
+        const uint8_t* p = src;
+        const uint8_t* end = src + size;
+        size_t n = 0;
+
+        while (n < count) {
+#ifdef SESSION_FORMAT_SSE2
+            // Steady flight gives mostly one-byte varints: expand 16 of them at once
+            if (end - p >= 16 && count - n >= 16) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                unsigned continuation = static_cast<unsigned>(_mm_movemask_epi8(bytes));
+                if (continuation == 0) {
+                    const __m128i zero = _mm_setzero_si128();
+                    __m128i w[2] = {_mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero)};
+                    for (int i = 0; i < 2; ++i) {
+                        __m128i d[2] = {_mm_unpacklo_epi16(w[i], zero), _mm_unpackhi_epi16(w[i], zero)};
+                        for (int j = 0; j < 2; ++j) {
+                            __m128i* q = reinterpret_cast<__m128i*>(out + n + i * 8 + j * 4);
+                            _mm_storeu_si128(q, _mm_unpacklo_epi32(d[j], zero));
+                            _mm_storeu_si128(q + 1, _mm_unpackhi_epi32(d[j], zero));
+                        }
+                    }
+                    p += 16;
+                    n += 16;
+                    continue;
+                }
+
+                // Copy the leading one-byte values, then let the scalar loop take the long one
+                int singles = std::countr_zero(continuation);
+                for (int i = 0; i < singles; ++i) out[n++] = *p++;
+            }
+#endif
+            uint64_t value = 0;
+            for (int shift = 0;; shift += 7) {
+                if (p == end || shift >= 64) return false;
+                uint8_t byte = *p++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) break;
+            }
+            out[n++] = value;
+        }
+
+        return p == end;
+    }
+
+    // values[i] = base + sum(unzigzag(values[0..i])), in place
+    void zigzag_prefix_sum(uint64_t* values, size_t count, int64_t base) {
+        size_t i = 0;
+#ifdef SESSION_FORMAT_SSE2
+        const __m128i one = _mm_set1_epi64x(1);
+        const __m128i zero = _mm_setzero_si128();
+        __m128i carry = _mm_set1_epi64x(base);
+        for (; i + 2 <= count; i += 2) {
+            __m128i* p = reinterpret_cast<__m128i*>(values + i);
+            __m128i x = _mm_loadu_si128(p);
+            x = _mm_xor_si128(_mm_srli_epi64(x, 1), _mm_sub_epi64(zero, _mm_and_si128(x, one)));
+            x = _mm_add_epi64(x, _mm_slli_si128(x, 8)); // [a, a + b]
+            x = _mm_add_epi64(x, carry);
+            _mm_storeu_si128(p, x);
+            carry = _mm_unpackhi_epi64(x, x);
+        }
+        if (i > 0) base = static_cast<int64_t>(values[i - 1]);
+#endif
+        for (; i < count; ++i) {
+            base += unzigzag(values[i]);
+            values[i] = static_cast<uint64_t>(base);
+        }
+    }
+
+    bool encode_columnar(const TelemetrySample* samples, size_t count, std::vector<uint8_t>& out) {
+        ColumnarPrefix prefix = {};
+        prefix.value_scale = DEFAULT_VALUE_SCALE;
+
+        // Quantize first: anything that does not fit sends the block down the raw path
+        std::vector<int64_t> quantized(count * CHANNEL_COUNT);
+        int64_t step = static_cast<int64_t>(DEFAULT_VALUE_SCALE); // Largest power of ten dividing every value
+        for (int c = 0; c < CHANNEL_COUNT; ++c) {
+            int64_t* column = quantized.data() + c * count;
+            for (size_t i = 0; i < count; ++i) {
+                double scaled = std::round(samples[i].attitude.*CHANNEL_MEMBERS[c] * prefix.value_scale);
+                if (!(std::fabs(scaled) <= MAX_QUANTIZED)) return false; // Also catches NaN
+                column[i] = static_cast<int64_t>(scaled);
+                while (step > 1 && column[i] % step != 0) step /= 10;
+            }
+        }
+
+        // Store at the source's own resolution: MSP attitude comes in 0.1 degree steps, so its
+        // deltas go in tenths instead of carrying ~10 bits of zeros through every varint. The
+        // values decode to exactly the same doubles.
+        if (step > 1) {
+            for (int64_t& q : quantized) q /= step;
+            prefix.value_scale /= static_cast<double>(step);
+        }
+
+        for (int c = 0; c < CHANNEL_COUNT; ++c) {
+            const int64_t* column = quantized.data() + c * count;
+            auto [lo, hi] = std::minmax_element(column, column + count);
+            prefix.ranges[c].min = static_cast<double>(*lo) / prefix.value_scale;
+            prefix.ranges[c].max = static_cast<double>(*hi) / prefix.value_scale;
+        }
+
+        size_t start = out.size();
+        out.resize(start + sizeof(BlockHeader) + sizeof(ColumnarPrefix) + (1 + CHANNEL_COUNT) * count * MAX_VARINT_BYTES);
+        uint8_t* columns = out.data() + start + sizeof(BlockHeader) + sizeof(ColumnarPrefix);
+        uint8_t* p = columns;
+
+        // Timestamps: delta-of-delta, so a steady sample rate costs one byte per sample
+        int64_t previous = samples[0].timestamp_us;
+        int64_t previous_delta = 0;
+        for (size_t i = 0; i < count; ++i) {
+            int64_t delta = samples[i].timestamp_us - previous;
+            p = put_varint(p, zigzag(delta - previous_delta));
+            previous = samples[i].timestamp_us;
+            previous_delta = delta;
+        }
+        prefix.column_bytes[0] = static_cast<uint32_t>(p - columns);
+
+        // Channels: plain delta, attitude changes slowly between samples
+        for (int c = 0; c < CHANNEL_COUNT; ++c) {
+            const int64_t* column = quantized.data() + c * count;
+            uint8_t* column_start = p;
+            int64_t last = 0;
+            for (size_t i = 0; i < count; ++i) {
+                p = put_varint(p, zigzag(column[i] - last));
+                last = column[i];
+            }
+            prefix.column_bytes[1 + c] = static_cast<uint32_t>(p - column_start);
+        }
+
+        BlockHeader header = {};
+        header.magic = BLOCK_MAGIC;
+        header.sample_count = static_cast<uint32_t>(count);
+        header.first_timestamp_us = samples[0].timestamp_us;
+        header.last_timestamp_us = samples[count - 1].timestamp_us;
+        header.payload_bytes = static_cast<uint32_t>(sizeof(ColumnarPrefix) + (p - columns));
+        header.encoding = static_cast<uint32_t>(BlockEncoding::Columnar);
+
+        std::memcpy(out.data() + start, &header, sizeof(header));
+        std::memcpy(out.data() + start + sizeof(header), &prefix, sizeof(prefix));
+        out.resize(start + sizeof(header) + header.payload_bytes);
+        return true;
+    }
+
+    bool read_prefix(const BlockHeader& header, const uint8_t* payload, ColumnarPrefix& prefix) {
+        if (header.payload_bytes < sizeof(ColumnarPrefix)) return false;
+        std::memcpy(&prefix, payload, sizeof(prefix));
+
+        uint64_t total = sizeof(ColumnarPrefix);
+        for (uint32_t bytes : prefix.column_bytes) total += bytes;
+        return total == header.payload_bytes && prefix.value_scale > 0.0;
+    }
+
+    bool decode_columnar(const BlockHeader& header, const uint8_t* payload, std::vector<TelemetrySample>& out) {
+        ColumnarPrefix prefix;
+        if (!read_prefix(header, payload, prefix)) return false;
+
+        // Every varint takes at least one byte, so a column shorter than the sample count is
+        // corrupt; checking before allocating keeps a bad count from sizing the buffers
+        size_t count = header.sample_count;
+        if (count > header.payload_bytes) return false;
+        for (uint32_t bytes : prefix.column_bytes) {
+            if (count > bytes) return false;
+        }
+
+        size_t offset = out.size();
+        out.resize(offset + count);
+        TelemetrySample* samples = out.data() + offset;
+
+        std::vector<uint64_t> column(count);
+        const uint8_t* p = payload + sizeof(ColumnarPrefix);
+
+        // Two prefix sums turn delta-of-delta back into absolute times
+        if (!get_varints(p, prefix.column_bytes[0], count, column.data())) return false;
+        zigzag_prefix_sum(column.data(), count, 0);
+        int64_t t = header.first_timestamp_us;
+        for (size_t i = 0; i < count; ++i) {
+            t += static_cast<int64_t>(column[i]);
+            samples[i].timestamp_us = t;
+        }
+        p += prefix.column_bytes[0];
+
+        for (int c = 0; c < CHANNEL_COUNT; ++c) {
+            if (!get_varints(p, prefix.column_bytes[1 + c], count, column.data())) return false;
+            zigzag_prefix_sum(column.data(), count, 0);
+            for (size_t i = 0; i < count; ++i) {
+                samples[i].attitude.*CHANNEL_MEMBERS[c] = static_cast<double>(static_cast<int64_t>(column[i])) / prefix.value_scale;
+            }
+            p += prefix.column_bytes[1 + c];
+        }
+        return true;
+    }
+
+    void encode_raw(const TelemetrySample* samples, size_t count, std::vector<uint8_t>& out) {
+        BlockHeader header = {};
+        header.magic = BLOCK_MAGIC;
+        header.sample_count = static_cast<uint32_t>(count);
+        header.first_timestamp_us = samples[0].timestamp_us;
+        header.last_timestamp_us = samples[count - 1].timestamp_us;
+        header.payload_bytes = static_cast<uint32_t>(count * sizeof(TelemetrySample));
+        header.encoding = static_cast<uint32_t>(BlockEncoding::Raw);
+
+        // Raw records: TelemetrySample is trivially copyable and has no padding
+        size_t offset = out.size();
+        out.resize(offset + sizeof(header) + header.payload_bytes);
+        std::memcpy(out.data() + offset, &header, sizeof(header));
+        std::memcpy(out.data() + offset + sizeof(header), samples, header.payload_bytes);
+    }
+}
+
+namespace session_format {
+
+    FileHeader make_file_header() {
+        FileHeader header = {};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = VERSION;
+        header.channel_count = CHANNEL_COUNT;
+        header.start_wall_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        header.start_mono_us = telemetry_now_us();
+        return header;
+    }
+
+    bool validate_file_header(const FileHeader& header) {
+        return std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+               header.version >= MIN_VERSION && header.version <= VERSION &&
+               header.channel_count == CHANNEL_COUNT;
+    }
+
+    void encode_block(const TelemetrySample* samples, size_t count, std::vector<uint8_t>& out, BlockEncoding encoding) {
+        if (count == 0) return;
+
+        if (encoding == BlockEncoding::Columnar && encode_columnar(samples, count, out)) return;
+        encode_raw(samples, count, out);
+    }
+
+    bool decode_block(const BlockHeader& header, const uint8_t* payload, size_t available, std::vector<TelemetrySample>& out) {
+        if (header.magic != BLOCK_MAGIC || header.payload_bytes > available) return false;
+
+        switch (static_cast<BlockEncoding>(header.encoding)) {
+        case BlockEncoding::Raw: {
+            if (header.payload_bytes != header.sample_count * sizeof(TelemetrySample)) return false;
+
+            size_t offset = out.size();
+            out.resize(offset + header.sample_count);
+            std::memcpy(out.data() + offset, payload, header.payload_bytes);
+            return true;
+        }
+        case BlockEncoding::Columnar: {
+            size_t offset = out.size();
+            if (decode_columnar(header, payload, out)) return true;
+            out.resize(offset); // Drop a half-decoded block
+            return false;
+        }
+        }
+        return false;
+    }
+
+    bool block_ranges(const BlockHeader& header, const uint8_t* payload, size_t available, ChannelRange out[CHANNEL_COUNT]) {
+        if (header.magic != BLOCK_MAGIC || header.payload_bytes > available) return false;
+
+        if (header.encoding == static_cast<uint32_t>(BlockEncoding::Columnar)) {
+            ColumnarPrefix prefix;
+            if (!read_prefix(header, payload, prefix)) return false;
+            std::copy(prefix.ranges, prefix.ranges + CHANNEL_COUNT, out);
+            return true;
+        }
+
+        std::vector<TelemetrySample> samples;
+        if (!decode_block(header, payload, available, samples) || samples.empty()) return false;
+        for (int c = 0; c < CHANNEL_COUNT; ++c) {
+            out[c].min = out[c].max = samples[0].attitude.*CHANNEL_MEMBERS[c];
+            for (const TelemetrySample& sample : samples) {
+                out[c].min = std::min(out[c].min, sample.attitude.*CHANNEL_MEMBERS[c]);
+                out[c].max = std::max(out[c].max, sample.attitude.*CHANNEL_MEMBERS[c]);
+            }
+        }
+        return true;
+    }
+
+    bool source_stamp(const std::string& path, SourceStamp& out) {
+        std::error_code error;
+        out.size = std::filesystem::file_size(path, error);
+        if (error) return false;
+        auto mtime = std::filesystem::last_write_time(path, error);
+        if (error) return false;
+        out.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count();
+        return true;
+    }
+
+    bool converted_from(const std::string& path, const SourceStamp& source) {
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (f == nullptr) return false;
+
+        FileHeader header;
+        bool ok = std::fread(&header, sizeof(header), 1, f) == 1 && validate_file_header(header);
+        std::fclose(f);
+        return ok && header.source_size == source.size && header.source_mtime_ns == source.mtime_ns;
+    }
+
+    void remove_caches(const std::string& path) {
+        std::remove((path + ".idx").c_str());
+        std::remove((path + ".mmx").c_str());
+    }
+
+    bool write_session(const std::string& path, const std::vector<TelemetrySample>& samples, const SourceStamp& source) {
+        std::string temp_path = path + ".tmp";
+        FILE* f = std::fopen(temp_path.c_str(), "wb");
+        if (f == nullptr) return false;
+
+        FileHeader header = make_file_header();
+        header.source_size = source.size;
+        header.source_mtime_ns = source.mtime_ns;
+        bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+
+        std::vector<uint8_t> block;
+        for (size_t i = 0; i < samples.size() && ok; i += DEFAULT_BLOCK_SAMPLES) {
+            size_t count = std::min(DEFAULT_BLOCK_SAMPLES, samples.size() - i);
+            block.clear();
+            encode_block(samples.data() + i, count, block);
+            ok = std::fwrite(block.data(), 1, block.size(), f) == block.size();
+        }
+
+        ok = (std::fclose(f) == 0) && ok;
+        std::error_code error;
+        if (ok) std::filesystem::rename(temp_path, path, error); // Replaces an older conversion
+        if (!ok || error) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+        remove_caches(path);
+        return true;
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "telemetry.h"
+
+/**
+ * @brief On-disk layout of a recorded flight session (.drec).
+ *
+ *   FileHeader
+ *   BlockHeader + payload
+ *   BlockHeader + payload
+ *   ...
+ *
+ * Blocks are self-contained, so a file cut short by a crash or power loss is
+ * still readable up to the last complete block. Everything is little-endian.
+ *
+ * Version 1 payloads are raw TelemetrySample records. Version 2 writes
+ * columnar blocks (BlockHeader::encoding == Columnar):
+ *
+ *   ColumnarPrefix (scale, column sizes, per-channel min/max)
+ *   timestamps: zigzag varint delta-of-delta, relative to first_timestamp_us
+ *   channel 0:  zigzag varint delta of round(value * value_scale)
+ *   channel 1, 2: same
+ *
+ * Channels are quantized to 0.0001 degree at most, far below what the
+ * sensors resolve. Each block stores them at the coarsest power-of-ten step
+ * that keeps every value exact (value_scale 10 for MSP's 0.1 degree
+ * attitude). A block with values that cannot be quantized (NaN, huge) falls
+ * back to a Raw block, so nothing is ever lost silently.
+ * Readers accept both versions and both encodings.
+ */
+namespace session_format {
+
+    constexpr char FILE_MAGIC[8] = {'D', 'R', 'N', 'S', 'E', 'S', 'S', '\0'};
+    constexpr uint32_t BLOCK_MAGIC = 0x4B4C4244; // "DBLK"
+    constexpr uint32_t VERSION = 2;
+    constexpr uint32_t MIN_VERSION = 1; // Oldest version we still read
+
+    // Channels stored for every sample, in this order
+    constexpr int CHANNEL_COUNT = 3;
+    constexpr const char* CHANNEL_NAMES[CHANNEL_COUNT] = {"roll", "pitch", "yaw"};
+    constexpr double DroneTelemetry::* CHANNEL_MEMBERS[CHANNEL_COUNT] = {
+        &DroneTelemetry::roll, &DroneTelemetry::pitch, &DroneTelemetry::yaw};
+
+    // Samples per block used by write_session() and SessionRecorder's default options
+    constexpr size_t DEFAULT_BLOCK_SAMPLES = 4096;
+
+    // Finest quantization step of columnar channels is 1 / DEFAULT_VALUE_SCALE
+    constexpr double DEFAULT_VALUE_SCALE = 10000.0;
+
+    enum class BlockEncoding : uint32_t {
+        Raw = 0,      // TelemetrySample records (all version 1 blocks)
+        Columnar = 1  // Delta / delta-of-delta zigzag varint columns
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t channel_count;
+        int64_t start_wall_us;   // Wall clock (UTC, microseconds since epoch) when recording began
+        int64_t start_mono_us;   // telemetry_now_us() at the same moment, maps sample times to wall time
+        uint64_t source_size;    // Converted sessions: size of the log they were made from (0 when recorded live)
+        int64_t source_mtime_ns; // and its modification time, so a stale conversion is noticed
+        uint8_t reserved[16];
+    };
+    static_assert(sizeof(FileHeader) == 64, "FileHeader layout is part of the file format");
+
+    struct BlockHeader {
+        uint32_t magic;
+        uint32_t sample_count;
+        int64_t first_timestamp_us;
+        int64_t last_timestamp_us;
+        uint32_t payload_bytes;
+        uint32_t encoding;      // BlockEncoding; was reserved (always 0) in version 1
+    };
+    static_assert(sizeof(BlockHeader) == 32, "BlockHeader layout is part of the file format");
+
+    struct ChannelRange {
+        double min;
+        double max;
+    };
+
+    // Start of every columnar payload. The ranges let scans skip whole blocks.
+    struct ColumnarPrefix {
+        double value_scale;
+        uint32_t column_bytes[1 + CHANNEL_COUNT]; // Timestamps, then each channel
+        uint32_t reserved;
+        ChannelRange ranges[CHANNEL_COUNT];
+    };
+    static_assert(sizeof(ColumnarPrefix) == 80, "ColumnarPrefix layout is part of the file format");
+
+    // Fills a header for a session starting now
+    FileHeader make_file_header();
+
+    // True if the header is one we know how to read
+    bool validate_file_header(const FileHeader& header);
+
+    // Serializes samples into a block (header + payload), appended to out
+    void encode_block(const TelemetrySample* samples, size_t count, std::vector<uint8_t>& out,
+                      BlockEncoding encoding = BlockEncoding::Columnar);
+
+    // Decodes one block payload, appending the samples to out. available is how many bytes follow
+    // the header in memory; a payload claiming more is rejected. Returns false on corrupt data.
+    bool decode_block(const BlockHeader& header, const uint8_t* payload, size_t available, std::vector<TelemetrySample>& out);
+
+    // Min / max of every channel in a block. Free for columnar blocks, a scan for raw ones.
+    bool block_ranges(const BlockHeader& header, const uint8_t* payload, size_t available, ChannelRange out[CHANNEL_COUNT]);
+
+    // Size and modification time of a file a session was converted from
+    struct SourceStamp {
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+    };
+
+    // Stamp of the file at path; false if it cannot be read
+    bool source_stamp(const std::string& path, SourceStamp& out);
+
+    // True if path is a session converted from a source with exactly this stamp
+    bool converted_from(const std::string& path, const SourceStamp& source);
+
+    // Deletes the replay caches (.idx, .mmx) next to a session that is being rewritten. They are
+    // keyed on the log size, so a new log of the same size would otherwise pick up stale ones.
+    void remove_caches(const std::string& path);
+
+    // Writes a complete session file in one go (offline conversion; live recording uses SessionRecorder).
+    // The file is written next to path and renamed into place, so path is either complete or untouched.
+    bool write_session(const std::string& path, const std::vector<TelemetrySample>& samples, const SourceStamp& source = {});
+}
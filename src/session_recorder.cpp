@@ -0,0 +1,170 @@
+#include "session_recorder.h"
+#include "logger.h"
+#include "session_format.h"
+#include <chrono>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+SessionRecorder::SessionRecorder(const std::string& path, Options options)
+    : m_path(path), m_options(options) {
+
+    if (m_options.block_samples == 0) m_options.block_samples = 1;
+    if (m_options.max_blocks < 2) m_options.max_blocks = 2;
+    if (m_options.flush_interval_ms == 0) m_options.flush_interval_ms = 1; // The writer waits this long between checks
+
+    session_format::remove_caches(path);
+    m_file = std::fopen(path.c_str(), "wb");
+    if (m_file == nullptr) {
+        LOG_ERROR("[Recorder] Failed to open %s for writing", path);
+        return;
+    }
+
+    // Large stdio buffer: each batch reaches the OS in a few big writes
+    std::setvbuf(m_file, nullptr, _IOFBF, 1 << 20);
+
+    session_format::FileHeader header = session_format::make_file_header();
+    std::fwrite(&header, sizeof(header), 1, m_file);
+    std::fflush(m_file);
+    m_bytes_written = sizeof(header);
+
+    // Allocate the whole pool up front, nothing is allocated while recording
+    for (size_t i = 0; i < m_options.max_blocks; i++) {
+        auto block = std::make_unique<Block>();
+        block->reserve(m_options.block_samples);
+        m_free.push_back(std::move(block));
+    }
+
+    m_writer = std::thread(&SessionRecorder::writer_loop, this);
+    LOG_INFO("[Recorder] Recording session to %s", path);
+}
+
+SessionRecorder::~SessionRecorder() {
+    if (m_file == nullptr) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        submit_current();
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_writer.join();
+
+    sync_file();
+    std::fclose(m_file);
+
+    m_pyramid.flush();
+    m_pyramid.save(m_path + ".mmx", m_bytes_written);
+
+    if (dropped() > 0) {
+        LOG_WARN("[Recorder] Closed %s: %llu samples, %llu dropped (disk too slow)", m_path, recorded(), dropped());
+    } else {
+        LOG_INFO("[Recorder] Closed %s: %llu samples", m_path, recorded());
+    }
+}
+
+void SessionRecorder::record(const TelemetrySample& sample) {
+    if (m_file == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_current && !m_free.empty()) {
+        m_current = std::move(m_free.back());
+        m_free.pop_back();
+    }
+
+    // Pool exhausted: the writer is behind, drop rather than allocate
+    if (!m_current) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (m_current->empty()) m_current_started = std::chrono::steady_clock::now();
+    m_current->push_back(sample);
+    m_recorded.fetch_add(1, std::memory_order_relaxed);
+
+    // Full, or old enough that a crash now would lose too much
+    if (m_current->size() >= m_options.block_samples || current_stale()) submit_current();
+}
+
+void SessionRecorder::submit_current() {
+    if (!m_current || m_current->empty()) return;
+    m_pending.push_back(std::move(m_current));
+    m_cv.notify_one();
+}
+
+bool SessionRecorder::current_stale() const {
+    return m_current && !m_current->empty() &&
+           std::chrono::steady_clock::now() - m_current_started >= std::chrono::milliseconds(m_options.flush_interval_ms);
+}
+
+void SessionRecorder::writer_loop() {
+    using clock = std::chrono::steady_clock;
+    auto last_sync = clock::now();
+    std::vector<std::unique_ptr<Block>> batch;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        // Wake at least once per flush interval: if telemetry stopped, nobody else will
+        // submit the partial block, so the writer takes it once it is stale
+        m_cv.wait_for(lock, std::chrono::milliseconds(m_options.flush_interval_ms),
+                      [&] { return m_stop || !m_pending.empty() || current_stale(); });
+        if (current_stale()) submit_current();
+
+        // Take everything that is queued, write it without holding the lock
+        while (!m_pending.empty()) {
+            batch.push_back(std::move(m_pending.front()));
+            m_pending.pop_front();
+        }
+        bool stopping = m_stop;
+        lock.unlock();
+
+        if (!batch.empty()) {
+            write_batch(batch);
+
+            bool sync = false;
+            if (m_options.fsync == FsyncPolicy::EveryBatch) sync = true;
+            if (m_options.fsync == FsyncPolicy::Interval &&
+                clock::now() - last_sync >= std::chrono::milliseconds(m_options.fsync_interval_ms)) sync = true;
+
+            if (sync) {
+                sync_file();
+                last_sync = clock::now();
+            }
+        }
+
+        lock.lock();
+        for (auto& block : batch) {
+            block->clear(); // Keeps its capacity for reuse
+            m_free.push_back(std::move(block));
+        }
+        batch.clear();
+
+        if (stopping && m_pending.empty()) break;
+    }
+}
+
+void SessionRecorder::write_batch(std::vector<std::unique_ptr<Block>>& batch) {
+    m_encode_buffer.clear();
+    for (const auto& block : batch) {
+        session_format::encode_block(block->data(), block->size(), m_encode_buffer);
+        m_pyramid.append(block->data(), block->size());
+    }
+
+    if (std::fwrite(m_encode_buffer.data(), 1, m_encode_buffer.size(), m_file) != m_encode_buffer.size()) {
+        LOG_ERROR_EVERY(1, "[Recorder] Write error on %s", m_path);
+    }
+    m_bytes_written += m_encode_buffer.size();
+    std::fflush(m_file);
+}
+
+void SessionRecorder::sync_file() {
+    std::fflush(m_file);
+#ifdef _WIN32
+    _commit(_fileno(m_file));
+#else
+    fsync(fileno(m_file));
+#endif
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "minmax_pyramid.h"
+#include "session_format.h"
+#include "telemetry.h"
+
+/**
+ * @brief Records every telemetry sample of a flight into a binary session log (.drec).
+ *
+ * The producer (telemetry thread) only appends to an in-memory block. Full
+ * blocks are handed to a background writer thread that encodes and writes
+ * them in batches, so neither the render nor the telemetry thread ever waits
+ * on the disk. The writer also wakes every flush interval and takes a partial
+ * block that has grown stale, so the tail of a flight reaches the disk even
+ * when telemetry stops arriving. Memory is bounded by a fixed pool of blocks: if the disk cannot
+ * keep up, new samples are dropped and counted instead of growing the heap.
+ *
+ * The writer also feeds a MinMaxPyramid, saved as "<log>.mmx" on close so a
+ * replay can draw the whole session without decoding it.
+ *
+ * record() expects a single producer thread.
+ */
+class SessionRecorder {
+public:
+    enum class FsyncPolicy {
+        Never,       // Leave it to the OS (fastest, may lose the last seconds on power loss)
+        EveryBatch,  // fsync after every batch the writer flushes
+        Interval     // fsync at most every fsync_interval_ms
+    };
+
+    struct Options {
+        size_t block_samples = session_format::DEFAULT_BLOCK_SAMPLES; // Samples per block (~4 s at 1 kHz)
+        size_t max_blocks = 64;          // Pool size: memory bound is max_blocks * block_samples samples
+        FsyncPolicy fsync = FsyncPolicy::Interval;
+        unsigned fsync_interval_ms = 1000;
+        unsigned flush_interval_ms = 500; // Partially filled blocks are written at least this often, samples or not
+    };
+
+    SessionRecorder(const std::string& path, Options options);
+    explicit SessionRecorder(const std::string& path) : SessionRecorder(path, Options{}) {}
+
+    // Writes everything still buffered and closes the file
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    bool is_open() const { return m_file != nullptr; }
+    const std::string& path() const { return m_path; }
+
+    // Producer side: never blocks on I/O
+    void record(const TelemetrySample& sample);
+
+    uint64_t recorded() const { return m_recorded.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Everything written so far, summarised for drawing (safe to query from any thread)
+    const MinMaxPyramid& pyramid() const { return m_pyramid; }
+
+private:
+    using Block = std::vector<TelemetrySample>;
+
+    // Queues the current block for writing; the caller holds m_mutex
+    void submit_current();
+
+    bool current_stale() const;
+
+    void writer_loop();
+    void write_batch(std::vector<std::unique_ptr<Block>>& batch);
+    void sync_file();
+
+    std::string m_path;
+    Options m_options;
+    FILE* m_file = nullptr;
+
+    // Shared with the writer thread. The producer only holds the lock to append one sample,
+    // and the writer never holds it during I/O, so record() never waits on the disk
+    std::mutex m_mutex;
+    std::unique_ptr<Block> m_current;                  // Block being filled by the producer
+    std::chrono::steady_clock::time_point m_current_started; // When its first sample arrived
+    std::condition_variable m_cv;
+    std::deque<std::unique_ptr<Block>> m_pending;   // Full blocks waiting to be written
+    std::vector<std::unique_ptr<Block>> m_free;      // Recycled empty blocks
+    bool m_stop = false;
+
+    std::thread m_writer;
+    std::vector<uint8_t> m_encode_buffer; // Writer thread only
+    uint64_t m_bytes_written = 0;         // Writer thread only
+    MinMaxPyramid m_pyramid;              // Appended by the writer thread
+
+    std::atomic<uint64_t> m_recorded{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
@@ -0,0 +1,326 @@
+#include "session_replay.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    constexpr char INDEX_MAGIC[8] = {'D', 'R', 'N', 'I', 'D', 'X', '\0', '\0'};
+    constexpr uint32_t INDEX_VERSION = 1;
+
+    struct IndexFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t log_size;    // Size of the log when the index was built; a mismatch means rebuild
+        uint64_t entry_count;
+    };
+}
+
+SessionReplay::~SessionReplay() {
+    stop();
+}
+
+bool SessionReplay::open(const std::string& path) {
+    stop();
+    m_index.clear();
+    m_total_samples = 0;
+    m_pyramid.clear();
+
+    if (!m_file.open(path)) {
+        LOG_ERROR("[Replay] Cannot open %s", path);
+        return false;
+    }
+
+    if (m_file.size() < sizeof(m_header)) {
+        LOG_ERROR("[Replay] %s is not a session log", path);
+        m_file.close();
+        return false;
+    }
+    std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+    if (!session_format::validate_file_header(m_header)) {
+        LOG_ERROR("[Replay] %s has an unknown format or version", path);
+        m_file.close();
+        return false;
+    }
+
+    std::string index_path = path + ".idx";
+    if (!load_index(index_path)) {
+        auto start = std::chrono::steady_clock::now();
+        build_index();
+        save_index(index_path);
+
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+        LOG_INFO("[Replay] Indexed %zu blocks in %.2f ms", m_index.size(), ms.count());
+    }
+
+    for (const IndexEntry& entry : m_index) m_total_samples += entry.sample_count;
+
+    std::string pyramid_path = path + ".mmx";
+    if (!m_pyramid.load(pyramid_path, m_file.size())) {
+        auto start = std::chrono::steady_clock::now();
+        build_pyramid();
+        m_pyramid.save(pyramid_path, m_file.size());
+
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+        LOG_INFO("[Replay] Built min/max pyramid in %.2f ms", ms.count());
+    }
+
+    LOG_INFO("[Replay] Opened %s: %llu samples, %.1f s", path, m_total_samples,
+             (end_time_us() - start_time_us()) / 1000000.0);
+    return !m_index.empty();
+}
+
+bool SessionReplay::load_index(const std::string& index_path) {
+    FILE* f = std::fopen(index_path.c_str(), "rb");
+    if (f == nullptr) return false;
+
+    IndexFileHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, f) == 1 &&
+              std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+              header.version == INDEX_VERSION &&
+              header.log_size == m_file.size() &&
+              header.entry_count <= m_file.size() / sizeof(session_format::BlockHeader);
+
+    if (ok) {
+        m_index.resize(header.entry_count);
+        ok = std::fread(m_index.data(), sizeof(IndexEntry), m_index.size(), f) == m_index.size();
+    }
+    std::fclose(f);
+
+    // Never trust an entry: the same size does not make it the same log. Every entry must
+    // point at a block header whose payload fits in the file, as build_index() checks.
+    if (ok) {
+        for (const IndexEntry& entry : m_index) {
+            if (!block_fits(entry.offset)) {
+                ok = false;
+                break;
+            }
+            session_format::BlockHeader block;
+            std::memcpy(&block, m_file.data() + entry.offset, sizeof(block));
+            if (block.sample_count != entry.sample_count || block.first_timestamp_us != entry.first_timestamp_us ||
+                block.last_timestamp_us != entry.last_timestamp_us) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    if (!ok) {
+        LOG_WARN("[Replay] Index %s does not match the log, rebuilding", index_path.c_str());
+        m_index.clear();
+    }
+    return ok;
+}
+
+bool SessionReplay::block_fits(uint64_t offset) const {
+    size_t size = m_file.size();
+    if (offset > size || size - offset < sizeof(session_format::BlockHeader)) return false;
+
+    session_format::BlockHeader block;
+    std::memcpy(&block, m_file.data() + offset, sizeof(block));
+    return block.magic == session_format::BLOCK_MAGIC && block.payload_bytes <= size - offset - sizeof(block);
+}
+
+void SessionReplay::build_index() {
+    // Walks only the block headers: one touched page per block, not the whole file
+    const uint8_t* data = m_file.data();
+    size_t offset = sizeof(session_format::FileHeader);
+
+    while (block_fits(offset)) { // Stops at the end, or at a block truncated by a crash
+        session_format::BlockHeader block;
+        std::memcpy(&block, data + offset, sizeof(block));
+
+        IndexEntry entry = {};
+        entry.first_timestamp_us = block.first_timestamp_us;
+        entry.last_timestamp_us = block.last_timestamp_us;
+        entry.offset = offset;
+        entry.sample_count = block.sample_count;
+        m_index.push_back(entry);
+
+        offset += sizeof(block) + block.payload_bytes;
+    }
+}
+
+void SessionReplay::save_index(const std::string& index_path) const {
+    FILE* f = std::fopen(index_path.c_str(), "wb");
+    if (f == nullptr) return; // Read-only media: we simply rebuild next time
+
+    IndexFileHeader header = {};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.log_size = m_file.size();
+    header.entry_count = m_index.size();
+
+    std::fwrite(&header, sizeof(header), 1, f);
+    std::fwrite(m_index.data(), sizeof(IndexEntry), m_index.size(), f);
+    std::fclose(f);
+}
+
+void SessionReplay::build_pyramid() {
+    // One pass over the log; afterwards the timeline never touches samples again
+    std::vector<TelemetrySample> samples;
+    for (size_t block = 0; block < m_index.size(); block++) {
+        if (read_block(block, samples)) m_pyramid.append(samples.data(), samples.size());
+    }
+    m_pyramid.flush();
+}
+
+int64_t SessionReplay::start_time_us() const {
+    return m_index.empty() ? 0 : m_index.front().first_timestamp_us;
+}
+
+int64_t SessionReplay::end_time_us() const {
+    return m_index.empty() ? 0 : m_index.back().last_timestamp_us;
+}
+
+size_t SessionReplay::find_block(int64_t time_us) const {
+    // First block starting after time_us, then step back one
+    auto it = std::upper_bound(m_index.begin(), m_index.end(), time_us,
+        [](int64_t t, const IndexEntry& entry) { return t < entry.first_timestamp_us; });
+
+    if (it == m_index.begin()) return 0;
+    return static_cast<size_t>(it - m_index.begin()) - 1;
+}
+
+bool SessionReplay::read_block(size_t block, std::vector<TelemetrySample>& out) const {
+    out.clear();
+    if (block >= m_index.size()) return false;
+
+    const uint8_t* base = m_file.data() + m_index[block].offset;
+    session_format::BlockHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    size_t available = m_file.size() - m_index[block].offset - sizeof(header);
+    return session_format::decode_block(header, base + sizeof(header), available, out);
+}
+
+bool SessionReplay::sample_at(int64_t time_us, TelemetrySample& out) const {
+    if (m_index.empty()) return false;
+
+    std::vector<TelemetrySample> samples;
+    if (!read_block(find_block(time_us), samples) || samples.empty()) return false;
+
+    auto it = std::upper_bound(samples.begin(), samples.end(), time_us,
+        [](int64_t t, const TelemetrySample& s) { return t < s.timestamp_us; });
+
+    out = (it == samples.begin()) ? samples.front() : *(it - 1);
+    return true;
+}
+
+bool SessionReplay::samples_around(int64_t time_us, TelemetrySample& before, TelemetrySample& after) const {
+    if (m_index.empty()) return false;
+
+    size_t block = find_block(time_us);
+    std::vector<TelemetrySample> samples;
+    if (!read_block(block, samples) || samples.empty()) return false;
+
+    auto it = std::upper_bound(samples.begin(), samples.end(), time_us,
+        [](int64_t t, const TelemetrySample& s) { return t < s.timestamp_us; });
+
+    before = (it == samples.begin()) ? samples.front() : *(it - 1);
+    after = before;
+    if (it == samples.begin()) return true; // Before the session: hold the first sample
+
+    // The next sample may open the next block
+    if (it != samples.end()) {
+        after = *it;
+    } else if (read_block(block + 1, samples) && !samples.empty()) {
+        after = samples.front();
+    }
+    return true;
+}
+
+void SessionReplay::play(TelemetryMailbox& mailbox, double speed) {
+    stop();
+    if (m_index.empty()) return;
+
+    set_speed(speed);
+    m_finished = false;
+    m_position = start_time_us();
+    m_running = true;
+    m_thread = std::thread(&SessionReplay::playback_loop, this, &mailbox);
+}
+
+void SessionReplay::stop() {
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void SessionReplay::set_speed(double speed) {
+    if (speed != AS_FAST_AS_POSSIBLE) speed = std::clamp(speed, MIN_SPEED, MAX_SPEED);
+    m_speed = speed;
+}
+
+void SessionReplay::seek(int64_t time_us) {
+    m_seek_target = std::clamp(time_us, start_time_us(), end_time_us());
+}
+
+void SessionReplay::playback_loop(TelemetryMailbox* mailbox) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<TelemetrySample> samples;
+    size_t block = 0;
+    size_t pos = 0;
+    read_block(block, samples);
+
+    // Pacing anchor: session time anchor_ts is played at wall time anchor_wall
+    bool reanchor = true;
+    clock::time_point anchor_wall;
+    int64_t anchor_ts = 0;
+    double anchor_speed = 0.0;
+
+    while (m_running) {
+        int64_t target = m_seek_target.exchange(INT64_MIN);
+        if (target != INT64_MIN) {
+            block = find_block(target);
+            read_block(block, samples);
+            auto it = std::upper_bound(samples.begin(), samples.end(), target,
+                [](int64_t t, const TelemetrySample& s) { return t < s.timestamp_us; });
+            pos = (it == samples.begin()) ? 0 : static_cast<size_t>(it - samples.begin()) - 1;
+            m_finished = false;
+            reanchor = true;
+        }
+
+        if (m_paused || m_finished) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            reanchor = true;
+            continue;
+        }
+
+        if (pos >= samples.size()) {
+            if (block + 1 >= m_index.size()) {
+                m_finished = true;
+                continue;
+            }
+            read_block(++block, samples);
+            pos = 0;
+            continue;
+        }
+
+        const TelemetrySample& sample = samples[pos];
+        double speed = m_speed.load();
+
+        if (reanchor || speed != anchor_speed) {
+            anchor_wall = clock::now();
+            anchor_ts = sample.timestamp_us;
+            anchor_speed = speed;
+            reanchor = false;
+        }
+
+        if (speed != AS_FAST_AS_POSSIBLE) {
+            auto due = anchor_wall + std::chrono::microseconds(
+                static_cast<int64_t>((sample.timestamp_us - anchor_ts) / speed));
+            auto now = clock::now();
+            if (due > now) {
+                // Sleep in short slices so seek / pause / speed changes apply quickly
+                std::this_thread::sleep_until(std::min(due, now + std::chrono::milliseconds(20)));
+                continue;
+            }
+        }
+
+        mailbox->publish(sample);
+        m_position = sample.timestamp_us;
+        pos++;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mapped_file.h"
+#include "minmax_pyramid.h"
+#include "session_format.h"
+#include "telemetry_mailbox.h"
+
+/**
+ * @brief Plays a recorded session (.drec) back through the same mailbox the live telemetry uses.
+ *
+ * The log is memory-mapped, so opening a multi-gigabyte file costs nothing up
+ * front. A sparse index (one entry per block) is loaded from "<log>.idx" or
+ * built by walking the block headers and saved for next time. Seeking is a
+ * binary search over the index followed by one within the decoded block.
+ * The min/max pyramid for timeline drawing is loaded from "<log>.mmx" the
+ * same way, or built once from the blocks.
+ */
+class SessionReplay {
+public:
+    // One entry per block in the log
+    struct IndexEntry {
+        int64_t first_timestamp_us;
+        int64_t last_timestamp_us;
+        uint64_t offset;        // Byte offset of the BlockHeader in the log
+        uint32_t sample_count;
+        uint32_t reserved;
+    };
+
+    static constexpr double MIN_SPEED = 0.1;
+    static constexpr double MAX_SPEED = 100.0;
+    static constexpr double AS_FAST_AS_POSSIBLE = 0.0;
+
+    SessionReplay() = default;
+    ~SessionReplay();
+
+    SessionReplay(const SessionReplay&) = delete;
+    SessionReplay& operator=(const SessionReplay&) = delete;
+
+    // Maps the log and loads (or builds) its index
+    bool open(const std::string& path);
+
+    bool is_open() const { return m_file.is_open(); }
+    const session_format::FileHeader& header() const { return m_header; }
+    const std::vector<IndexEntry>& index() const { return m_index; }
+
+    int64_t start_time_us() const;
+    int64_t end_time_us() const;
+    uint64_t sample_count() const { return m_total_samples; }
+
+    // Whole-session min/max summary for drawing the timeline
+    const MinMaxPyramid& pyramid() const { return m_pyramid; }
+
+    // Random access: newest sample with timestamp <= time_us (the first sample if time_us is earlier).
+    // Thread-safe, independent of playback.
+    bool sample_at(int64_t time_us, TelemetrySample& out) const;
+
+    // The samples on either side of time_us: before as sample_at(), after the one following it
+    // (the same sample at the end of the session). For blending between samples.
+    bool samples_around(int64_t time_us, TelemetrySample& before, TelemetrySample& after) const;
+
+    // Decodes every sample of one block (by index position)
+    bool read_block(size_t block, std::vector<TelemetrySample>& out) const;
+
+    // --- Playback ---
+
+    // Starts publishing samples into the mailbox on a background thread.
+    // speed is clamped to [MIN_SPEED, MAX_SPEED]; AS_FAST_AS_POSSIBLE disables pacing.
+    void play(TelemetryMailbox& mailbox, double speed = 1.0);
+    void stop();
+
+    void set_speed(double speed);
+    double speed() const { return m_speed.load(); }
+
+    void set_paused(bool paused) { m_paused = paused; }
+    bool paused() const { return m_paused; }
+
+    // Jumps playback to the given session time (thread-safe)
+    void seek(int64_t time_us);
+
+    // Session time of the last published sample
+    int64_t position_us() const { return m_position.load(); }
+
+    // True once playback reached the end of the log
+    bool finished() const { return m_finished; }
+
+private:
+    bool load_index(const std::string& index_path);
+    void build_index();
+    void save_index(const std::string& index_path) const;
+    void build_pyramid();
+
+    // A block header with the right magic at offset, and its whole payload inside the file
+    bool block_fits(uint64_t offset) const;
+
+    // Index of the block containing (or preceding) time_us
+    size_t find_block(int64_t time_us) const;
+
+    void playback_loop(TelemetryMailbox* mailbox);
+
+    MappedFile m_file;
+    session_format::FileHeader m_header = {};
+    std::vector<IndexEntry> m_index;
+    uint64_t m_total_samples = 0;
+    MinMaxPyramid m_pyramid;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_paused{false};
+    std::atomic<bool> m_finished{false};
+    std::atomic<double> m_speed{1.0};
+    std::atomic<int64_t> m_position{0};
+
+    // Pending seek target, INT64_MIN when none
+    std::atomic<int64_t> m_seek_target{INT64_MIN};
+};
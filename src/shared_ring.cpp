@@ -0,0 +1,250 @@
+#include "shared_ring.h"
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <linux/futex.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint32_t RING_MAGIC = 0x52544C44; // "DLTR"
+    constexpr uint32_t RING_VERSION = 1;
+
+    uint32_t round_up_pow2(uint32_t v) {
+        uint32_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    size_t block_size(uint32_t capacity) {
+        return sizeof(SharedTelemetryRing::Header) + size_t(capacity) * sizeof(TelemetrySample);
+    }
+
+#ifdef _WIN32
+    std::string event_name(const std::string& name) {
+        return name + "_wake";
+    }
+#else
+    // Shared (non-private) futex: the word lives in memory mapped by both processes
+    long futex(std::atomic<uint32_t>* addr, int op, uint32_t val, const timespec* timeout) {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val, timeout, nullptr, 0);
+    }
+#endif
+}
+
+SharedTelemetryRing::~SharedTelemetryRing() {
+    unmap();
+}
+
+bool SharedTelemetryRing::create(const std::string& name, uint32_t capacity) {
+    unmap();
+    capacity = round_up_pow2(capacity < 2 ? 2 : capacity);
+    size_t size = block_size(capacity);
+    void* base = nullptr;
+
+#ifdef _WIN32
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        0, static_cast<DWORD>(size), name.c_str());
+    if (mapping == nullptr) return false;
+    base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (base == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+    m_mapping = mapping;
+    m_event = CreateEventA(nullptr, FALSE, FALSE, event_name(name).c_str());
+#else
+    shm_unlink(name.c_str()); // Remove a stale block left by a crashed run
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return false;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the memory alive
+    if (base == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+#endif
+
+    // Construct the header in place (atomics need a real constructor call)
+    m_header = new (base) Header{};
+    m_header->capacity = capacity;
+    m_header->record_size = sizeof(TelemetrySample);
+    m_header->version = RING_VERSION;
+    m_records = reinterpret_cast<TelemetrySample*>(static_cast<char*>(base) + sizeof(Header));
+    m_mapped_size = size;
+    m_owner = true;
+    m_name = name;
+
+    // Magic goes last so a child that opens too early sees an invalid block
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->magic = RING_MAGIC;
+    return true;
+}
+
+bool SharedTelemetryRing::open(const std::string& name) {
+    unmap();
+    void* base = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if (mapping == nullptr) return false;
+    base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (base == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+    MEMORY_BASIC_INFORMATION info;
+    VirtualQuery(base, &info, sizeof(info));
+    size = info.RegionSize;
+    m_mapping = mapping;
+    m_event = OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, event_name(name).c_str());
+#else
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(fd);
+        return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+    base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+#endif
+
+    m_header = static_cast<Header*>(base);
+    m_mapped_size = size;
+    m_owner = false;
+    m_name = name;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_header->magic != RING_MAGIC || m_header->version != RING_VERSION ||
+        m_header->record_size != sizeof(TelemetrySample) ||
+        block_size(m_header->capacity) > size) {
+        unmap();
+        return false;
+    }
+    m_records = reinterpret_cast<TelemetrySample*>(static_cast<char*>(base) + sizeof(Header));
+    return true;
+}
+
+void SharedTelemetryRing::unmap() {
+    if (m_header == nullptr) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_header);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_event) CloseHandle(static_cast<HANDLE>(m_event));
+    m_mapping = nullptr;
+    m_event = nullptr;
+#else
+    munmap(m_header, m_mapped_size);
+    if (m_owner) shm_unlink(m_name.c_str());
+#endif
+
+    m_header = nullptr;
+    m_records = nullptr;
+    m_mapped_size = 0;
+    m_owner = false;
+}
+
+bool SharedTelemetryRing::push(const TelemetrySample& sample) {
+    uint32_t head = m_header->head.load(std::memory_order_relaxed);
+    uint32_t tail = m_header->tail.load(std::memory_order_acquire);
+
+    if (head - tail >= m_header->capacity) {
+        m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+        beat();
+        return false;
+    }
+
+    m_records[head & (m_header->capacity - 1)] = sample;
+    m_header->head.store(head + 1, std::memory_order_release);
+    beat();
+    wake_consumer();
+    return true;
+}
+
+void SharedTelemetryRing::beat() {
+    m_header->heartbeat.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool SharedTelemetryRing::pop(TelemetrySample& out) {
+    uint32_t tail = m_header->tail.load(std::memory_order_relaxed);
+    uint32_t head = m_header->head.load(std::memory_order_acquire);
+
+    if (tail == head) return false;
+
+    out = m_records[tail & (m_header->capacity - 1)];
+    m_header->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+void SharedTelemetryRing::wake_consumer() {
+    m_header->wake_seq.fetch_add(1, std::memory_order_release);
+
+    // Only pay for the syscall when the consumer is actually asleep
+    if (m_header->consumer_waiting.load(std::memory_order_acquire) == 0) return;
+
+#ifdef _WIN32
+    if (m_event) SetEvent(static_cast<HANDLE>(m_event));
+#else
+    futex(&m_header->wake_seq, FUTEX_WAKE, 1, nullptr);
+#endif
+}
+
+bool SharedTelemetryRing::wait(uint32_t timeout_ms) {
+    uint32_t seq = m_header->wake_seq.load(std::memory_order_acquire);
+    m_header->consumer_waiting.store(1, std::memory_order_seq_cst);
+
+    // Re-check after announcing ourselves, otherwise a push in between is missed
+    if (m_header->head.load(std::memory_order_acquire) != m_header->tail.load(std::memory_order_relaxed)) {
+        m_header->consumer_waiting.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+#ifdef _WIN32
+    (void)seq;
+    if (m_event) WaitForSingleObject(static_cast<HANDLE>(m_event), timeout_ms);
+#else
+    timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+    futex(&m_header->wake_seq, FUTEX_WAIT, seq, &ts);
+#endif
+
+    m_header->consumer_waiting.store(0, std::memory_order_relaxed);
+    return m_header->head.load(std::memory_order_acquire) != m_header->tail.load(std::memory_order_relaxed);
+}
+
+void SharedTelemetryRing::request_shutdown() {
+    m_header->shutdown.store(1, std::memory_order_release);
+}
+
+bool SharedTelemetryRing::shutdown_requested() const {
+    return m_header->shutdown.load(std::memory_order_acquire) != 0;
+}
+
+uint64_t SharedTelemetryRing::heartbeat() const {
+    return m_header->heartbeat.load(std::memory_order_relaxed);
+}
+
+uint32_t SharedTelemetryRing::dropped() const {
+    return m_header->dropped.load(std::memory_order_relaxed);
+}
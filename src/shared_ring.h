@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "telemetry.h"
+
+/**
+ * @brief Single-producer / single-consumer ring of TelemetrySample records
+ * living in named shared memory.
+ *
+ * The plugin host child process is the producer, the renderer is the consumer.
+ * Head and tail sit on separate cache lines so the two processes never fight
+ * over the same line. The consumer can sleep until the producer pushes
+ * (futex on Linux, a named auto-reset event on Windows).
+ */
+class SharedTelemetryRing {
+public:
+    // Layout of the shared block. Records follow directly after the header.
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t capacity;      // Number of records, always a power of two
+        uint32_t record_size;   // sizeof(TelemetrySample), checked on open
+
+        alignas(64) std::atomic<uint32_t> head;     // Next slot the producer writes
+        alignas(64) std::atomic<uint32_t> tail;     // Next slot the consumer reads
+        alignas(64) std::atomic<uint32_t> wake_seq; // Bumped on every push, used as the futex word
+        std::atomic<uint32_t> consumer_waiting;
+        std::atomic<uint32_t> shutdown;             // Set by the consumer to stop the producer
+        std::atomic<uint32_t> dropped;              // Samples lost because the ring was full
+        std::atomic<uint64_t> heartbeat;            // Bumped by the producer every poll, even without data
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared-memory atomics must be lock free");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory atomics must be lock free");
+
+    SharedTelemetryRing() = default;
+    ~SharedTelemetryRing();
+
+    SharedTelemetryRing(const SharedTelemetryRing&) = delete;
+    SharedTelemetryRing& operator=(const SharedTelemetryRing&) = delete;
+
+    // Creates (and owns) a new shared block. Capacity is rounded up to a power of two.
+    bool create(const std::string& name, uint32_t capacity);
+
+    // Attaches to a block created by another process
+    bool open(const std::string& name);
+
+    bool is_valid() const { return m_header != nullptr; }
+    const std::string& name() const { return m_name; }
+
+    // Producer side. Returns false (and counts a drop) if the ring is full.
+    bool push(const TelemetrySample& sample);
+
+    // Producer side: signals "still alive" without publishing data
+    void beat();
+
+    // Consumer side. Returns false if the ring is empty.
+    bool pop(TelemetrySample& out);
+
+    // Consumer side: sleeps until something is pushed or the timeout expires.
+    // Returns true if data is available.
+    bool wait(uint32_t timeout_ms);
+
+    // Shutdown flag (consumer -> producer)
+    void request_shutdown();
+    bool shutdown_requested() const;
+
+    uint64_t heartbeat() const;
+    uint32_t dropped() const;
+
+private:
+    void wake_consumer();
+    void unmap();
+
+    Header* m_header = nullptr;
+    TelemetrySample* m_records = nullptr;
+    size_t m_mapped_size = 0;
+    bool m_owner = false;
+    std::string m_name;
+
+#ifdef _WIN32
+    void* m_mapping = nullptr; // HANDLE of the file mapping
+    void* m_event = nullptr;   // HANDLE of the wake-up event
+#endif
+};
@@ -0,0 +1,455 @@
+#include "software_rasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SOFTWARE_RASTERIZER_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_RASTERIZER_SSE2 1
+#endif
+
+namespace {
+    constexpr int SUBPIXEL_BITS = 4; // 28.4 fixed point: 1/16 pixel vertex precision
+    constexpr int SUBPIXEL_ONE = 1 << SUBPIXEL_BITS;
+    constexpr int SUBPIXEL_HALF = SUBPIXEL_ONE / 2;
+
+    // Far enough off-screen that the edge functions still fit in 64 bits with room to spare
+    constexpr float MAX_COORDINATE = static_cast<float>(1 << 22);
+
+    uint8_t to_byte(float v) {
+        return static_cast<uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    int32_t to_fixed(float v) {
+        return static_cast<int32_t>(std::lround(v * SUBPIXEL_ONE));
+    }
+
+    // Sample position (center) of pixel i in fixed point
+    int64_t center(int i) {
+        return static_cast<int64_t>(i) * SUBPIXEL_ONE + SUBPIXEL_HALF;
+    }
+
+    void blend(uint8_t* dst, const uint8_t* src) {
+        // Straight alpha "over", like SDL_BLENDMODE_BLEND
+        int a = src[3];
+        int inv = 255 - a;
+        dst[0] = static_cast<uint8_t>((src[0] * a + dst[0] * inv + 127) / 255);
+        dst[1] = static_cast<uint8_t>((src[1] * a + dst[1] * inv + 127) / 255);
+        dst[2] = static_cast<uint8_t>((src[2] * a + dst[2] * inv + 127) / 255);
+        dst[3] = static_cast<uint8_t>(a + (dst[3] * inv + 127) / 255);
+    }
+
+    // --- Anti-aliased lines ---
+
+    constexpr int LINE_LANES = 8;
+
+    // Per-row constants of a line's coverage: for pixel centers at rx (relative to the line start)
+    //   along  = rx * dx + along_base    across = rx * dy - across_base
+    struct LineRow {
+        float dx, dy, along_base, across_base;
+        float half_width, length;
+        float width_cap, length_cap; // Coverage can never exceed min(width, 1) / min(length, 1)
+        float alpha_scale;
+    };
+
+#if !defined(SOFTWARE_RASTERIZER_AVX2) && !defined(SOFTWARE_RASTERIZER_SSE2)
+    // Scalar path of line_alpha8; the SIMD paths compute the same thing per lane
+    float line_alpha(const LineRow& r, float rx) {
+        // Box filter coverage = overlap of the line rectangle with the pixel square, per axis
+        float along = rx * r.dx + r.along_base;
+        float across = std::fabs(rx * r.dy - r.across_base);
+        float cover_w = std::clamp(std::min(r.half_width + 0.5f - across, r.width_cap), 0.0f, 1.0f);
+        float cover_l = std::clamp(std::min({along + 0.5f, r.length + 0.5f - along, r.length_cap}), 0.0f, 1.0f);
+        return cover_w * cover_l * r.alpha_scale + 0.5f;
+    }
+#endif
+
+    // Alpha (0..255) of eight consecutive pixels starting at rx
+    void line_alpha8(const LineRow& r, float rx, int32_t out[LINE_LANES]) {
+#if defined(SOFTWARE_RASTERIZER_AVX2)
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+        __m256 x = _mm256_add_ps(_mm256_set1_ps(rx), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256 along = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(r.dx)), _mm256_set1_ps(r.along_base));
+        __m256 across = _mm256_andnot_ps(sign, _mm256_sub_ps(_mm256_mul_ps(x, _mm256_set1_ps(r.dy)), _mm256_set1_ps(r.across_base)));
+        __m256 cover_w = _mm256_min_ps(_mm256_sub_ps(_mm256_set1_ps(r.half_width + 0.5f), across), _mm256_set1_ps(r.width_cap));
+        __m256 cover_l = _mm256_min_ps(_mm256_min_ps(_mm256_add_ps(along, half),
+                                                     _mm256_sub_ps(_mm256_set1_ps(r.length + 0.5f), along)),
+                                       _mm256_set1_ps(r.length_cap));
+        __m256 cover = _mm256_mul_ps(_mm256_max_ps(cover_w, zero), _mm256_max_ps(cover_l, zero));
+        __m256 alpha = _mm256_add_ps(_mm256_mul_ps(cover, _mm256_set1_ps(r.alpha_scale)), half);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvttps_epi32(alpha));
+#elif defined(SOFTWARE_RASTERIZER_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        for (int i = 0; i < LINE_LANES; i += 4) {
+            __m128 x = _mm_add_ps(_mm_set1_ps(rx + i), _mm_setr_ps(0, 1, 2, 3));
+            __m128 along = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(r.dx)), _mm_set1_ps(r.along_base));
+            __m128 across = _mm_andnot_ps(sign, _mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(r.dy)), _mm_set1_ps(r.across_base)));
+            __m128 cover_w = _mm_min_ps(_mm_sub_ps(_mm_set1_ps(r.half_width + 0.5f), across), _mm_set1_ps(r.width_cap));
+            __m128 cover_l = _mm_min_ps(_mm_min_ps(_mm_add_ps(along, half), _mm_sub_ps(_mm_set1_ps(r.length + 0.5f), along)),
+                                        _mm_set1_ps(r.length_cap));
+            __m128 cover = _mm_mul_ps(_mm_max_ps(cover_w, zero), _mm_max_ps(cover_l, zero));
+            __m128 alpha = _mm_add_ps(_mm_mul_ps(cover, _mm_set1_ps(r.alpha_scale)), half);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvttps_epi32(alpha));
+        }
+#else
+        for (int i = 0; i < LINE_LANES; i++) out[i] = static_cast<int32_t>(line_alpha(r, rx + i));
+#endif
+    }
+
+    // dst = color * a + dst * (255 - a), with color's alpha channel 255; the division by 255 is the
+    // usual (t + (t >> 8)) >> 8, the same in the scalar and SIMD versions
+    void blend_alpha(uint8_t* dst, const uint8_t* color, int a) {
+        int inv = 255 - a;
+        for (int c = 0; c < 4; c++) {
+            int t = color[c] * a + dst[c] * inv + 128;
+            dst[c] = static_cast<uint8_t>((t + (t >> 8)) >> 8);
+        }
+    }
+
+    void blend_alpha8(uint8_t* dst, const uint8_t* color, const int32_t alpha[LINE_LANES]) {
+#if defined(SOFTWARE_RASTERIZER_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i max = _mm_set1_epi16(255);
+        const __m128i round = _mm_set1_epi16(128);
+        uint32_t packed;
+        std::memcpy(&packed, color, 4);
+        const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(packed)), zero); // Two pixels, 16 bit
+
+        for (int i = 0; i < LINE_LANES; i += 4) {
+            // Alphas of four pixels, widened to one per channel: [a0 x4, a1 x4] and [a2 x4, a3 x4]
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + i));
+            __m128i* p = reinterpret_cast<__m128i*>(dst + i * 4);
+
+            // Inside the line (most of a thick one): plain stores
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, _mm_set1_epi32(255))) == 0xffff) {
+                _mm_storeu_si128(p, _mm_set1_epi32(static_cast<int>(packed)));
+                continue;
+            }
+            a = _mm_packs_epi32(a, a);
+            a = _mm_unpacklo_epi16(a, a);
+            __m128i a_lo = _mm_unpacklo_epi32(a, a);
+            __m128i a_hi = _mm_unpackhi_epi32(a, a);
+
+            __m128i pixels = _mm_loadu_si128(p);
+            __m128i d_lo = _mm_unpacklo_epi8(pixels, zero);
+            __m128i d_hi = _mm_unpackhi_epi8(pixels, zero);
+
+            // Sums stay below 65536, so 16-bit lanes with logical shifts are exact
+            __m128i t_lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(src, a_lo), _mm_mullo_epi16(d_lo, _mm_sub_epi16(max, a_lo))), round);
+            __m128i t_hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(src, a_hi), _mm_mullo_epi16(d_hi, _mm_sub_epi16(max, a_hi))), round);
+            t_lo = _mm_srli_epi16(_mm_add_epi16(t_lo, _mm_srli_epi16(t_lo, 8)), 8);
+            t_hi = _mm_srli_epi16(_mm_add_epi16(t_hi, _mm_srli_epi16(t_hi, 8)), 8);
+            _mm_storeu_si128(p, _mm_packus_epi16(t_lo, t_hi));
+        }
+#else
+        for (int i = 0; i < LINE_LANES; i++) blend_alpha(dst + i * 4, color, alpha[i]);
+#endif
+    }
+}
+
+void SoftwareRasterizer::set_target(uint8_t* pixels, int width, int height, size_t pitch) {
+    m_pixels = pixels;
+    m_width = std::max(width, 0);
+    m_height = std::max(height, 0);
+    m_pitch = pitch;
+    m_tiles_x = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+    m_tiles_y = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+
+    m_triangles.clear();
+    m_lines.clear();
+    m_bins.resize(static_cast<size_t>(m_tiles_x) * m_tiles_y);
+    for (auto& bin : m_bins) bin.clear();
+}
+
+void SoftwareRasterizer::geometry(const SDL_Vertex* vertices, int vertex_count, const int* indices, int index_count) {
+    if (m_pixels == nullptr) return;
+
+    if (indices == nullptr) {
+        for (int i = 0; i + 2 < vertex_count; i += 3) add_triangle(vertices[i], vertices[i + 1], vertices[i + 2]);
+        return;
+    }
+    for (int i = 0; i + 2 < index_count; i += 3) {
+        int i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+        if (i0 < 0 || i1 < 0 || i2 < 0 || i0 >= vertex_count || i1 >= vertex_count || i2 >= vertex_count) continue;
+        add_triangle(vertices[i0], vertices[i1], vertices[i2]);
+    }
+}
+
+void SoftwareRasterizer::add_triangle(const SDL_Vertex& v0, const SDL_Vertex& v1, const SDL_Vertex& v2) {
+    const SDL_Vertex* v[3] = {&v0, &v1, &v2};
+    for (const SDL_Vertex* vertex : v) {
+        // Also rejects NaN
+        if (!(std::fabs(vertex->position.x) < MAX_COORDINATE && std::fabs(vertex->position.y) < MAX_COORDINATE)) return;
+    }
+
+    int64_t x[3], y[3];
+    for (int k = 0; k < 3; k++) {
+        x[k] = to_fixed(v[k]->position.x);
+        y[k] = to_fixed(v[k]->position.y);
+    }
+
+    // Either winding is accepted (like SDL); make the area positive so "inside" is E >= 0 on every edge
+    int64_t area = (x[2] - x[1]) * (y[0] - y[1]) - (y[2] - y[1]) * (x[0] - x[1]);
+    if (area == 0) return;
+    if (area < 0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(v[1], v[2]);
+        area = -area;
+    }
+
+    Triangle tri;
+    tri.min_x = std::max(static_cast<int>((std::min({x[0], x[1], x[2]}) - SUBPIXEL_HALF) >> SUBPIXEL_BITS), 0);
+    tri.min_y = std::max(static_cast<int>((std::min({y[0], y[1], y[2]}) - SUBPIXEL_HALF) >> SUBPIXEL_BITS), 0);
+    tri.max_x = std::min(static_cast<int>((std::max({x[0], x[1], x[2]}) + SUBPIXEL_HALF) >> SUBPIXEL_BITS) + 1, m_width);
+    tri.max_y = std::min(static_cast<int>((std::max({y[0], y[1], y[2]}) + SUBPIXEL_HALF) >> SUBPIXEL_BITS) + 1, m_height);
+    if (tri.min_x >= tri.max_x || tri.min_y >= tri.max_y) return;
+
+    for (int k = 0; k < 3; k++) {
+        // Edge k runs from vertex k+1 to k+2, opposite vertex k; (a, b) points inside
+        int from = (k + 1) % 3, to = (k + 2) % 3;
+        tri.a[k] = y[from] - y[to];
+        tri.b[k] = x[to] - x[from];
+        tri.c[k] = x[from] * y[to] - y[from] * x[to];
+
+        // Top-left rule: pixels exactly on a right or bottom edge belong to the neighbour
+        bool top_left = tri.a[k] > 0 || (tri.a[k] == 0 && tri.b[k] > 0);
+        if (!top_left) tri.c[k] -= 1;
+    }
+
+    for (int k = 0; k < 3; k++) {
+        const SDL_FColor& color = v[k]->color;
+        tri.color[k][0] = to_byte(color.r);
+        tri.color[k][1] = to_byte(color.g);
+        tri.color[k][2] = to_byte(color.b);
+        tri.color[k][3] = to_byte(color.a);
+    }
+    tri.flat = std::memcmp(tri.color[0], tri.color[1], 4) == 0 && std::memcmp(tri.color[0], tri.color[2], 4) == 0;
+    tri.opaque = tri.flat && tri.color[0][3] == 255;
+    tri.inv_area = 1.0f / static_cast<float>(area);
+
+    uint32_t index = static_cast<uint32_t>(m_triangles.size());
+    m_triangles.push_back(tri);
+
+    // Bin into every tile of the bounding box that the edges do not rule out
+    int tile_x0 = tri.min_x / TILE_SIZE, tile_x1 = (tri.max_x - 1) / TILE_SIZE;
+    int tile_y0 = tri.min_y / TILE_SIZE, tile_y1 = (tri.max_y - 1) / TILE_SIZE;
+    for (int ty = tile_y0; ty <= tile_y1; ty++) {
+        int py0 = std::max(ty * TILE_SIZE, tri.min_y);
+        int py1 = std::min((ty + 1) * TILE_SIZE, tri.max_y) - 1;
+        for (int tx = tile_x0; tx <= tile_x1; tx++) {
+            int px0 = std::max(tx * TILE_SIZE, tri.min_x);
+            int px1 = std::min((tx + 1) * TILE_SIZE, tri.max_x) - 1;
+
+            // Largest value of each edge function over the tile's pixel centers
+            bool outside = false;
+            for (int k = 0; k < 3 && !outside; k++) {
+                int64_t sx = center(tri.a[k] > 0 ? px1 : px0);
+                int64_t sy = center(tri.b[k] > 0 ? py1 : py0);
+                outside = tri.a[k] * sx + tri.b[k] * sy + tri.c[k] < 0;
+            }
+            if (!outside) m_bins[static_cast<size_t>(ty) * m_tiles_x + tx].push_back(index);
+        }
+    }
+}
+
+bool SoftwareRasterizer::thick_line(SDL_FPoint p1, SDL_FPoint p2, float thickness, SDL_FColor color) {
+    if (!m_antialiasing) return false;
+    if (m_pixels == nullptr) return true;
+
+    float dx = p2.x - p1.x;
+    float dy = p2.y - p1.y;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (!(length > 0.0f) || !(thickness > 0.0f) || !(length < MAX_COORDINATE)) return true; // Nothing drawable (or NaN)
+    if (!(std::fabs(p1.x) < MAX_COORDINATE && std::fabs(p1.y) < MAX_COORDINATE)) return true;
+
+    Line line;
+    line.x0 = p1.x;
+    line.y0 = p1.y;
+    line.dx = dx / length;
+    line.dy = dy / length;
+    line.length = length;
+    line.half_width = thickness / 2.0f;
+    line.alpha_scale = std::clamp(color.a, 0.0f, 1.0f) * 255.0f;
+    line.color[0] = to_byte(color.r);
+    line.color[1] = to_byte(color.g);
+    line.color[2] = to_byte(color.b);
+    line.color[3] = 255;
+
+    // Bounds of the rectangle plus the half pixel where coverage fades out
+    float nx = -line.dy * (line.half_width + 1.0f), ny = line.dx * (line.half_width + 1.0f);
+    float ex = line.dx, ey = line.dy;
+    float xs[4] = {p1.x + nx - ex, p1.x - nx - ex, p2.x + nx + ex, p2.x - nx + ex};
+    float ys[4] = {p1.y + ny - ey, p1.y - ny - ey, p2.y + ny + ey, p2.y - ny + ey};
+    line.min_x = std::max(static_cast<int>(std::floor(std::min({xs[0], xs[1], xs[2], xs[3]}))), 0);
+    line.min_y = std::max(static_cast<int>(std::floor(std::min({ys[0], ys[1], ys[2], ys[3]}))), 0);
+    line.max_x = std::min(static_cast<int>(std::ceil(std::max({xs[0], xs[1], xs[2], xs[3]}))) + 1, m_width);
+    line.max_y = std::min(static_cast<int>(std::ceil(std::max({ys[0], ys[1], ys[2], ys[3]}))) + 1, m_height);
+    if (line.min_x >= line.max_x || line.min_y >= line.max_y) return true;
+
+    uint32_t index = static_cast<uint32_t>(m_lines.size()) | LINE_BIT;
+    m_lines.push_back(line);
+
+    // Skip the tiles of the bounding box that are clearly off the line (most of them for diagonals)
+    const float reach = TILE_SIZE * 0.7072f + 1.0f; // Tile center to corner, plus the fade
+    for (int ty = line.min_y / TILE_SIZE; ty <= (line.max_y - 1) / TILE_SIZE; ty++) {
+        for (int tx = line.min_x / TILE_SIZE; tx <= (line.max_x - 1) / TILE_SIZE; tx++) {
+            float cx = (tx + 0.5f) * TILE_SIZE - line.x0;
+            float cy = (ty + 0.5f) * TILE_SIZE - line.y0;
+            float along = cx * line.dx + cy * line.dy;
+            float across = std::fabs(cx * line.dy - cy * line.dx);
+            if (across > line.half_width + reach || along < -reach || along > line.length + reach) continue;
+            m_bins[static_cast<size_t>(ty) * m_tiles_x + tx].push_back(index);
+        }
+    }
+    return true;
+}
+
+void SoftwareRasterizer::flush() {
+    if (m_pixels == nullptr || (m_triangles.empty() && m_lines.empty())) return;
+
+    auto tile = [this](size_t i) { rasterize_tile(i); };
+    if (m_pool != nullptr) {
+        m_pool->parallel_for(m_bins.size(), tile);
+    } else {
+        for (size_t i = 0; i < m_bins.size(); i++) tile(i);
+    }
+
+    m_triangles.clear();
+    m_lines.clear();
+    for (auto& bin : m_bins) bin.clear();
+}
+
+void SoftwareRasterizer::rasterize_tile(size_t tile) {
+    int tile_x = static_cast<int>(tile % m_tiles_x) * TILE_SIZE;
+    int tile_y = static_cast<int>(tile / m_tiles_x) * TILE_SIZE;
+
+    for (uint32_t index : m_bins[tile]) {
+        if (index & LINE_BIT) {
+            rasterize_line(m_lines[index & ~LINE_BIT], tile_x, tile_y);
+        } else {
+            rasterize_triangle(m_triangles[index], tile_x, tile_y);
+        }
+    }
+}
+
+void SoftwareRasterizer::rasterize_triangle(const Triangle& tri, int tile_x, int tile_y) {
+    int x0 = std::max(tri.min_x, tile_x), x1 = std::min(tri.max_x, tile_x + TILE_SIZE);
+    int y0 = std::max(tri.min_y, tile_y), y1 = std::min(tri.max_y, tile_y + TILE_SIZE);
+
+    // Edge values at the first pixel center of the row, stepped by a per pixel and b per row
+    int64_t row[3], step_x[3], step_y[3];
+    for (int k = 0; k < 3; k++) {
+        row[k] = tri.a[k] * center(x0) + tri.b[k] * center(y0) + tri.c[k];
+        step_x[k] = tri.a[k] * SUBPIXEL_ONE;
+        step_y[k] = tri.b[k] * SUBPIXEL_ONE;
+    }
+
+    for (int y = y0; y < y1; y++) {
+        // Each edge bounds the row from one side; solve for the covered span instead of testing every pixel
+        int64_t begin = x0, end = x1;
+        for (int k = 0; k < 3; k++) {
+            if (step_x[k] > 0) {
+                if (row[k] < 0) begin = std::max(begin, x0 + (-row[k] + step_x[k] - 1) / step_x[k]);
+            } else if (step_x[k] < 0) {
+                if (row[k] < 0) end = x0; // Already outside at the left end and moving further out
+                else end = std::min(end, x0 + row[k] / -step_x[k] + 1);
+            } else if (row[k] < 0) {
+                end = x0; // Horizontal edge with the whole row outside
+            }
+        }
+        int span_begin = static_cast<int>(std::min(begin, static_cast<int64_t>(x1)));
+        int span_end = static_cast<int>(end);
+
+        uint8_t* dst = m_pixels + y * m_pitch + static_cast<size_t>(span_begin) * 4;
+        if (tri.opaque) {
+            for (int x = span_begin; x < span_end; x++, dst += 4) std::memcpy(dst, tri.color[0], 4);
+        } else if (tri.flat) {
+            for (int x = span_begin; x < span_end; x++, dst += 4) blend(dst, tri.color[0]);
+        } else {
+            // Barycentric weights are the edge values over the area
+            int64_t offset = span_begin - x0;
+            int64_t e0 = row[0] + step_x[0] * offset, e1 = row[1] + step_x[1] * offset, e2 = row[2] + step_x[2] * offset;
+            for (int x = span_begin; x < span_end; x++, dst += 4, e0 += step_x[0], e1 += step_x[1], e2 += step_x[2]) {
+                float w0 = e0 * tri.inv_area, w1 = e1 * tri.inv_area, w2 = e2 * tri.inv_area;
+                uint8_t color[4];
+                for (int c = 0; c < 4; c++) {
+                    float value = w0 * tri.color[0][c] + w1 * tri.color[1][c] + w2 * tri.color[2][c];
+                    color[c] = static_cast<uint8_t>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+                }
+                if (color[3] == 255) {
+                    std::memcpy(dst, color, 4);
+                } else {
+                    blend(dst, color);
+                }
+            }
+        }
+
+        row[0] += step_y[0];
+        row[1] += step_y[1];
+        row[2] += step_y[2];
+    }
+}
+
+void SoftwareRasterizer::rasterize_line(const Line& line, int tile_x, int tile_y) {
+    int x0 = std::max(line.min_x, tile_x), x1 = std::min(line.max_x, tile_x + TILE_SIZE);
+    int y0 = std::max(line.min_y, tile_y), y1 = std::min(line.max_y, tile_y + TILE_SIZE);
+
+    LineRow r;
+    r.dx = line.dx;
+    r.dy = line.dy;
+    r.half_width = line.half_width;
+    r.length = line.length;
+    r.width_cap = std::min(2.0f * line.half_width, 1.0f);
+    r.length_cap = std::min(line.length, 1.0f);
+    r.alpha_scale = line.alpha_scale;
+
+    // Pixel x maps to rx = x + 0.5 - x0 relative to the line start
+    const float rx_offset = 0.5f - line.x0;
+    int32_t alpha[LINE_LANES];
+
+    for (int y = y0; y < y1; y++) {
+        float ry = y + 0.5f - line.y0;
+        r.along_base = ry * line.dy;
+        r.across_base = ry * line.dx;
+
+        // Both distances are linear in x: intersect |across| < half + 0.5 and -0.5 < along < length + 0.5
+        float lo = static_cast<float>(x0), hi = static_cast<float>(x1);
+        auto limit = [&](float slope, float base, float min, float max) {
+            // slope * rx + base in (min, max)
+            if (std::fabs(slope) < 1e-6f) {
+                if (base <= min || base >= max) hi = lo;
+                return;
+            }
+            float a = (min - base) / slope - rx_offset, b = (max - base) / slope - rx_offset;
+            if (a > b) std::swap(a, b);
+            lo = std::max(lo, std::floor(a));
+            hi = std::min(hi, std::ceil(b) + 1.0f);
+        };
+        limit(line.dy, -r.across_base, -(line.half_width + 0.5f), line.half_width + 0.5f);
+        limit(line.dx, r.along_base, -0.5f, line.length + 0.5f);
+        if (hi <= lo) continue;
+
+        int begin = static_cast<int>(lo), end = static_cast<int>(hi);
+        uint8_t* dst = m_pixels + y * m_pitch + static_cast<size_t>(begin) * 4;
+        int x = begin;
+        // Lanes past the span have zero coverage and leave their pixel as it was, so whole groups are
+        // fine while they stay inside this tile; only a group that would cross into the next tile is cut short
+        for (; x < end && x + LINE_LANES <= x1; x += LINE_LANES, dst += LINE_LANES * 4) {
+            line_alpha8(r, x + rx_offset, alpha);
+            blend_alpha8(dst, line.color, alpha);
+        }
+        if (x < end) {
+            line_alpha8(r, x + rx_offset, alpha);
+            for (int i = 0; x < end; x++, i++, dst += 4) blend_alpha(dst, line.color, alpha[i]);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include "strip_chart.h"
+#include <algorithm>
+
+namespace {
+    // Roll, pitch, yaw (same colors as the replay timeline)
+    constexpr SDL_FColor CHANNEL_COLORS[session_format::CHANNEL_COUNT] = {
+        {1.0f, 0.35f, 0.35f, 1.0f}, {0.27f, 1.0f, 0.27f, 1.0f}, {0.35f, 0.63f, 1.0f, 1.0f}};
+
+    constexpr double MIN_LANE_SPAN = 5.0; // Degrees; keeps a steady hover from filling the lane with noise
+}
+
+StripChart::StripChart(double window_seconds, size_t capacity)
+    : m_window_us(static_cast<int64_t>(std::max(window_seconds, 0.1) * 1e6)),
+      m_ring(std::max<size_t>(capacity, 2)),
+      m_incoming(TelemetryMailbox::HISTORY_CAPACITY),
+      m_points(m_ring.size()) {}
+
+void StripChart::push(const TelemetrySample& sample) {
+    // Time going backwards means a replay seek: start the trace over
+    if (m_count > 0 && sample.timestamp_us < at(m_count - 1).timestamp_us) m_count = 0;
+
+    m_ring[m_head] = sample;
+    m_head = (m_head + 1) % m_ring.size();
+    m_count = std::min(m_count + 1, m_ring.size());
+}
+
+void StripChart::update(const TelemetryMailbox& mailbox) {
+    size_t n = mailbox.read_history(m_cursor, m_incoming.data(), m_incoming.size());
+    for (size_t i = 0; i < n; i++) push(m_incoming[i]);
+}
+
+void StripChart::draw(RenderEngine& engine, SDL_Renderer* renderer, HudText& hud, const SDL_FRect& area) {
+    SDL_SetRenderDrawColor(renderer, 20, 20, 20, 255);
+    SDL_RenderFillRect(renderer, &area);
+    if (m_count == 0 || area.w < 2.0f) return;
+
+    // Visible part: samples newer than (newest - window)
+    int64_t newest = at(m_count - 1).timestamp_us;
+    int64_t t0 = newest - m_window_us;
+    size_t lo = 0, hi = m_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (at(mid).timestamp_us < t0) lo = mid + 1; else hi = mid;
+    }
+    size_t first = lo;
+    size_t visible = m_count - first;
+
+    size_t columns = static_cast<size_t>(area.w);
+    float x_scale = area.w / static_cast<float>(m_window_us);
+    float lane_height = area.h / session_format::CHANNEL_COUNT;
+
+    for (int c = 0; c < session_format::CHANNEL_COUNT; c++) {
+        auto value = [&](size_t i) { return at(i).attitude.*session_format::CHANNEL_MEMBERS[c]; };
+
+        double min = value(first), max = min;
+        for (size_t i = first + 1; i < m_count; i++) {
+            min = std::min(min, value(i));
+            max = std::max(max, value(i));
+        }
+        double mid = (min + max) / 2.0;
+        double span = std::max(max - min, MIN_LANE_SPAN);
+        float lane_top = area.y + lane_height * c;
+        float y_scale = (lane_height - 4.0f) / static_cast<float>(span);
+        auto y_of = [&](double v) { return lane_top + lane_height / 2.0f - static_cast<float>(v - mid) * y_scale; };
+
+        size_t n = 0;
+        if (visible <= 2 * columns) {
+            for (size_t i = first; i < m_count; i++) {
+                m_points[n++] = {area.x + (at(i).timestamp_us - t0) * x_scale, y_of(value(i))};
+            }
+        } else {
+            // More samples than pixels: keep each column's min and max, in the order they happened
+            size_t column = SIZE_MAX, i_min = 0, i_max = 0;
+            auto emit = [&]() {
+                if (column == SIZE_MAX) return;
+                float x = area.x + column + 0.5f;
+                size_t a = std::min(i_min, i_max), b = std::max(i_min, i_max);
+                m_points[n++] = {x, y_of(value(a))};
+                if (b != a) m_points[n++] = {x, y_of(value(b))};
+            };
+            for (size_t i = first; i < m_count; i++) {
+                size_t col = std::min(static_cast<size_t>((at(i).timestamp_us - t0) * x_scale), columns - 1);
+                if (col != column) {
+                    emit();
+                    column = col;
+                    i_min = i_max = i;
+                } else {
+                    if (value(i) < value(i_min)) i_min = i;
+                    if (value(i) > value(i_max)) i_max = i;
+                }
+            }
+            emit();
+        }
+
+        engine.draw_polyline(m_points.data(), n, 1.5f, CHANNEL_COLORS[c]);
+
+        // Current value next to the lane name: this is where operators read the numbers now
+        hud.text(area.x + 4.0f, lane_top + 4.0f, session_format::CHANNEL_NAMES[c], CHANNEL_COLORS[c]);
+        hud.text(area.x + 4.0f + 6 * HudText::GLYPH_SIZE, lane_top + 4.0f, m_values[c].get(value(m_count - 1)), CHANNEL_COLORS[c]);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "hud_text.h"
+#include "render_engine.h"
+#include "session_format.h"
+#include "telemetry_mailbox.h"
+
+/**
+ * @brief Live strip chart of the last few seconds of roll, pitch and yaw.
+ *
+ * Samples are pulled from the mailbox history into a fixed-size ring once per
+ * frame, so every sample the producer published shows up, not just one per
+ * frame. Each channel is drawn in its own auto-scaled lane as a single
+ * RenderEngine::draw_polyline call. When there are more samples than pixels
+ * the trace is reduced to the min and max of every pixel column first, which
+ * keeps the vertex count bounded by the chart width.
+ *
+ * Nothing is allocated per frame: all buffers are sized in the constructor.
+ */
+class StripChart {
+public:
+    // capacity bounds the samples kept; at high rates it caps the visible window instead of growing
+    explicit StripChart(double window_seconds = 10.0, size_t capacity = 16384);
+
+    // Pulls everything published since the last call
+    void update(const TelemetryMailbox& mailbox);
+
+    // Lane labels and current values are queued on hud, drawn with the rest of the frame's text
+    void draw(RenderEngine& engine, SDL_Renderer* renderer, HudText& hud, const SDL_FRect& area);
+
+    void clear() { m_count = 0; }
+
+private:
+    // Oldest-first access into the ring
+    const TelemetrySample& at(size_t i) const { return m_ring[(m_head + m_ring.size() - m_count + i) % m_ring.size()]; }
+
+    void push(const TelemetrySample& sample);
+
+    int64_t m_window_us;
+
+    std::vector<TelemetrySample> m_ring;
+    size_t m_head = 0;  // Next slot to write
+    size_t m_count = 0;
+
+    uint64_t m_cursor = 0;                    // Mailbox history position
+    std::vector<TelemetrySample> m_incoming;  // Scratch for read_history
+    std::vector<RenderEngine::Point_2D> m_points;
+
+    CachedNumber m_values[session_format::CHANNEL_COUNT] = {
+        {"%8.2f", 0.01}, {"%8.2f", 0.01}, {"%8.2f", 0.01}};
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Data structure to hold standard drone attitude telemetry.
+ */
+struct DroneTelemetry {
+    double roll;
+    double pitch;
+    double yaw;
+};
+
+/**
+ * @brief One timestamped attitude sample.
+ * Kept fixed-size and trivially copyable so it can be moved through
+ * shared memory, ring buffers and log files with a plain memcpy.
+ */
+struct TelemetrySample {
+    int64_t timestamp_us; // Monotonic capture time in microseconds
+    DroneTelemetry attitude;
+};
+
+static_assert(std::is_trivially_copyable_v<TelemetrySample>, "TelemetrySample must stay memcpy-able");
+
+// Monotonic clock shared by every telemetry producer.
+// steady_clock is system-wide, so timestamps from a child process line up with ours.
+inline int64_t telemetry_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
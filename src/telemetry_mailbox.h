@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "telemetry.h"
+
+/**
+ * @brief Latest-value mailbox between a telemetry producer thread and the render loop.
+ *
+ * The producer overwrites the slot with every new sample; the render loop
+ * reads whatever is newest once per frame. A sequence lock keeps the read
+ * wait-free for the writer and lock-free for the reader: the reader simply
+ * retries if it raced a write.
+ *
+ * Every published sample is also kept in a short history ring, so a reader
+ * that runs slower than the producer (the render loop at 120 FPS against a
+ * 1 kHz feed) can still see all of them with read_history().
+ */
+class TelemetryMailbox {
+public:
+    // Samples kept for read_history(): several seconds at kHz rates
+    static constexpr size_t HISTORY_CAPACITY = 8192;
+
+    // Producer side
+    void publish(const TelemetrySample& sample) {
+        uint64_t words[WORDS];
+        std::memcpy(words, &sample, sizeof(sample));
+
+        // History slot first: it becomes visible with the m_published increment below
+        uint64_t index = m_published.load(std::memory_order_relaxed);
+        std::atomic<uint64_t>* slot = m_history[index % HISTORY_CAPACITY];
+        for (int i = 0; i < WORDS; i++) slot[i].store(words[i], std::memory_order_relaxed);
+
+        uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed); // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < WORDS; i++) m_words[i].store(words[i], std::memory_order_relaxed);
+
+        m_seq.store(seq + 2, std::memory_order_release); // Even: stable again
+        m_published.fetch_add(1, std::memory_order_release);
+    }
+
+    // Consumer side. Returns false while nothing has been published yet.
+    bool read(TelemetrySample& out) const {
+        if (m_published.load(std::memory_order_acquire) == 0) return false;
+
+        uint64_t words[WORDS];
+        uint32_t before, after;
+        do {
+            before = m_seq.load(std::memory_order_acquire);
+            for (int i = 0; i < WORDS; i++) words[i] = m_words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_seq.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        std::memcpy(&out, words, sizeof(out));
+        return true;
+    }
+
+    // Copies samples published since cursor (at most max, the newest ones) into out and advances cursor.
+    // Samples that were overwritten before the reader got to them are skipped. Start with cursor = 0.
+    size_t read_history(uint64_t& cursor, TelemetrySample* out, size_t max) const {
+        uint64_t head = m_published.load(std::memory_order_acquire);
+        uint64_t first = cursor;
+        if (head - first > HISTORY_CAPACITY) first = head - HISTORY_CAPACITY;
+        if (head - first > max) first = head - max;
+
+        for (uint64_t index = first; index < head; index++) {
+            uint64_t words[WORDS];
+            const std::atomic<uint64_t>* slot = m_history[index % HISTORY_CAPACITY];
+            for (int i = 0; i < WORDS; i++) words[i] = slot[i].load(std::memory_order_relaxed);
+            std::memcpy(&out[index - first], words, sizeof(TelemetrySample));
+        }
+
+        // The producer may have lapped us while copying: the slot it is writing now
+        // (index == now) and everything older than one ring behind it are suspect
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t now = m_published.load(std::memory_order_relaxed);
+        uint64_t valid_from = (now + 1 > HISTORY_CAPACITY) ? now + 1 - HISTORY_CAPACITY : 0;
+
+        size_t count = static_cast<size_t>(head - first);
+        if (first < valid_from) {
+            size_t torn = static_cast<size_t>(std::min(valid_from, head) - first);
+            std::memmove(out, out + torn, (count - torn) * sizeof(TelemetrySample));
+            count -= torn;
+        }
+
+        cursor = head;
+        return count;
+    }
+
+    // Number of samples published so far (useful for "waiting for telemetry" and rate displays)
+    uint64_t published() const {
+        return m_published.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr int WORDS = sizeof(TelemetrySample) / sizeof(uint64_t);
+    static_assert(sizeof(TelemetrySample) % sizeof(uint64_t) == 0, "Sample must be a whole number of words");
+
+    std::atomic<uint32_t> m_seq{0};
+    std::atomic<uint64_t> m_words[WORDS]; // Value-initialized (zero) since C++20
+    std::atomic<uint64_t> m_published{0};
+
+    // ~256 KB: on the heap, the mailbox itself lives on main()'s stack (1 MB by default on Windows)
+    std::unique_ptr<std::atomic<uint64_t>[][WORDS]> m_history =
+        std::make_unique<std::atomic<uint64_t>[][WORDS]>(HISTORY_CAPACITY);
+};
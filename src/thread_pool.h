@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads for data-parallel loops.
+ *
+ * parallel_for(count, fn) calls fn(i) for every i in [0, count), spread over
+ * the workers and the calling thread, and returns when all calls are done.
+ * Threads are created once and reused, so it is cheap enough to call every frame.
+ * Only one thread may call parallel_for() on a given pool at a time.
+ */
+class ThreadPool {
+public:
+    // 0 = one thread per hardware core (the caller counts as one of them)
+    explicit ThreadPool(unsigned thread_count = 0) {
+        if (thread_count == 0) thread_count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < thread_count; i++) {
+            m_workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Workers plus the calling thread
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+    template <typename Fn>
+    void parallel_for(size_t count, Fn&& fn) {
+        if (count == 0) return;
+        if (count == 1 || m_workers.empty()) {
+            for (size_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+
+        std::function<void(size_t)> job = std::forward<Fn>(fn);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+            m_count = count;
+            m_next = 0;
+            m_active = static_cast<unsigned>(m_workers.size());
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        run_items(job, count);
+
+        // Wait until every worker has left this job before `job` goes out of scope
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&] { return m_active == 0; });
+        m_job = nullptr;
+    }
+
+private:
+    void run_items(const std::function<void(size_t)>& job, size_t count) {
+        for (size_t i = m_next.fetch_add(1); i < count; i = m_next.fetch_add(1)) job(i);
+    }
+
+    void worker_loop() {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(size_t)>* job;
+            size_t count;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+                if (m_stop) return;
+                seen = m_generation;
+                job = m_job;
+                count = m_count;
+            }
+
+            run_items(*job, count);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active == 0) m_done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const std::function<void(size_t)>* m_job = nullptr;
+    size_t m_count = 0;
+    std::atomic<size_t> m_next{0};
+    unsigned m_active = 0;
+    uint64_t m_generation = 0;
+    bool m_stop = false;
+};
@@ -0,0 +1,117 @@
+#include "timeline_view.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Roll, pitch, yaw
+    constexpr SDL_Color CHANNEL_COLORS[MinMaxPyramid::CHANNEL_COUNT] = {
+        {255, 90, 90, 255}, {70, 255, 70, 255}, {90, 160, 255, 255}};
+
+    constexpr int64_t MIN_VIEW_SPAN_US = 10000; // Zooming further only shows repeated leaves
+}
+
+void TimelineView::set_session(int64_t start_us, int64_t end_us) {
+    m_session_begin = m_view_begin = start_us;
+    m_session_end = m_view_end = std::max(end_us, start_us + 1);
+}
+
+int64_t TimelineView::time_at(float x) const {
+    float t = std::clamp((x - m_area.x) / std::max(m_area.w, 1.0f), 0.0f, 1.0f);
+    return m_view_begin + static_cast<int64_t>(t * (m_view_end - m_view_begin));
+}
+
+void TimelineView::draw(SDL_Renderer* renderer, HudText& hud, const MinMaxPyramid& pyramid, const SDL_FRect& area, int64_t cursor_us) {
+    m_area = area;
+    size_t columns = static_cast<size_t>(std::max(area.w, 0.0f));
+    if (columns == 0 || area.h <= 0.0f) return;
+
+    m_columns.resize(columns);
+    m_bars.resize(columns);
+
+    SDL_SetRenderDrawColor(renderer, 25, 25, 25, 255);
+    SDL_RenderFillRect(renderer, &area);
+
+    float lane_height = area.h / MinMaxPyramid::CHANNEL_COUNT;
+    for (int c = 0; c < MinMaxPyramid::CHANNEL_COUNT; c++) {
+        // Lanes are scaled to the whole session so zooming does not rescale them
+        MinMaxPyramid::Column range = pyramid.channel_range(c);
+        if (range.empty()) continue;
+        float span = std::max(range.max - range.min, 1e-3f);
+        float lane_bottom = area.y + lane_height * (c + 1);
+
+        pyramid.query(c, m_view_begin, m_view_end, m_columns.data(), columns);
+
+        size_t bars = 0;
+        for (size_t i = 0; i < columns; i++) {
+            const MinMaxPyramid::Column& column = m_columns[i];
+            if (column.empty()) continue;
+
+            float top = lane_bottom - (column.max - range.min) / span * (lane_height - 2.0f) - 1.0f;
+            float bottom = lane_bottom - (column.min - range.min) / span * (lane_height - 2.0f) - 1.0f;
+            m_bars[bars++] = {area.x + static_cast<float>(i), top, 1.0f, std::max(bottom - top, 1.0f)};
+        }
+
+        const SDL_Color& color = CHANNEL_COLORS[c];
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRects(renderer, m_bars.data(), static_cast<int>(bars));
+        hud.text(area.x + 4.0f, lane_bottom - lane_height + 4.0f, session_format::CHANNEL_NAMES[c],
+                 {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, 1.0f});
+    }
+
+    // Playback position
+    if (cursor_us >= m_view_begin && cursor_us <= m_view_end) {
+        float x = area.x + static_cast<float>(cursor_us - m_view_begin) / (m_view_end - m_view_begin) * area.w;
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderLine(renderer, x, area.y, x, area.y + area.h);
+    }
+}
+
+bool TimelineView::handle_event(const SDL_Event& event, int64_t& seek_us) {
+    auto inside = [&](float x, float y) {
+        return x >= m_area.x && x < m_area.x + m_area.w && y >= m_area.y && y < m_area.y + m_area.h;
+    };
+
+    switch (event.type) {
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            if (!inside(event.button.x, event.button.y)) return false;
+            if (event.button.button == SDL_BUTTON_RIGHT) {
+                m_view_begin = m_session_begin;
+                m_view_end = m_session_end;
+                return false;
+            }
+            if (event.button.button != SDL_BUTTON_LEFT) return false;
+            m_dragging = true;
+            seek_us = time_at(event.button.x);
+            return true;
+
+        case SDL_EVENT_MOUSE_MOTION:
+            if (!m_dragging) return false;
+            seek_us = time_at(event.motion.x);
+            return true;
+
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            if (event.button.button == SDL_BUTTON_LEFT) m_dragging = false;
+            return false;
+
+        case SDL_EVENT_MOUSE_WHEEL: {
+            if (!inside(event.wheel.mouse_x, event.wheel.mouse_y) || event.wheel.y == 0.0f) return false;
+
+            // Zoom around the time under the pointer
+            int64_t pivot = time_at(event.wheel.mouse_x);
+            double factor = std::pow(0.8, event.wheel.y);
+            double session_span = static_cast<double>(m_session_end - m_session_begin);
+            double span = std::clamp((m_view_end - m_view_begin) * factor,
+                                     std::min<double>(MIN_VIEW_SPAN_US, session_span), session_span);
+            double t = static_cast<double>(pivot - m_view_begin) / (m_view_end - m_view_begin);
+
+            int64_t begin = pivot - static_cast<int64_t>(t * span);
+            begin = std::clamp(begin, m_session_begin, m_session_end - static_cast<int64_t>(span));
+            m_view_begin = begin;
+            m_view_end = begin + static_cast<int64_t>(span);
+            return false;
+        }
+
+        default:
+            return false;
+    }
+}
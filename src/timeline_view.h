@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <vector>
+#include "hud_text.h"
+#include "minmax_pyramid.h"
+
+/**
+ * @brief Whole-session roll / pitch / yaw timeline for replays, drawn from a MinMaxPyramid.
+ *
+ * Each channel gets a lane. Every pixel column is one vertical bar covering
+ * the min..max of that slice of time, drawn with a single SDL_RenderFillRects
+ * per channel. The cost depends on the window width, not the session length.
+ *
+ * Mouse: click or drag to seek, wheel to zoom around the pointer, right click
+ * to show the whole session again.
+ */
+class TimelineView {
+public:
+    // Resets the visible range to the whole session
+    void set_session(int64_t start_us, int64_t end_us);
+
+    void draw(SDL_Renderer* renderer, HudText& hud, const MinMaxPyramid& pyramid, const SDL_FRect& area, int64_t cursor_us);
+
+    // Returns true and sets seek_us when the event asks playback to jump
+    bool handle_event(const SDL_Event& event, int64_t& seek_us);
+
+private:
+    int64_t time_at(float x) const;
+
+    int64_t m_session_begin = 0;
+    int64_t m_session_end = 0;
+    int64_t m_view_begin = 0;
+    int64_t m_view_end = 0;
+
+    SDL_FRect m_area = {}; // Where the last draw() went, for hit testing
+    bool m_dragging = false;
+
+    // Reused every frame, only resized when the window width changes
+    std::vector<MinMaxPyramid::Column> m_columns;
+    std::vector<SDL_FRect> m_bars;
+};
@@ -0,0 +1,267 @@
+#include "video_writer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include "logger.h"
+
+namespace {
+    constexpr int Y4M_BAND_ROWS = 32; // Rows per parallel job (even, so chroma rows never straddle two jobs)
+
+    // QOI (https://qoiformat.org): 14 byte header, chunk stream, 8 byte end marker
+    constexpr uint8_t QOI_OP_INDEX = 0x00;
+    constexpr uint8_t QOI_OP_DIFF = 0x40;
+    constexpr uint8_t QOI_OP_LUMA = 0x80;
+    constexpr uint8_t QOI_OP_RUN = 0xc0;
+    constexpr uint8_t QOI_OP_RGB = 0xfe;
+    constexpr uint8_t QOI_OP_RGBA = 0xff;
+    constexpr uint8_t QOI_END[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+    uint8_t clamp_byte(int v) { return static_cast<uint8_t>(std::clamp(v, 0, 255)); }
+
+    // Full-range BT.601 in 8.8 fixed point (what "C420jpeg" means)
+    uint8_t luma(int r, int g, int b) { return static_cast<uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8); }
+    uint8_t chroma_b(int r, int g, int b) { return clamp_byte((-43 * r - 85 * g + 128 * b + 32896) >> 8); }
+    uint8_t chroma_r(int r, int g, int b) { return clamp_byte((128 * r - 107 * g - 21 * b + 32896) >> 8); }
+
+    // Rows [row_begin, row_end) of the Y plane and the chroma rows under them
+    void rgba_to_i420_rows(const uint8_t* rgba, size_t pitch, int width, int height, int row_begin, int row_end,
+                           uint8_t* y_plane, uint8_t* u_plane, uint8_t* v_plane) {
+        int chroma_width = (width + 1) / 2;
+
+        for (int y = row_begin; y < row_end; y++) {
+            const uint8_t* src = rgba + y * pitch;
+            uint8_t* dst = y_plane + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++, src += 4) dst[x] = luma(src[0], src[1], src[2]);
+        }
+
+        for (int y = row_begin; y < row_end; y += 2) {
+            // Average each 2x2 block; odd edges reuse the last row / column
+            const uint8_t* row0 = rgba + y * pitch;
+            const uint8_t* row1 = rgba + std::min(y + 1, height - 1) * pitch;
+            size_t out = static_cast<size_t>(y / 2) * chroma_width;
+            for (int cx = 0; cx < chroma_width; cx++) {
+                int x0 = cx * 2 * 4;
+                int x1 = std::min(cx * 2 + 1, width - 1) * 4;
+                int r = (row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2;
+                int g = (row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1] + 2) >> 2;
+                int b = (row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2] + 2) >> 2;
+                u_plane[out + cx] = chroma_b(r, g, b);
+                v_plane[out + cx] = chroma_r(r, g, b);
+            }
+        }
+    }
+
+    size_t y4m_frame_bytes(int width, int height) {
+        return static_cast<size_t>(width) * height + 2 * static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+    }
+
+    size_t qoi_max_bytes(int width, int height) {
+        // Worst case every pixel is a 5 byte QOI_OP_RGBA
+        return 14 + static_cast<size_t>(width) * height * 5 + sizeof(QOI_END);
+    }
+
+    void encode_y4m(const uint8_t* rgba, size_t pitch, int width, int height, std::vector<uint8_t>& out, ThreadPool* pool) {
+        size_t luma_size = static_cast<size_t>(width) * height;
+        size_t chroma_size = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+        out.resize(y4m_frame_bytes(width, height));
+
+        uint8_t* y_plane = out.data();
+        uint8_t* u_plane = y_plane + luma_size;
+        uint8_t* v_plane = u_plane + chroma_size;
+
+        size_t bands = (height + Y4M_BAND_ROWS - 1) / Y4M_BAND_ROWS;
+        auto band = [&](size_t i) {
+            int begin = static_cast<int>(i) * Y4M_BAND_ROWS;
+            rgba_to_i420_rows(rgba, pitch, width, height, begin, std::min(begin + Y4M_BAND_ROWS, height),
+                              y_plane, u_plane, v_plane);
+        };
+        if (pool != nullptr) {
+            pool->parallel_for(bands, band);
+        } else {
+            for (size_t i = 0; i < bands; i++) band(i);
+        }
+    }
+
+    void put_u32_be(uint8_t*& p, uint32_t v) {
+        *p++ = static_cast<uint8_t>(v >> 24);
+        *p++ = static_cast<uint8_t>(v >> 16);
+        *p++ = static_cast<uint8_t>(v >> 8);
+        *p++ = static_cast<uint8_t>(v);
+    }
+
+    void encode_qoi(const uint8_t* rgba, size_t pitch, int width, int height, std::vector<uint8_t>& out) {
+        out.resize(qoi_max_bytes(width, height));
+        uint8_t* p = out.data();
+
+        std::memcpy(p, "qoif", 4);
+        p += 4;
+        put_u32_be(p, static_cast<uint32_t>(width));
+        put_u32_be(p, static_cast<uint32_t>(height));
+        *p++ = 4; // RGBA
+        *p++ = 0; // sRGB with linear alpha
+
+        struct Pixel { uint8_t r, g, b, a; };
+        Pixel index[64] = {};
+        Pixel prev = {0, 0, 0, 255};
+        int run = 0;
+
+        for (int y = 0; y < height; y++) {
+            const uint8_t* src = rgba + y * pitch;
+            bool last_row = y == height - 1;
+            for (int x = 0; x < width; x++, src += 4) {
+                Pixel px = {src[0], src[1], src[2], src[3]};
+
+                if (px.r == prev.r && px.g == prev.g && px.b == prev.b && px.a == prev.a) {
+                    run++;
+                    if (run == 62 || (last_row && x == width - 1)) {
+                        *p++ = static_cast<uint8_t>(QOI_OP_RUN | (run - 1));
+                        run = 0;
+                    }
+                    continue;
+                }
+
+                if (run > 0) {
+                    *p++ = static_cast<uint8_t>(QOI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+
+                int slot = (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+                const Pixel& cached = index[slot];
+                if (cached.r == px.r && cached.g == px.g && cached.b == px.b && cached.a == px.a) {
+                    *p++ = static_cast<uint8_t>(QOI_OP_INDEX | slot);
+                } else {
+                    index[slot] = px;
+                    if (px.a == prev.a) {
+                        // Differences wrap around like the reference decoder's uint8 arithmetic
+                        int dr = static_cast<int8_t>(px.r - prev.r);
+                        int dg = static_cast<int8_t>(px.g - prev.g);
+                        int db = static_cast<int8_t>(px.b - prev.b);
+                        int dr_dg = dr - dg;
+                        int db_dg = db - dg;
+
+                        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                            *p++ = static_cast<uint8_t>(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                        } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+                            *p++ = static_cast<uint8_t>(QOI_OP_LUMA | (dg + 32));
+                            *p++ = static_cast<uint8_t>((dr_dg + 8) << 4 | (db_dg + 8));
+                        } else {
+                            *p++ = QOI_OP_RGB;
+                            *p++ = px.r;
+                            *p++ = px.g;
+                            *p++ = px.b;
+                        }
+                    } else {
+                        *p++ = QOI_OP_RGBA;
+                        *p++ = px.r;
+                        *p++ = px.g;
+                        *p++ = px.b;
+                        *p++ = px.a;
+                    }
+                }
+                prev = px;
+            }
+        }
+
+        std::memcpy(p, QOI_END, sizeof(QOI_END));
+        p += sizeof(QOI_END);
+        out.resize(p - out.data());
+    }
+}
+
+VideoWriter::Format VideoWriter::format_for_path(const std::string& path) {
+    std::string lower = path;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower.size() >= 4 && lower.compare(lower.size() - 4, 4, ".y4m") == 0 ? Format::Y4M : Format::QoiSequence;
+}
+
+bool VideoWriter::open(const std::string& path, int width, int height, int fps) {
+    close();
+    if (width <= 0 || height <= 0) return false;
+
+    m_format = format_for_path(path);
+    m_width = width;
+    m_height = height;
+    m_frames = 0;
+
+    if (m_format == Format::Y4M) {
+        m_file = std::fopen(path.c_str(), "wb");
+        if (m_file == nullptr) {
+            LOG_ERROR("[Video] Cannot create %s", path);
+            return false;
+        }
+        // Frames are a few MB each: a large stdio buffer saves a syscall per frame
+        std::setvbuf(m_file, nullptr, _IOFBF, 1 << 20);
+        std::fprintf(m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, std::max(fps, 1));
+    } else {
+        // Drop a ".qoi" extension, the frame number goes in front of it
+        m_stem = path;
+        size_t dot = m_stem.find_last_of('.');
+        size_t slash = m_stem.find_last_of("/\\");
+        if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) m_stem.resize(dot);
+    }
+
+    m_open = true;
+    return true;
+}
+
+bool VideoWriter::close() {
+    bool ok = true;
+    if (m_file != nullptr) {
+        // stdio still holds up to a buffer of frames: this is where a full disk shows up
+        if (std::fclose(m_file) != 0) {
+            LOG_ERROR("[Video] Write failed while closing after %llu frames", static_cast<unsigned long long>(m_frames));
+            ok = false;
+        }
+        m_file = nullptr;
+    }
+    m_open = false;
+    return ok;
+}
+
+void VideoWriter::encode_frame(Format format, const uint8_t* rgba, size_t pitch, int width, int height,
+                               std::vector<uint8_t>& out, ThreadPool* pool) {
+    if (format == Format::Y4M) {
+        encode_y4m(rgba, pitch, width, height, out, pool);
+    } else {
+        encode_qoi(rgba, pitch, width, height, out);
+    }
+}
+
+size_t VideoWriter::max_encoded_bytes(Format format, int width, int height) {
+    return format == Format::Y4M ? y4m_frame_bytes(width, height) : qoi_max_bytes(width, height);
+}
+
+bool VideoWriter::write_encoded(const std::vector<uint8_t>& payload) {
+    if (!m_open) return false;
+
+    if (m_format == Format::Y4M) {
+        static const char FRAME_TAG[] = "FRAME\n";
+        if (std::fwrite(FRAME_TAG, 1, sizeof(FRAME_TAG) - 1, m_file) != sizeof(FRAME_TAG) - 1 ||
+            std::fwrite(payload.data(), 1, payload.size(), m_file) != payload.size()) {
+            LOG_ERROR("[Video] Write failed after %llu frames", static_cast<unsigned long long>(m_frames));
+            close();
+            return false;
+        }
+    } else {
+        char name[32];
+        std::snprintf(name, sizeof(name), "_%06llu.qoi", static_cast<unsigned long long>(m_frames));
+        std::string path = m_stem + name;
+        FILE* file = std::fopen(path.c_str(), "wb");
+        bool ok = file != nullptr && std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+        if (file != nullptr && std::fclose(file) != 0) ok = false;
+        if (!ok) {
+            LOG_ERROR("[Video] Cannot write %s", path);
+            close();
+            return false;
+        }
+    }
+
+    m_frames++;
+    return true;
+}
+
+bool VideoWriter::write_frame(const uint8_t* rgba, size_t pitch, ThreadPool* pool) {
+    if (!m_open) return false;
+    encode_frame(m_format, rgba, pitch, m_width, m_height, m_encode_buffer, pool);
+    return write_encoded(m_encode_buffer);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "thread_pool.h"
+
+/**
+ * @brief Writes rendered frames to a Y4M stream or a numbered QOI image sequence.
+ *
+ * Frames come in as RGBA32 (bytes R, G, B, A). Y4M stores them as 4:2:0
+ * full-range YCbCr ("C420jpeg"), which ffmpeg and most players read directly;
+ * QOI keeps them lossless, one file per frame.
+ *
+ * Encoding is split from writing: encode_frame() is a pure function that any
+ * thread can call, write_encoded() appends an already encoded frame in order.
+ * The offline renderer encodes on its workers and only writes on one thread.
+ */
+class VideoWriter {
+public:
+    enum class Format {
+        Y4M,         // Single uncompressed YUV file
+        QoiSequence  // <stem>_000000.qoi, <stem>_000001.qoi, ...
+    };
+
+    // ".y4m" selects Y4M, anything else a QOI sequence named after the path without its extension
+    static Format format_for_path(const std::string& path);
+
+    VideoWriter() = default;
+    ~VideoWriter() { close(); }
+
+    VideoWriter(const VideoWriter&) = delete;
+    VideoWriter& operator=(const VideoWriter&) = delete;
+
+    bool open(const std::string& path, int width, int height, int fps);
+
+    // False if the last buffered frames could not be written (full disk): the video is incomplete
+    bool close();
+
+    bool is_open() const { return m_open; }
+    Format format() const { return m_format; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    uint64_t frames_written() const { return m_frames; }
+
+    // Encodes one width x height RGBA32 frame into out (replaced). The pool, if given,
+    // splits the Y4M color conversion across its threads.
+    static void encode_frame(Format format, const uint8_t* rgba, size_t pitch, int width, int height,
+                             std::vector<uint8_t>& out, ThreadPool* pool = nullptr);
+
+    // Largest payload encode_frame() can produce for a frame of this size. Y4M frames are always
+    // exactly this big; QOI frames are usually far smaller.
+    static size_t max_encoded_bytes(Format format, int width, int height);
+
+    // Appends a frame produced by encode_frame() with this writer's format and size
+    bool write_encoded(const std::vector<uint8_t>& payload);
+
+    // encode_frame() + write_encoded() with a reused buffer
+    bool write_frame(const uint8_t* rgba, size_t pitch, ThreadPool* pool = nullptr);
+
+private:
+    Format m_format = Format::Y4M;
+    bool m_open = false;
+    int m_width = 0;
+    int m_height = 0;
+    uint64_t m_frames = 0;
+
+    FILE* m_file = nullptr;  // Y4M
+    std::string m_stem;      // QOI sequence
+    std::vector<uint8_t> m_encode_buffer;
+};